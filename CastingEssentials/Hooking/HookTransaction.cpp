@@ -0,0 +1,143 @@
+#include "HookTransaction.h"
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace Hooking;
+
+static uintptr_t GetPageSize()
+{
+    static const uintptr_t s_PageSize = []
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return uintptr_t(info.dwPageSize);
+    }();
+
+    return s_PageSize;
+}
+
+thread_local HookTransaction* HookTransaction::s_Current = nullptr;
+bool HookTransaction::s_ReportCommits = false;
+
+HookTransaction::HookTransaction(const char* name)
+    : m_Name(name), m_Outer(s_Current), m_StartTime(Clock::now())
+{
+    if (!m_Outer)
+        s_Current = this;
+}
+
+HookTransaction::~HookTransaction()
+{
+    if (m_Outer)
+        return;
+
+    Commit();
+    s_Current = nullptr;
+}
+
+bool HookTransaction::WritePointer(void** address, void* value, std::function<void()>&& onFailed)
+{
+    if (auto current = s_Current)
+    {
+        current->m_Writes.push_back({address, value, std::move(onFailed)});
+        return true;
+    }
+
+    DWORD old;
+    if (!VirtualProtect(address, sizeof(void*), PAGE_READWRITE, &old))
+        return false;
+
+    *address = value;
+
+    if (!VirtualProtect(address, sizeof(void*), old, &old))
+        throw std::runtime_error("Failed to re-protect memory!");
+
+    return true;
+}
+
+void* HookTransaction::ReadPointer(void* const* address)
+{
+    if (auto current = s_Current)
+    {
+        const auto& writes = current->m_Writes;
+        const auto found = std::find_if(writes.rbegin(), writes.rend(),
+                                        [address](const PendingWrite& write) { return write.m_Address == address; });
+        if (found != writes.rend())
+            return found->m_Value;
+    }
+
+    return *address;
+}
+
+void HookTransaction::CountDetour()
+{
+    if (auto current = s_Current)
+        current->m_Detours++;
+}
+
+void HookTransaction::Commit()
+{
+    if (m_Outer)
+        return;
+
+    const auto commitStart = Clock::now();
+
+    // Failure callbacks get to run without the writes changing underneath them
+    auto writes = std::move(m_Writes);
+    m_Writes.clear();
+
+    const auto pageSize = GetPageSize();
+    const auto pageOf = [pageSize](const PendingWrite& write) { return uintptr_t(write.m_Address) & ~(pageSize - 1); };
+
+    // Stable, so repeated writes to the same slot still land in the order they were made
+    std::stable_sort(writes.begin(), writes.end(),
+                     [&](const PendingWrite& a, const PendingWrite& b) { return pageOf(a) < pageOf(b); });
+
+    size_t pages = 0;
+    for (auto first = writes.begin(); first != writes.end();)
+    {
+        const auto page = pageOf(*first);
+        const auto last = std::find_if(first, writes.end(), [&](const PendingWrite& w) { return pageOf(w) != page; });
+        pages++;
+
+        DWORD old;
+        if (VirtualProtect((void*)page, pageSize, PAGE_READWRITE, &old))
+        {
+            for (auto write = first; write != last; ++write)
+                *write->m_Address = write->m_Value;
+
+            if (!VirtualProtect((void*)page, pageSize, old, &old))
+                PluginWarning("Hook transaction \"%s\" failed to re-protect memory at %p\n", m_Name, (void*)page);
+        }
+        else
+        {
+            PluginWarning("Hook transaction \"%s\" was unable to write %zu hook(s) at %p\n", m_Name,
+                          size_t(last - first), (void*)page);
+
+            // Every write to a slot is on the same page, so going backwards undoes them newest first
+            for (auto write = last; write != first;)
+            {
+                if ((--write)->m_OnFailed)
+                    write->m_OnFailed();
+            }
+        }
+
+        first = last;
+    }
+
+    if (s_ReportCommits && (!writes.empty() || m_Detours))
+    {
+        const auto end = Clock::now();
+        PluginMsg("Hook transaction \"%s\": %zu vtable write(s) across %zu page(s) and %zu detour(s). Committed in "
+                  "%.3f ms, %.2f ms total.\n",
+                  m_Name, writes.size(), pages, m_Detours,
+                  std::chrono::duration<float, std::milli>(end - commitStart).count(),
+                  std::chrono::duration<float, std::milli>(end - m_StartTime).count());
+    }
+
+    m_Detours = 0;
+    m_StartTime = Clock::now();
+}
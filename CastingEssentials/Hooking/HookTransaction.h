@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace Hooking
+{
+// Batches the memory writes made while hooks are installed and removed.
+//
+// Outside of a transaction every vtable slot write unprotects and reprotects its page on its own.
+// While one is open on the current thread the writes are queued instead, and Commit() applies them
+// a page at a time under a single protection change. Transactions nest; inner ones simply join the
+// outermost, which commits when it goes out of scope. Queued hooks don't take effect until then,
+// but ReadPointer() already sees them, so a hook that swaps a slot written earlier in the same
+// transaction still gets the right original function. Writes that fail to commit are reported
+// back to whoever queued them.
+//
+// Detours are rewritten by PolyHook one prologue at a time, so they're only counted and timed.
+class HookTransaction final
+{
+public:
+    explicit HookTransaction(const char* name);
+    ~HookTransaction();
+
+    HookTransaction(const HookTransaction& other) = delete;
+    HookTransaction& operator=(const HookTransaction& other) = delete;
+
+    // Writes a pointer into protected memory, now or when the current transaction commits. If a
+    // queued write can't be applied, onFailed is called during the commit. Failures are reported
+    // newest first, so undoing each one in turn ends up back at the state before the transaction.
+    static bool WritePointer(void** address, void* value, std::function<void()>&& onFailed = nullptr);
+
+    // The pointer at an address, including any write to it that's still queued
+    static void* ReadPointer(void* const* address);
+
+    // Lets the current transaction include a detour in its report
+    static void CountDetour();
+
+    // Prints what each transaction wrote and how long it took when it commits
+    static void SetReportCommits(bool report) { s_ReportCommits = report; }
+
+    void Commit();
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    static thread_local HookTransaction* s_Current;
+    static bool s_ReportCommits;
+
+    struct PendingWrite
+    {
+        void** m_Address;
+        void* m_Value;
+        std::function<void()> m_OnFailed;
+    };
+    std::vector<PendingWrite> m_Writes;
+
+    const char* m_Name;
+    HookTransaction* m_Outer;
+    Clock::time_point m_StartTime;
+    size_t m_Detours = 0;
+};
+}
@@ -1,16 +1,20 @@
 #include "IBaseHook.h"
+#include "HookTransaction.h"
 
 #include <PolyHook.hpp>
 
 #include <Windows.h>
 
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 
 using namespace Hooking;
 
 // A VFuncSwapHook replaces the function pointer in the vtable for a given class. This means
 // all instances of the class will take the detour.
-class VFuncSwapHook final : public IBaseHook
+class VFuncSwapHook final : public IBaseHook, public std::enable_shared_from_this<VFuncSwapHook>
 {
 public:
     VFuncSwapHook() = delete;
@@ -23,6 +27,9 @@ public:
     void* GetOriginalFunction() const override { return m_OriginalFunction; }
 
 private:
+    // Puts this hook back the way it was if a queued vtable write doesn't go through
+    std::function<void()> RevertOnFailure(bool wasHooked, void* original);
+
     void* m_Instance;
     void* m_DetourFunc;
     int m_VTableIndex;
@@ -60,15 +67,13 @@ bool VFuncSwapHook::Hook()
     void** vtable = (*(void***)m_Instance);
     void** vfunc = &vtable[m_VTableIndex];
 
-    DWORD old;
-    if (!VirtualProtect(vfunc, sizeof(void*), PAGE_READWRITE, &old))
+    // Earlier writes to this slot might still be queued in the current transaction
+    void* const original = HookTransaction::ReadPointer(vfunc);
+    Assert(original != m_DetourFunc);
+    if (!HookTransaction::WritePointer(vfunc, m_DetourFunc, RevertOnFailure(false, nullptr)))
         return false;
 
-    m_OriginalFunction = *vfunc;
-    *vfunc = m_DetourFunc;
-
-    if (!VirtualProtect(vfunc, sizeof(void*), old, &old))
-        throw std::exception("Failed to re-protect memory!");
+    m_OriginalFunction = original;
 
     m_IsHooked = true;
     return true;
@@ -82,20 +87,28 @@ bool VFuncSwapHook::Unhook()
     void** vtable = (*(void***)m_Instance);
     void** vfunc = &vtable[m_VTableIndex];
 
-    DWORD old;
-    if (!VirtualProtect(vfunc, sizeof(void*), PAGE_READWRITE, &old))
+    if (!HookTransaction::WritePointer(vfunc, m_OriginalFunction, RevertOnFailure(true, m_OriginalFunction)))
         return false;
 
-    *vfunc = m_OriginalFunction;
     m_OriginalFunction = nullptr;
 
-    if (!VirtualProtect(vfunc, sizeof(void*), old, &old))
-        throw std::exception("Failed to re-protect memory!");
-
     m_IsHooked = false;
     return true;
 }
 
+std::function<void()> VFuncSwapHook::RevertOnFailure(bool wasHooked, void* original)
+{
+    // Transactions can outlive the hook, for example when it's unhooked by its destructor
+    return [weak = weak_from_this(), wasHooked, original]()
+    {
+        if (auto self = weak.lock())
+        {
+            self->m_IsHooked = wasHooked;
+            self->m_OriginalFunction = original;
+        }
+    };
+}
+
 // Detours a function.
 class DetourHook : public IBaseHook
 {
@@ -107,7 +120,11 @@ public:
     }
     virtual ~DetourHook() = default;
 
-    bool Hook() override { return m_Detour->Hook(); }
+    bool Hook() override
+    {
+        HookTransaction::CountDetour();
+        return m_Detour->Hook();
+    }
     bool Unhook() override
     {
         m_Detour->UnHook();
@@ -190,10 +207,12 @@ public:
     bool Unhook() override
     {
         std::lock_guard<decltype(m_VTableSwapHook->m_Mutex)> lock(m_VTableSwapHook->m_Mutex);
+        if (!m_VTableSwapHook->m_Hooked)
+            return true;
 
-        void* const original = m_VTableSwapHook->m_Hook.HookAdditional<void*>(m_VTableIndex, (BYTE*)m_OriginalFn);
-        Assert(original == m_OriginalFn);
-        return (original == m_OriginalFn);
+        void* const replaced = m_VTableSwapHook->m_Hook.HookAdditional<void*>(m_VTableIndex, (BYTE*)m_OriginalFn);
+        Assert(replaced == m_DetourFn);
+        return (replaced == m_DetourFn);
     }
 
     void* GetOriginalFunction() const override { return m_OriginalFn; }
@@ -210,7 +229,7 @@ private:
     {
         std::recursive_mutex m_Mutex;
         PLH::VTableSwap m_Hook;
-        bool m_Hooked;
+        bool m_Hooked = false;
     };
     std::shared_ptr<SharedHook> m_VTableSwapHook;
     static std::recursive_mutex s_HooksTableMutex;
@@ -0,0 +1,163 @@
+#include "CameraSpline.h"
+
+#include <mathlib/mathlib.h>
+
+#include <algorithm>
+#include <cmath>
+
+#undef max
+#undef min
+
+// Curve samples per segment when measuring arc length, and distance table entries per segment
+static constexpr int ARC_LENGTH_SUBSTEPS = 32;
+static constexpr int TABLE_ENTRIES_PER_SEGMENT = 16;
+
+template<typename T>
+void CameraSpline::Cubic<T>::SetHermite(const T& p1, const T& p2, const T& t1, const T& t2)
+{
+    m_C0 = p1;
+    m_C1 = t1;
+    m_C2 = (p2 - p1) * 3 - t1 * 2 - t2;
+    m_C3 = (p1 - p2) * 2 + t1 + t2;
+}
+
+// Tangent at p1 for a centripetal (alpha = 0.5) Catmull-Rom segment p1 -> p2, scaled to a
+// [0, 1] segment parameter. See Yuksel et al., "Parameterization and Applications of Catmull-Rom
+// Curves".
+static Vector CentripetalTangent(const Vector& p0, const Vector& p1, const Vector& p2, float dt0, float dt1,
+                                 float segmentDt)
+{
+    const Vector tangent = (p1 - p0) / dt0 - (p2 - p0) / (dt0 + dt1) + (p2 - p1) / dt1;
+    return tangent * segmentDt;
+}
+
+static float KnotInterval(const Vector& a, const Vector& b) { return std::max(std::sqrt(a.DistTo(b)), 0.01f); }
+
+void CameraSpline::Clear()
+{
+    m_Segments.clear();
+    m_ArcLengthTable.clear();
+    m_Length = 0;
+}
+
+void CameraSpline::Compile(const std::vector<Keyframe>& keyframes)
+{
+    Clear();
+    if (keyframes.empty())
+        return;
+
+    // A single keyframe is a path that doesn't go anywhere
+    const std::vector<Keyframe> single = {keyframes.front(), keyframes.front()};
+    const auto& keys = keyframes.size() > 1 ? keyframes : single;
+
+    // Padded with a mirrored point at each end, so the first and last keyframes get tangents too
+    const int count = (int)keys.size();
+    std::vector<Vector> origins(count + 2);
+    std::vector<Vector> angles(count + 2);
+    std::vector<float> fovs(count + 2);
+
+    for (int i = 0; i < count; i++)
+    {
+        const auto& key = keys[i];
+        origins[i + 1] = key.m_Origin;
+        fovs[i + 1] = key.m_FOV;
+
+        // Unwrap yaw so we always turn the short way between keyframes
+        Vector& angle = angles[i + 1];
+        angle.Init(key.m_Angles[PITCH], key.m_Angles[YAW], key.m_Angles[ROLL]);
+        if (i > 0)
+            angle.y = angles[i].y + AngleNormalize(angle.y - angles[i].y);
+    }
+
+    origins[0] = origins[1] * 2 - origins[2];
+    angles[0] = angles[1] * 2 - angles[2];
+    fovs[0] = fovs[1] * 2 - fovs[2];
+    origins[count + 1] = origins[count] * 2 - origins[count - 1];
+    angles[count + 1] = angles[count] * 2 - angles[count - 1];
+    fovs[count + 1] = fovs[count] * 2 - fovs[count - 1];
+
+    m_Segments.resize(count - 1);
+    for (int i = 0; i < (int)m_Segments.size(); i++)
+    {
+        auto& segment = m_Segments[i];
+
+        // Segment from keyframe i to i + 1 is points[i + 1] -> points[i + 2]
+        const Vector* p = &origins[i];
+        const float dt0 = KnotInterval(p[0], p[1]);
+        const float dt1 = KnotInterval(p[1], p[2]);
+        const float dt2 = KnotInterval(p[2], p[3]);
+        segment.m_Origin.SetHermite(p[1], p[2], CentripetalTangent(p[0], p[1], p[2], dt0, dt1, dt1),
+                                    CentripetalTangent(p[1], p[2], p[3], dt1, dt2, dt1));
+
+        const Vector* a = &angles[i];
+        segment.m_Angles.SetHermite(a[1], a[2], (a[2] - a[0]) * 0.5f, (a[3] - a[1]) * 0.5f);
+
+        const float* f = &fovs[i];
+        segment.m_FOV.SetHermite(f[1], f[2], (f[2] - f[0]) * 0.5f, (f[3] - f[1]) * 0.5f);
+    }
+
+    // Measure the curve, then resample the measurements at even distances
+    const int sampleCount = (int)m_Segments.size() * ARC_LENGTH_SUBSTEPS + 1;
+    std::vector<float> cumulative(sampleCount);
+    cumulative[0] = 0;
+
+    Vector last = m_Segments[0].m_Origin.Evaluate(0);
+    for (int i = 1; i < sampleCount; i++)
+    {
+        const int segment = std::min((i - 1) / ARC_LENGTH_SUBSTEPS, (int)m_Segments.size() - 1);
+        const float t = float(i - segment * ARC_LENGTH_SUBSTEPS) / ARC_LENGTH_SUBSTEPS;
+
+        const Vector point = m_Segments[segment].m_Origin.Evaluate(t);
+        cumulative[i] = cumulative[i - 1] + point.DistTo(last);
+        last = point;
+    }
+
+    m_Length = cumulative.back();
+
+    const int tableSize = (int)m_Segments.size() * TABLE_ENTRIES_PER_SEGMENT + 1;
+    m_ArcLengthTable.resize(tableSize);
+
+    int sample = 0;
+    for (int i = 0; i < tableSize; i++)
+    {
+        const float distance = m_Length * i / (tableSize - 1);
+        while (sample < sampleCount - 2 && cumulative[sample + 1] < distance)
+            sample++;
+
+        const float span = cumulative[sample + 1] - cumulative[sample];
+        const float blend = span > 0 ? std::clamp((distance - cumulative[sample]) / span, 0.0f, 1.0f) : 0;
+        m_ArcLengthTable[i] = (sample + blend) / ARC_LENGTH_SUBSTEPS;
+    }
+
+    // Stationary paths (a single keyframe, or only rotating in place) have no length to walk, so
+    // fall back to an even split between keyframes
+    if (m_Length <= 0)
+    {
+        for (int i = 0; i < tableSize; i++)
+            m_ArcLengthTable[i] = float(i) / TABLE_ENTRIES_PER_SEGMENT;
+    }
+}
+
+float CameraSpline::GetParameter(float fraction) const
+{
+    const float index = std::clamp(fraction, 0.0f, 1.0f) * (m_ArcLengthTable.size() - 1);
+    const int lower = std::min((int)index, (int)m_ArcLengthTable.size() - 2);
+    return Lerp(index - lower, m_ArcLengthTable[lower], m_ArcLengthTable[lower + 1]);
+}
+
+void CameraSpline::Evaluate(float fraction, Vector& origin, QAngle& angles, float& fov) const
+{
+    Assert(IsValid());
+
+    const float parameter = GetParameter(fraction);
+    const int index = std::clamp((int)parameter, 0, (int)m_Segments.size() - 1);
+    const float t = std::clamp(parameter - index, 0.0f, 1.0f);
+
+    const auto& segment = m_Segments[index];
+    origin = segment.m_Origin.Evaluate(t);
+
+    const Vector angleVec = segment.m_Angles.Evaluate(t);
+    angles.Init(angleVec.x, AngleNormalize(angleVec.y), angleVec.z);
+
+    fov = segment.m_FOV.Evaluate(t);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mathlib/vector.h>
+
+#include <vector>
+
+// A camera move through a list of keyframes, compiled for constant-speed playback.
+//
+// Positions follow a centripetal Catmull-Rom spline (no cusps or self-intersections on uneven
+// keyframe spacing), angles and fov a uniform one. Every segment is stored as cubic polynomial
+// coefficients. Compile() also walks the curve once to build a table that maps evenly spaced
+// distances along it back to spline parameters, so Evaluate() is one table lookup plus one
+// polynomial evaluation regardless of keyframe count.
+class CameraSpline final
+{
+public:
+    struct Keyframe
+    {
+        Vector m_Origin;
+        QAngle m_Angles;
+        float m_FOV;
+    };
+
+    void Compile(const std::vector<Keyframe>& keyframes);
+    void Clear();
+
+    bool IsValid() const { return !m_Segments.empty(); }
+    float GetLength() const { return m_Length; }
+    size_t GetSegmentCount() const { return m_Segments.size(); }
+
+    // fraction is distance along the path, [0, 1]
+    void Evaluate(float fraction, Vector& origin, QAngle& angles, float& fov) const;
+
+private:
+    template<typename T> struct Cubic
+    {
+        T m_C0, m_C1, m_C2, m_C3;
+
+        void SetHermite(const T& p1, const T& p2, const T& t1, const T& t2);
+        T Evaluate(float t) const { return m_C0 + (m_C1 + (m_C2 + m_C3 * t) * t) * t; }
+    };
+
+    struct Segment
+    {
+        Cubic<Vector> m_Origin;
+        Cubic<Vector> m_Angles; // Yaw is unwrapped, so it can go past +-180
+        Cubic<float> m_FOV;
+    };
+
+    float GetParameter(float fraction) const;
+
+    std::vector<Segment> m_Segments;
+    std::vector<float> m_ArcLengthTable; // Spline parameter [0, segment count] at evenly spaced distances
+    float m_Length = 0;
+};
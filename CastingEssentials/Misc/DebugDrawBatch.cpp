@@ -0,0 +1,264 @@
+#include "DebugDrawBatch.h"
+#include "Misc/CRefPtrFix.h"
+#include "Misc/DebugOverlay.h"
+#include "PluginBase/Interfaces.h"
+
+#include <cdll_int.h>
+#include <materialsystem/imaterial.h>
+#include <materialsystem/imaterialsystem.h>
+#include <materialsystem/imesh.h>
+#include <mathlib/mathlib.h>
+#include <view_shared.h>
+#include <vprof.h>
+
+#include <algorithm>
+
+static bool GetViewFrustum(Frustum_t& frustum)
+{
+    CViewSetup view;
+    if (!Interfaces::GetClientDLL()->GetPlayerView(view))
+        return false;
+
+    GeneratePerspectiveFrustum(view.origin, view.angles, view.zNear, view.zFar, view.fov, view.m_flAspectRatio,
+                               frustum);
+    return true;
+}
+
+DebugDrawBatch::DebugDrawBatch(const char* name) : m_Name(name) {}
+DebugDrawBatch::~DebugDrawBatch() = default;
+
+void DebugDrawBatch::Begin()
+{
+    m_Vertices.clear();
+    m_Shapes.clear();
+
+    // Forget the labels nobody drew last time, and start over with the rest
+    for (auto it = m_Labels.begin(); it != m_Labels.end();)
+    {
+        if (!it->second.m_Used)
+        {
+            it = m_Labels.erase(it);
+            continue;
+        }
+
+        it->second.m_Used = false;
+        ++it;
+    }
+}
+
+void DebugDrawBatch::End()
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    if (m_Shapes.empty())
+        m_Renderer.reset();
+    else if (!m_Renderer)
+        m_Renderer.emplace(*this);
+
+    if (m_Labels.empty())
+        return;
+
+    Frustum_t frustum;
+    const bool cull = GetViewFrustum(frustum);
+    for (const auto& [key, label] : m_Labels)
+    {
+        if (!label.m_Used || (cull && R_CullBox(label.m_Position, label.m_Position, frustum)))
+            continue;
+
+        NDebugOverlay::Text(label.m_Position, label.m_Text.c_str(), false, 0);
+    }
+}
+
+DebugDrawBatch::Batch DebugDrawBatch::GetBatch(bool triangles, bool noDepthTest)
+{
+    if (noDepthTest)
+        return triangles ? Batch::TrianglesNoDepth : Batch::LinesNoDepth;
+    else
+        return triangles ? Batch::Triangles : Batch::Lines;
+}
+
+void DebugDrawBatch::AddShape(Batch batch, uint32_t firstVertex)
+{
+    Shape& shape = m_Shapes.emplace_back();
+    shape.m_FirstVertex = firstVertex;
+    shape.m_VertexCount = uint32_t(m_Vertices.size()) - firstVertex;
+    shape.m_Batch = batch;
+
+    shape.m_Mins = shape.m_Maxs = m_Vertices[firstVertex].m_Position;
+    for (size_t i = firstVertex + 1; i < m_Vertices.size(); i++)
+    {
+        VectorMin(shape.m_Mins, m_Vertices[i].m_Position, shape.m_Mins);
+        VectorMax(shape.m_Maxs, m_Vertices[i].m_Position, shape.m_Maxs);
+    }
+}
+
+void DebugDrawBatch::Line(const Vector& start, const Vector& end, const Color& color, bool noDepthTest)
+{
+    const auto first = uint32_t(m_Vertices.size());
+    m_Vertices.push_back({start, color});
+    m_Vertices.push_back({end, color});
+    AddShape(GetBatch(false, noDepthTest), first);
+}
+
+void DebugDrawBatch::Triangle(const Vector& p1, const Vector& p2, const Vector& p3, const Color& color,
+                              bool noDepthTest)
+{
+    const auto first = uint32_t(m_Vertices.size());
+    m_Vertices.push_back({p1, color});
+    m_Vertices.push_back({p2, color});
+    m_Vertices.push_back({p3, color});
+    AddShape(GetBatch(true, noDepthTest), first);
+}
+
+void DebugDrawBatch::Cross3DOriented(const Vector& position, const QAngle& angles, float size, const Color& color,
+                                     bool noDepthTest)
+{
+    Vector forward, right, up;
+    AngleVectors(angles, &forward, &right, &up);
+
+    forward *= size;
+    right *= size;
+    up *= size;
+
+    const auto first = uint32_t(m_Vertices.size());
+    for (const Vector& axis : {right, forward, up})
+    {
+        m_Vertices.push_back({position + axis, color});
+        m_Vertices.push_back({position - axis, color});
+    }
+
+    AddShape(GetBatch(false, noDepthTest), first);
+}
+
+void DebugDrawBatch::Box(const Vector& origin, const Vector& mins, const Vector& maxs, const QAngle& angles,
+                         const Color& color)
+{
+    matrix3x4_t transform;
+    AngleMatrix(angles, origin, transform);
+
+    // Bit 0 picks x, bit 1 picks y and bit 2 picks z from maxs instead of mins
+    Vector corners[8];
+    for (int i = 0; i < 8; i++)
+    {
+        const Vector local((i & 1) ? maxs.x : mins.x, (i & 2) ? maxs.y : mins.y, (i & 4) ? maxs.z : mins.z);
+        VectorTransform(local, transform, corners[i]);
+    }
+
+    if (color.a() > 0)
+    {
+        static constexpr int FACES[6][4] = {
+            {0, 2, 6, 4}, {1, 5, 7, 3}, {0, 4, 5, 1}, {2, 3, 7, 6}, {0, 1, 3, 2}, {4, 6, 7, 5},
+        };
+
+        const auto first = uint32_t(m_Vertices.size());
+        for (const auto& face : FACES)
+        {
+            for (int index : {face[0], face[1], face[2], face[0], face[2], face[3]})
+                m_Vertices.push_back({corners[index], color});
+        }
+
+        AddShape(Batch::Triangles, first);
+    }
+
+    // Every edge joins two corners that differ in exactly one bit
+    const Color edgeColor(color.r(), color.g(), color.b(), 255);
+    const auto first = uint32_t(m_Vertices.size());
+    for (int i = 0; i < 8; i++)
+    {
+        for (int bit = 1; bit < 8; bit <<= 1)
+        {
+            if (i & bit)
+                continue;
+
+            m_Vertices.push_back({corners[i], edgeColor});
+            m_Vertices.push_back({corners[i | bit], edgeColor});
+        }
+    }
+
+    AddShape(Batch::Lines, first);
+}
+
+DebugDrawBatch::Label& DebugDrawBatch::UseLabel(const void* key, const Vector& position)
+{
+    Label& label = m_Labels[key];
+    label.m_Position = position;
+    label.m_Used = true;
+    return label;
+}
+
+void DebugDrawBatch::Text(const void* key, const Vector& position, std::string_view text)
+{
+    Label& label = UseLabel(key, position);
+    if (label.m_HasContent || label.m_Text != text)
+    {
+        label.m_Text.assign(text);
+        label.m_HasContent = false;
+    }
+}
+
+DebugDrawBatch::Renderer::Renderer(DebugDrawBatch& batch) : CAutoGameSystemPerFrame(batch.m_Name), m_Batch(batch) {}
+
+void DebugDrawBatch::Renderer::PostRender()
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    for (auto& visible : m_Visible)
+        visible.clear();
+
+    Frustum_t frustum;
+    const bool cull = GetViewFrustum(frustum);
+    for (const Shape& shape : m_Batch.m_Shapes)
+    {
+        if (cull && R_CullBox(shape.m_Mins, shape.m_Maxs, frustum))
+            continue;
+
+        const auto vertices = m_Batch.m_Vertices.begin() + shape.m_FirstVertex;
+        auto& visible = m_Visible[size_t(shape.m_Batch)];
+        visible.insert(visible.end(), vertices, vertices + shape.m_VertexCount);
+    }
+
+    CMatRenderContextPtr pRenderContext(materials);
+    CRefPtrFix<IMaterial> material(
+        materials->FindMaterial("castingessentials/debugdraw/vertexcolor", TEXTURE_GROUP_OTHER, true));
+    CRefPtrFix<IMaterial> materialNoDepth(
+        materials->FindMaterial("castingessentials/debugdraw/vertexcolor_ignorez", TEXTURE_GROUP_OTHER, true));
+
+    CMeshBuilder meshBuilder;
+    for (size_t i = 0; i < size_t(Batch::Count); i++)
+    {
+        const auto& visible = m_Visible[i];
+        if (visible.empty())
+            continue;
+
+        const auto batch = Batch(i);
+        const bool triangles = batch == Batch::Triangles || batch == Batch::TrianglesNoDepth;
+        const bool noDepthTest = batch == Batch::LinesNoDepth || batch == Batch::TrianglesNoDepth;
+        IMaterial* const batchMaterial = noDepthTest ? materialNoDepth : material;
+
+        // Dynamic meshes have a size limit, so big batches go out in a few draws
+        const int vertsPerPrimitive = triangles ? 3 : 2;
+        const int totalPrimitives = int(visible.size()) / vertsPerPrimitive;
+        const int maxPrimitives =
+            std::max(pRenderContext->GetMaxVerticesToRender(batchMaterial) / vertsPerPrimitive, 1);
+
+        for (int firstPrimitive = 0; firstPrimitive < totalPrimitives; firstPrimitive += maxPrimitives)
+        {
+            const int primitives = std::min(maxPrimitives, totalPrimitives - firstPrimitive);
+
+            IMesh* const mesh = pRenderContext->GetDynamicMesh(true, nullptr, nullptr, batchMaterial);
+            meshBuilder.Begin(mesh, triangles ? MATERIAL_TRIANGLES : MATERIAL_LINES, primitives);
+
+            const auto first = visible.begin() + firstPrimitive * vertsPerPrimitive;
+            for (auto vertex = first; vertex != first + primitives * vertsPerPrimitive; ++vertex)
+            {
+                meshBuilder.Position3fv(vertex->m_Position.Base());
+                meshBuilder.Color4ub(vertex->m_Color.r(), vertex->m_Color.g(), vertex->m_Color.b(),
+                                     vertex->m_Color.a());
+                meshBuilder.AdvanceVertex();
+            }
+
+            meshBuilder.End();
+            mesh->Draw();
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Color.h>
+#include <igamesystem.h>
+#include <mathlib/vector.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Debug drawing that doesn't go through the engine's debug overlay one primitive at a time.
+//
+// Everything added between Begin() and End() is kept until the next Begin(), and drawn every frame
+// after culling it against the view being rendered. The survivors are coalesced into one dynamic
+// mesh per material and primitive type. Labels still go through the debug overlay, but only the
+// visible ones, and their text is only rebuilt when its content changes.
+class DebugDrawBatch final
+{
+public:
+    explicit DebugDrawBatch(const char* name);
+    ~DebugDrawBatch();
+
+    DebugDrawBatch(const DebugDrawBatch& other) = delete;
+    DebugDrawBatch& operator=(const DebugDrawBatch& other) = delete;
+
+    void Begin();
+    void End();
+
+    void Line(const Vector& start, const Vector& end, const Color& color, bool noDepthTest = false);
+    void Triangle(const Vector& p1, const Vector& p2, const Vector& p3, const Color& color, bool noDepthTest = false);
+    void Cross3DOriented(const Vector& position, const QAngle& angles, float size, const Color& color,
+                         bool noDepthTest = false);
+
+    // Faces in color, outlined in the same color at full opacity
+    void Box(const Vector& origin, const Vector& mins, const Vector& maxs, const QAngle& angles, const Color& color);
+
+    // Labels are cached by key for as long as they're drawn every batch
+    void Text(const void* key, const Vector& position, std::string_view text);
+
+    // format(std::string&) only runs when content differs from the last time this label was drawn
+    template<typename TFormat> void Text(const void* key, const Vector& position, uint64_t content, TFormat&& format);
+
+private:
+    struct Label
+    {
+        std::string m_Text;
+        Vector m_Position;
+        uint64_t m_Content;
+        bool m_HasContent = false;
+        bool m_Used = false;
+    };
+    Label& UseLabel(const void* key, const Vector& position);
+    std::unordered_map<const void*, Label> m_Labels;
+
+    enum class Batch
+    {
+        Lines,
+        Triangles,
+        LinesNoDepth,
+        TrianglesNoDepth,
+
+        Count,
+    };
+    static Batch GetBatch(bool triangles, bool noDepthTest);
+
+    struct Vertex
+    {
+        Vector m_Position;
+        Color m_Color;
+    };
+    std::vector<Vertex> m_Vertices;
+
+    // A run of vertices that is culled as a whole
+    struct Shape
+    {
+        Vector m_Mins;
+        Vector m_Maxs;
+        uint32_t m_FirstVertex;
+        uint32_t m_VertexCount;
+        Batch m_Batch;
+    };
+    void AddShape(Batch batch, uint32_t firstVertex);
+    std::vector<Shape> m_Shapes;
+
+    class Renderer final : public CAutoGameSystemPerFrame
+    {
+    public:
+        explicit Renderer(DebugDrawBatch& batch);
+
+        const char* Name() override { return m_Batch.m_Name; }
+
+        void PostRender() override;
+
+    private:
+        DebugDrawBatch& m_Batch;
+        std::vector<Vertex> m_Visible[size_t(Batch::Count)];
+    };
+    std::optional<Renderer> m_Renderer;
+
+    const char* m_Name;
+};
+
+template<typename TFormat>
+inline void DebugDrawBatch::Text(const void* key, const Vector& position, uint64_t content, TFormat&& format)
+{
+    Label& label = UseLabel(key, position);
+    if (label.m_HasContent && label.m_Content == content)
+        return;
+
+    label.m_Text.clear();
+    format(label.m_Text);
+    label.m_Content = content;
+    label.m_HasContent = true;
+}
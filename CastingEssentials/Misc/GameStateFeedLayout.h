@@ -0,0 +1,166 @@
+#pragma once
+
+// Shared memory layout for the game state feed published by the GameStateFeed module.
+//
+// This header deliberately has no SDK or plugin dependencies, so external tools (broadcast
+// graphics, overlays) can include it as-is. The feed is a named file mapping containing a
+// Header followed by a ring of Records. The plugin writes each record in place under a
+// per-slot sequence lock, then advances m_PublishCount; readers never block the game thread.
+//
+// Any change to the layout must bump VERSION.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace StateFeed
+{
+    static constexpr uint32_t MAGIC = 0x53474543; // "CEGS"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr char DEFAULT_MAPPING_NAME[] = "Local\\CastingEssentials_GameState";
+
+    static constexpr uint32_t SLOT_COUNT = 8;
+    static constexpr uint32_t MAX_FEED_PLAYERS = 101;
+    static constexpr uint32_t MAX_FEED_NAME_LENGTH = 32;
+
+    enum class Team : uint8_t
+    {
+        Unassigned = 0,
+        Spectator = 1,
+        Red = 2,
+        Blue = 3,
+    };
+
+    struct PlayerRecord
+    {
+        int32_t m_EntIndex;
+        int32_t m_UserID;
+        Team m_Team;
+        uint8_t m_Class; // TF_CLASS_* values
+        uint8_t m_Alive;
+        uint8_t m_Padding;
+        int32_t m_Health;
+        int32_t m_MaxHealth;
+        float m_UberCharge; // [0, 1], 0 for non-medics
+        int32_t m_Killstreak;
+        int32_t m_Damage;
+        char m_Name[MAX_FEED_NAME_LENGTH]; // UTF-8, always null terminated
+    };
+
+    struct Record
+    {
+        // Odd while the slot is being written. Readers must copy the record out and compare this
+        // before and after; see TryReadLatest().
+        std::atomic<uint32_t> m_Sequence;
+
+        int32_t m_Tick;
+        int64_t m_PublishTime; // QueryPerformanceCounter() at publish, see Header::m_TimerFrequency
+        float m_ClientTime;
+
+        int32_t m_ObserverMode;
+        int32_t m_ObserverTarget; // entindex of the spectated player, 0 if none
+
+        int32_t m_RedScore;
+        int32_t m_BlueScore;
+
+        uint32_t m_PlayerCount;
+        PlayerRecord m_Players[MAX_FEED_PLAYERS];
+    };
+
+    struct Header
+    {
+        uint32_t m_Magic;
+        uint32_t m_Version;
+        uint32_t m_HeaderSize;
+        uint32_t m_RecordSize;
+        uint32_t m_SlotCount;
+        uint32_t m_Padding;
+        int64_t m_TimerFrequency; // QueryPerformanceFrequency()
+
+        // Total records published. The latest record is in slot (m_PublishCount - 1) % m_SlotCount.
+        std::atomic<uint64_t> m_PublishCount;
+
+        Record m_Slots[SLOT_COUNT];
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    static_assert(sizeof(std::atomic<uint32_t>) == 4 && sizeof(std::atomic<uint64_t>) == 8);
+
+    // Readers may be built with other compilers or languages, so every member is placed by hand
+    // and nothing relies on implicit padding. If one of these fires, add explicit padding (and
+    // bump VERSION) rather than changing the numbers.
+    static_assert(offsetof(PlayerRecord, m_EntIndex) == 0);
+    static_assert(offsetof(PlayerRecord, m_UserID) == 4);
+    static_assert(offsetof(PlayerRecord, m_Team) == 8);
+    static_assert(offsetof(PlayerRecord, m_Class) == 9);
+    static_assert(offsetof(PlayerRecord, m_Alive) == 10);
+    static_assert(offsetof(PlayerRecord, m_Padding) == 11);
+    static_assert(offsetof(PlayerRecord, m_Health) == 12);
+    static_assert(offsetof(PlayerRecord, m_MaxHealth) == 16);
+    static_assert(offsetof(PlayerRecord, m_UberCharge) == 20);
+    static_assert(offsetof(PlayerRecord, m_Killstreak) == 24);
+    static_assert(offsetof(PlayerRecord, m_Damage) == 28);
+    static_assert(offsetof(PlayerRecord, m_Name) == 32);
+    static_assert(sizeof(PlayerRecord) == 32 + MAX_FEED_NAME_LENGTH);
+
+    static_assert(offsetof(Record, m_Sequence) == 0);
+    static_assert(offsetof(Record, m_Tick) == 4);
+    static_assert(offsetof(Record, m_PublishTime) == 8); // m_Sequence and m_Tick keep this 8 byte aligned
+    static_assert(offsetof(Record, m_ClientTime) == 16);
+    static_assert(offsetof(Record, m_ObserverMode) == 20);
+    static_assert(offsetof(Record, m_ObserverTarget) == 24);
+    static_assert(offsetof(Record, m_RedScore) == 28);
+    static_assert(offsetof(Record, m_BlueScore) == 32);
+    static_assert(offsetof(Record, m_PlayerCount) == 36);
+    static_assert(offsetof(Record, m_Players) == 40);
+    static_assert(sizeof(Record) == 40 + sizeof(PlayerRecord) * MAX_FEED_PLAYERS); // No tail padding
+    static_assert(sizeof(Record) % alignof(Record) == 0);
+
+    static_assert(offsetof(Header, m_Magic) == 0);
+    static_assert(offsetof(Header, m_Version) == 4);
+    static_assert(offsetof(Header, m_HeaderSize) == 8);
+    static_assert(offsetof(Header, m_RecordSize) == 12);
+    static_assert(offsetof(Header, m_SlotCount) == 16);
+    static_assert(offsetof(Header, m_Padding) == 20);
+    static_assert(offsetof(Header, m_TimerFrequency) == 24);
+    static_assert(offsetof(Header, m_PublishCount) == 32);
+    static_assert(offsetof(Header, m_Slots) == 40);
+    static_assert(sizeof(Header) == 40 + sizeof(Record) * SLOT_COUNT);
+
+    inline bool IsCompatible(const Header& header)
+    {
+        return header.m_Magic == MAGIC && header.m_Version == VERSION && header.m_HeaderSize == sizeof(Header) &&
+               header.m_RecordSize == sizeof(Record) && header.m_SlotCount == SLOT_COUNT;
+    }
+
+    // Reference reader. Copies the most recent record into out if it is newer than
+    // lastPublishCount, and updates lastPublishCount. Returns false if there was nothing new or
+    // the writer lapped us mid-copy (just try again later).
+    inline bool TryReadLatest(const Header& header, Record& out, uint64_t& lastPublishCount)
+    {
+        const uint64_t published = header.m_PublishCount.load(std::memory_order_acquire);
+        if (published == 0 || published == lastPublishCount)
+            return false;
+
+        const Record& slot = header.m_Slots[(published - 1) % SLOT_COUNT];
+
+        const uint32_t before = slot.m_Sequence.load(std::memory_order_acquire);
+        if (before & 1)
+            return false;
+
+        // Everything but the sequence number itself
+        constexpr size_t offset = sizeof(std::atomic<uint32_t>);
+        std::memcpy(reinterpret_cast<char*>(&out) + offset, reinterpret_cast<const char*>(&slot) + offset,
+                    sizeof(Record) - offset);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.m_Sequence.load(std::memory_order_relaxed) != before)
+            return false;
+
+        out.m_Sequence.store(before, std::memory_order_relaxed);
+        lastPublishCount = published;
+        return true;
+    }
+}
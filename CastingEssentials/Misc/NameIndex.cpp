@@ -0,0 +1,116 @@
+#include "NameIndex.h"
+
+#include <algorithm>
+#include <cctype>
+
+// Upper case, so the order matches SuggestionList's
+static std::string Fold(std::string_view str)
+{
+    std::string folded(str);
+    for (auto& c : folded)
+        c = char(toupper((unsigned char)c));
+
+    return folded;
+}
+
+static bool StartsWith(std::string_view str, std::string_view prefix)
+{
+    return str.size() >= prefix.size() && !str.compare(0, prefix.size(), prefix);
+}
+
+void NameIndex::Add(std::string_view name, uint32_t flags)
+{
+    m_Entries.push_back({std::string(name), Fold(name), flags});
+    m_Built = false;
+    m_Suffixes.clear();
+}
+
+void NameIndex::Build()
+{
+    std::sort(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b)
+              { return a.m_Folded != b.m_Folded ? a.m_Folded < b.m_Folded : a.m_Name < b.m_Name; });
+
+    m_Built = true;
+}
+
+void NameIndex::Clear()
+{
+    m_Entries.clear();
+    m_Suffixes.clear();
+    m_Built = false;
+}
+
+std::vector<const char*> NameIndex::FindPrefix(std::string_view prefix, size_t maxResults,
+                                               uint32_t requiredFlags) const
+{
+    Assert(m_Built);
+    std::vector<const char*> results;
+
+    const auto folded = Fold(prefix);
+    auto entry = std::lower_bound(m_Entries.begin(), m_Entries.end(), folded,
+                                  [](const Entry& entry, const std::string& value) { return entry.m_Folded < value; });
+
+    for (; entry != m_Entries.end() && results.size() < maxResults; ++entry)
+    {
+        if (!StartsWith(entry->m_Folded, folded))
+            break;
+
+        if ((entry->m_Flags & requiredFlags) == requiredFlags)
+            results.push_back(entry->m_Name.c_str());
+    }
+
+    return results;
+}
+
+std::vector<const char*> NameIndex::FindSubstring(std::string_view substring, size_t maxResults,
+                                                  uint32_t requiredFlags) const
+{
+    Assert(m_Built);
+    if (substring.empty())
+        return FindPrefix(substring, maxResults, requiredFlags);
+
+    if (m_Suffixes.empty())
+        BuildSuffixes();
+
+    const auto folded = Fold(substring);
+    auto suffix = std::lower_bound(m_Suffixes.begin(), m_Suffixes.end(), folded,
+                                   [&](const Suffix& suffix, const std::string& value)
+                                   { return GetSuffix(suffix) < std::string_view(value); });
+
+    // Entries are in alphabetical order, so the lowest indices are the first results
+    std::vector<uint32_t> matches;
+    for (; suffix != m_Suffixes.end() && StartsWith(GetSuffix(*suffix), folded); ++suffix)
+    {
+        if ((m_Entries[suffix->m_Entry].m_Flags & requiredFlags) == requiredFlags)
+            matches.push_back(suffix->m_Entry);
+    }
+
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+    if (matches.size() > maxResults)
+        matches.resize(maxResults);
+
+    std::vector<const char*> results;
+    results.reserve(matches.size());
+    for (const auto index : matches)
+        results.push_back(m_Entries[index].m_Name.c_str());
+
+    return results;
+}
+
+std::string_view NameIndex::GetSuffix(const Suffix& suffix) const
+{
+    return std::string_view(m_Entries[suffix.m_Entry].m_Folded).substr(suffix.m_Offset);
+}
+
+void NameIndex::BuildSuffixes() const
+{
+    for (uint32_t entry = 0; entry < m_Entries.size(); entry++)
+    {
+        for (uint32_t offset = 0; offset < m_Entries[entry].m_Folded.size(); offset++)
+            m_Suffixes.push_back({entry, offset});
+    }
+
+    std::sort(m_Suffixes.begin(), m_Suffixes.end(),
+              [&](const Suffix& a, const Suffix& b) { return GetSuffix(a) < GetSuffix(b); });
+}
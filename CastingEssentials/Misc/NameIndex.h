@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Case-insensitive prefix and substring lookups over a set of names, for autocompletion.
+//
+// Names are kept sorted by their case-folded form, which makes the array a flattened trie: every
+// name sharing a prefix sits in one contiguous run, found with a binary search. A substring is a
+// prefix of some suffix, so substring lookups binary search a suffix array instead, built the
+// first time one is needed. Either way results come back alphabetically and nothing scans the
+// whole set.
+class NameIndex final
+{
+public:
+    // Invalidates the index until the next Build()
+    void Add(std::string_view name, uint32_t flags = 0);
+    void Build();
+    void Clear();
+
+    bool IsBuilt() const { return m_Built; }
+    size_t size() const { return m_Entries.size(); }
+
+    // Up to maxResults names, alphabetically, whose flags include all of requiredFlags. The
+    // pointers stay valid until the index is changed.
+    std::vector<const char*> FindPrefix(std::string_view prefix, size_t maxResults, uint32_t requiredFlags = 0) const;
+    std::vector<const char*> FindSubstring(std::string_view substring, size_t maxResults,
+                                           uint32_t requiredFlags = 0) const;
+
+private:
+    struct Entry
+    {
+        std::string m_Name;
+        std::string m_Folded;
+        uint32_t m_Flags;
+    };
+    std::vector<Entry> m_Entries;
+    bool m_Built = false;
+
+    struct Suffix
+    {
+        uint32_t m_Entry;
+        uint32_t m_Offset;
+    };
+    std::string_view GetSuffix(const Suffix& suffix) const;
+    void BuildSuffixes() const;
+    mutable std::vector<Suffix> m_Suffixes;
+};
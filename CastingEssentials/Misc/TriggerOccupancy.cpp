@@ -0,0 +1,184 @@
+#include "Misc/TriggerOccupancy.h"
+#include "PluginBase/TFDefinitions.h"
+#include "PluginBase/WorldSnapshot.h"
+
+#include <collisionutils.h>
+#include <vprof.h>
+
+#include <algorithm>
+#include <limits>
+
+#undef min
+#undef max
+
+// Most triggers are room/chokepoint sized, so this keeps the number of triggers per cell low
+static constexpr float MIN_CELL_SIZE = 512;
+static constexpr int MAX_GRID_DIMENSION = 64;
+
+void TriggerOccupancy::Clear()
+{
+    m_Triggers.clear();
+    m_CellOffsets.clear();
+    m_CellTriggers.clear();
+    m_Events.clear();
+    m_GridWidth = m_GridHeight = 0;
+}
+
+void TriggerOccupancy::SetTriggers(const std::vector<std::pair<Vector, Vector>>& bounds)
+{
+    Clear();
+    if (bounds.empty())
+        return;
+
+    Assert(bounds.size() <= std::numeric_limits<uint16_t>::max());
+    m_Triggers.resize(bounds.size());
+
+    Vector2D gridMaxs;
+    m_GridMins.Init(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+    gridMaxs.Init(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < bounds.size(); i++)
+    {
+        auto& trigger = m_Triggers[i];
+        trigger.m_Mins = bounds[i].first;
+        trigger.m_Maxs = bounds[i].second;
+
+        m_GridMins.x = std::min(m_GridMins.x, trigger.m_Mins.x);
+        m_GridMins.y = std::min(m_GridMins.y, trigger.m_Mins.y);
+        gridMaxs.x = std::max(gridMaxs.x, trigger.m_Maxs.x);
+        gridMaxs.y = std::max(gridMaxs.y, trigger.m_Maxs.y);
+    }
+
+    const float extent = std::max(gridMaxs.x - m_GridMins.x, gridMaxs.y - m_GridMins.y);
+    m_CellSize = std::max(MIN_CELL_SIZE, extent / MAX_GRID_DIMENSION);
+    m_GridWidth = std::clamp(int((gridMaxs.x - m_GridMins.x) / m_CellSize) + 1, 1, MAX_GRID_DIMENSION);
+    m_GridHeight = std::clamp(int((gridMaxs.y - m_GridMins.y) / m_CellSize) + 1, 1, MAX_GRID_DIMENSION);
+
+    // Count, then fill
+    const auto cellCount = m_GridWidth * m_GridHeight;
+    m_CellOffsets.assign(cellCount + 1, 0);
+    for (const auto& trigger : m_Triggers)
+    {
+        int x0, y0, x1, y1;
+        GetCellRange(trigger.m_Mins, trigger.m_Maxs, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+                m_CellOffsets[y * m_GridWidth + x + 1]++;
+        }
+    }
+
+    for (int i = 0; i < cellCount; i++)
+        m_CellOffsets[i + 1] += m_CellOffsets[i];
+
+    m_CellTriggers.resize(m_CellOffsets.back());
+    std::vector<uint32_t> fill(m_CellOffsets.begin(), m_CellOffsets.end() - 1);
+    for (size_t i = 0; i < m_Triggers.size(); i++)
+    {
+        int x0, y0, x1, y1;
+        GetCellRange(m_Triggers[i].m_Mins, m_Triggers[i].m_Maxs, x0, y0, x1, y1);
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+                m_CellTriggers[fill[y * m_GridWidth + x]++] = uint16_t(i);
+        }
+    }
+
+    // Worst case is every player entering or leaving every trigger on the same tick
+    m_Events.reserve(m_Triggers.size() * MAX_PLAYERS);
+}
+
+bool TriggerOccupancy::GetCellRange(const Vector& mins, const Vector& maxs, int& x0, int& y0, int& x1,
+                                    int& y1) const
+{
+    const float gridMaxX = m_GridMins.x + m_GridWidth * m_CellSize;
+    const float gridMaxY = m_GridMins.y + m_GridHeight * m_CellSize;
+    if (maxs.x < m_GridMins.x || maxs.y < m_GridMins.y || mins.x > gridMaxX || mins.y > gridMaxY)
+        return false;
+
+    x0 = std::clamp(int((mins.x - m_GridMins.x) / m_CellSize), 0, m_GridWidth - 1);
+    y0 = std::clamp(int((mins.y - m_GridMins.y) / m_CellSize), 0, m_GridHeight - 1);
+    x1 = std::clamp(int((maxs.x - m_GridMins.x) / m_CellSize), 0, m_GridWidth - 1);
+    y1 = std::clamp(int((maxs.y - m_GridMins.y) / m_CellSize), 0, m_GridHeight - 1);
+    return true;
+}
+
+void TriggerOccupancy::Update(const WorldSnapshot& world)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    m_Events.clear();
+    if (m_Triggers.empty())
+        return;
+
+    for (auto& trigger : m_Triggers)
+        trigger.m_NewOccupants.reset();
+
+    for (int entindex = 1; entindex <= MAX_PLAYERS; entindex++)
+    {
+        if (!world.IsAlive(entindex))
+            continue;
+
+        const auto team = world.GetTeam(entindex);
+        if (team != TFTeam::Red && team != TFTeam::Blue)
+            continue;
+
+        const Vector& mins = world.GetWorldSpaceMins(entindex);
+        const Vector& maxs = world.GetWorldSpaceMaxs(entindex);
+
+        int x0, y0, x1, y1;
+        if (!GetCellRange(mins, maxs, x0, y0, x1, y1))
+            continue;
+
+        const auto bit = entindex - 1;
+        for (int y = y0; y <= y1; y++)
+        {
+            for (int x = x0; x <= x1; x++)
+            {
+                const auto cell = y * m_GridWidth + x;
+                for (auto i = m_CellOffsets[cell]; i < m_CellOffsets[cell + 1]; i++)
+                {
+                    auto& trigger = m_Triggers[m_CellTriggers[i]];
+                    if (trigger.m_NewOccupants[bit])
+                        continue; // Already found through another cell
+
+                    if (IsBoxIntersectingBox(trigger.m_Mins, trigger.m_Maxs, mins, maxs))
+                        trigger.m_NewOccupants[bit] = true;
+                }
+            }
+        }
+    }
+
+    for (size_t t = 0; t < m_Triggers.size(); t++)
+    {
+        auto& trigger = m_Triggers[t];
+        const auto changed = trigger.m_Occupants ^ trigger.m_NewOccupants;
+        if (changed.none())
+            continue;
+
+        for (size_t bit = 0; bit < changed.size(); bit++)
+        {
+            if (!changed[bit])
+                continue;
+
+            m_Events.push_back({trigger.m_NewOccupants[bit] ? EventType::Enter : EventType::Exit, int(t),
+                                int(bit + 1)});
+        }
+
+        trigger.m_Occupants = trigger.m_NewOccupants;
+    }
+}
+
+int TriggerOccupancy::GetFirstOccupant(int trigger) const
+{
+    const auto& occupants = m_Triggers[trigger].m_Occupants;
+    if (occupants.none())
+        return 0;
+
+    for (size_t bit = 0; bit < occupants.size(); bit++)
+    {
+        if (occupants[bit])
+            return int(bit + 1);
+    }
+
+    return 0;
+}
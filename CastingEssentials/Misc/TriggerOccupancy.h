@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mathlib/vector.h>
+#include <shareddefs.h>
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+class WorldSnapshot;
+
+// Tracks which players are inside a set of axis-aligned trigger volumes.
+//
+// Triggers are bucketed into a uniform 2D grid when they are set, and Update() tests each
+// player's bounds against only the triggers in the cells it overlaps. Occupancy is persistent
+// between updates, and every change is reported as an enter/exit event that is valid until the
+// next call to Update(). Nothing is allocated after SetTriggers() in the steady state.
+class TriggerOccupancy final
+{
+public:
+    using Occupants = std::bitset<MAX_PLAYERS>; // Indexed by entindex - 1
+
+    enum class EventType
+    {
+        Enter,
+        Exit,
+    };
+
+    struct Event
+    {
+        EventType m_Type;
+        int m_Trigger;     // Index passed to SetTriggers
+        int m_PlayerIndex; // entindex
+    };
+
+    void SetTriggers(const std::vector<std::pair<Vector, Vector>>& bounds);
+    void Clear();
+
+    // Re-evaluates all players against all triggers. Call once per tick.
+    void Update(const WorldSnapshot& world);
+
+    size_t GetTriggerCount() const { return m_Triggers.size(); }
+
+    const Occupants& GetOccupants(int trigger) const { return m_Triggers[trigger].m_Occupants; }
+    bool IsOccupied(int trigger) const { return m_Triggers[trigger].m_Occupants.any(); }
+    int GetFirstOccupant(int trigger) const;
+
+    const std::vector<Event>& GetEvents() const { return m_Events; }
+
+private:
+    struct TriggerState
+    {
+        Vector m_Mins;
+        Vector m_Maxs;
+        Occupants m_Occupants;
+        Occupants m_NewOccupants;
+    };
+    std::vector<TriggerState> m_Triggers;
+
+    // Grid cells are stored as ranges into m_CellTriggers, cell i's triggers are
+    // m_CellTriggers[m_CellOffsets[i]] through m_CellTriggers[m_CellOffsets[i + 1] - 1].
+    Vector2D m_GridMins;
+    float m_CellSize;
+    int m_GridWidth = 0;
+    int m_GridHeight = 0;
+    std::vector<uint32_t> m_CellOffsets; // A few map-spanning triggers can be in every cell
+    std::vector<uint16_t> m_CellTriggers;
+
+    bool GetCellRange(const Vector& mins, const Vector& maxs, int& x0, int& y0, int& x1, int& y1) const;
+
+    std::vector<Event> m_Events;
+};
@@ -7,6 +7,7 @@
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/Player.h"
 #include "PluginBase/TFDefinitions.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include "Misc/HLTVCameraHack.h"
 
@@ -26,7 +27,6 @@
 
 #include <cstring>
 #include <iomanip>
-#include <regex>
 #include <sstream>
 
 MODULE_REGISTER(AutoCameras);
@@ -97,9 +97,12 @@ AutoCameras::AutoCameras()
 
       ce_autocamera_show_triggers("ce_autocamera_show_triggers", "0", FCVAR_UNREGISTERED,
                                   "Shows all triggers on the map."),
+      ce_autocamera_trigger_debug("ce_autocamera_trigger_debug", "0", FCVAR_NONE,
+                                  "Prints players entering and leaving autocamera triggers."),
       ce_autocamera_show_cameras("ce_autocamera_show_cameras", "0", FCVAR_NONE,
                                  "\n\t1 = Shows all cameras on the map.\n"
-                                 "\t2 = Shows view frustums as well.")
+                                 "\t2 = Shows view frustums as well."),
+      m_DebugDraw("AutoCamerasDebugDraw")
 {
     m_CreatingCameraTrigger = false;
     m_CameraTriggerStart.Init();
@@ -149,14 +152,20 @@ static Vector GetCrosshairTarget()
 void AutoCameras::OnTick(bool ingame)
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    m_DebugDraw.Begin();
     if (ingame)
     {
         if (m_CreatingCameraTrigger)
-            NDebugOverlay::Box(Vector(0, 0, 0), m_CameraTriggerStart, GetCrosshairTarget(), 255, 255, 128, 64, 0);
+        {
+            m_DebugDraw.Box(vec3_origin, m_CameraTriggerStart, GetCrosshairTarget(), vec3_angle,
+                            Color(255, 255, 128, 64));
+        }
+
+        UpdateTriggerOccupancy();
 
         while (m_ActiveStoryboard)
         {
-            if (m_ActiveStoryboardElement)
+            if (!m_ActiveStoryboardElement)
             {
                 m_ActiveStoryboard = nullptr;
                 break;
@@ -169,13 +178,14 @@ void AutoCameras::OnTick(bool ingame)
             }
             else
             {
-                std::vector<C_BaseEntity*> entities;
-                CheckTrigger(*m_ActiveStoryboardElement->m_Trigger, entities);
-
-                if (entities.size())
+                const auto triggerIndex = m_ActiveStoryboardElement->m_Trigger->m_Index;
+                if (const int occupant = m_TriggerOccupancy.GetFirstOccupant(triggerIndex))
                 {
-                    ExecuteStoryboardElement(*m_ActiveStoryboardElement, entities.front());
-                    m_ActiveStoryboardElement = m_ActiveStoryboardElement->m_Next.get();
+                    if (auto clientEnt = Interfaces::GetClientEntityList()->GetClientEntity(occupant))
+                    {
+                        ExecuteStoryboardElement(*m_ActiveStoryboardElement, clientEnt->GetBaseEntity());
+                        m_ActiveStoryboardElement = m_ActiveStoryboardElement->m_Next.get();
+                    }
                 }
 
                 break;
@@ -188,6 +198,8 @@ void AutoCameras::OnTick(bool ingame)
         if (ce_autocamera_show_cameras.GetBool())
             DrawCameras();
     }
+
+    m_DebugDraw.End();
 }
 
 void AutoCameras::LevelInit() { LoadConfig(); }
@@ -207,8 +219,10 @@ void AutoCameras::LoadConfig(const char* bspName)
 
     m_MalformedTriggers.clear();
     m_Triggers.clear();
+    m_TriggerOccupancy.Clear();
     m_MalformedCameras.clear();
     m_Cameras.clear();
+    m_CameraNameIndex.Clear();
     m_CameraGroups.clear();
     m_MalformedStoryboards.clear();
     m_Storyboards.clear();
@@ -217,9 +231,7 @@ void AutoCameras::LoadConfig(const char* bspName)
     m_ActiveStoryboard = nullptr;
     m_ActiveStoryboardElement = nullptr;
 
-    std::string mapName(bspName);
-    mapName.erase(mapName.size() - 4, 4); // remove .bsp
-    mapName.erase(0, 5);                  // remove /maps/
+    const std::string mapName = GetMapName(bspName);
 
     KeyValuesAD kv("AutoCameras");
     m_ConfigFilename = strprintf("addons/castingessentials/autocameras/%s.vdf", mapName.c_str());
@@ -247,6 +259,15 @@ void AutoCameras::LoadConfig(const char* bspName)
         LoadTrigger(trigger, m_ConfigFilename.c_str());
     }
 
+    {
+        std::vector<std::pair<Vector, Vector>> triggerBounds;
+        triggerBounds.reserve(m_Triggers.size());
+        for (const auto& trigger : m_Triggers)
+            triggerBounds.emplace_back(trigger->m_Mins, trigger->m_Maxs);
+
+        m_TriggerOccupancy.SetTriggers(triggerBounds);
+    }
+
     for (KeyValues* camera = kv->GetFirstTrueSubKey(); camera; camera = camera->GetNextTrueSubKey())
     {
         if (stricmp("camera", camera->GetName()))
@@ -360,6 +381,7 @@ bool AutoCameras::LoadTrigger(KeyValues* const trigger, const char* const filena
 
     FixupBounds(newTrigger->m_Mins, newTrigger->m_Maxs);
 
+    newTrigger->m_Index = int(m_Triggers.size());
     m_Triggers.push_back(std::move(newTrigger));
     return true;
 }
@@ -646,31 +668,22 @@ bool AutoCameras::LoadAction(std::unique_ptr<StoryboardElement>& actionOut, KeyV
     return true;
 }
 
-void AutoCameras::CheckTrigger(const Trigger& trigger, std::vector<C_BaseEntity*>& entities)
+void AutoCameras::UpdateTriggerOccupancy()
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
 
-    for (int i = 1; i <= Interfaces::GetEngineTool()->GetMaxClients(); i++)
-    {
-        IClientEntity* const clientEnt = Interfaces::GetClientEntityList()->GetClientEntity(i);
-        if (!clientEnt)
-            continue;
-
-        IClientRenderable* const renderable = clientEnt->GetClientRenderable();
-        if (!renderable)
-            continue;
+    m_TriggerOccupancy.Update(WorldSnapshot::Get());
 
-        Vector mins, maxs;
-        renderable->GetRenderBoundsWorldspace(mins, maxs);
-
-        if (IsBoxIntersectingBox(trigger.m_Mins, trigger.m_Maxs, mins, maxs))
-        {
-            C_BaseEntity* const baseEntity = clientEnt->GetBaseEntity();
-            if (!baseEntity)
-                continue;
+    if (!ce_autocamera_trigger_debug.GetBool())
+        return;
 
-            entities.push_back(baseEntity);
-        }
+    for (const auto& event : m_TriggerOccupancy.GetEvents())
+    {
+        const char* playerName = Player::GetName(event.m_PlayerIndex);
+        ConColorMsg(Color(128, 255, 128, 255), "[%s] %s %s trigger \"%s\"\n", ce_autocamera_trigger_debug.GetName(),
+                    playerName ? playerName : "(null)",
+                    event.m_Type == TriggerOccupancy::EventType::Enter ? "entered" : "left",
+                    m_Triggers[event.m_Trigger]->m_Name.c_str());
     }
 }
 
@@ -1184,35 +1197,48 @@ void AutoCameras::GotoCamera(const CCommand& args)
 int AutoCameras::GotoCameraCompletion(const char* const partial,
                                       char commands[COMMAND_COMPLETION_MAXITEMS][COMMAND_COMPLETION_ITEM_LENGTH])
 {
-    std::cmatch match;
-    const std::string regexString = strprintf("\\s*%s\\s+\"?(.*?)\"?\\s*$", GetModule()->ce_autocamera_goto.GetName());
-
-    // Interesting... this only works if you pass a const char* to std::regex's constructor, and not if you pass an
-    // std::string.
-    if (!std::regex_search(partial, match, std::regex(regexString.c_str(), std::regex_constants::icase)))
-        return 0;
-
     AutoCameras* const mod = GetModule();
+    const char* const cmdName = mod->ce_autocamera_goto.GetName();
+    const auto cmdLength = strlen(cmdName);
 
-    auto cameras = mod->GetAlphabeticalCameras();
-    if (match[1].length() >= 1)
+    const auto trimLeft = [](std::string_view& str)
     {
-        const char* const matchStr = match[1].first;
-        for (size_t i = 0; i < cameras.size(); i++)
-        {
-            if (!stristr(cameras[i]->m_Name.c_str(), matchStr))
-                cameras.erase(cameras.begin() + i--);
-        }
+        while (!str.empty() && isspace((unsigned char)str.front()))
+            str.remove_prefix(1);
+    };
+
+    // <command> <whitespace> ["]<partial camera name>["]
+    std::string_view args(partial);
+    trimLeft(args);
+    if (args.size() <= cmdLength || strnicmp(args.data(), cmdName, cmdLength) ||
+        !isspace((unsigned char)args[cmdLength]))
+    {
+        return 0;
     }
 
-    size_t i;
-    for (i = 0; i < COMMAND_COMPLETION_MAXITEMS && i < cameras.size(); i++)
+    args.remove_prefix(cmdLength);
+    trimLeft(args);
+    while (!args.empty() && isspace((unsigned char)args.back()))
+        args.remove_suffix(1);
+
+    if (!args.empty() && args.front() == '"')
+        args.remove_prefix(1);
+    if (!args.empty() && args.back() == '"')
+        args.remove_suffix(1);
+
+    if (!mod->m_CameraNameIndex.IsBuilt())
     {
-        strcpy_s(commands[i], COMMAND_COMPLETION_ITEM_LENGTH, mod->ce_autocamera_goto.GetName());
-        const auto& nameStr = cameras[i]->m_Name;
-        strcat_s(commands[i], COMMAND_COMPLETION_ITEM_LENGTH, (std::string(" ") + nameStr).c_str());
+        for (const auto& camera : mod->m_Cameras)
+            mod->m_CameraNameIndex.Add(camera->m_Name);
+
+        mod->m_CameraNameIndex.Build();
     }
-    return i;
+
+    const auto names = mod->m_CameraNameIndex.FindSubstring(args, COMMAND_COMPLETION_MAXITEMS);
+    for (size_t i = 0; i < names.size(); i++)
+        sprintf_s(commands[i], COMMAND_COMPLETION_ITEM_LENGTH, "%s %s", cmdName, names[i]);
+
+    return int(names.size());
 }
 
 float AutoCameras::GetCameraFOV(const Camera& camera, ObserverMode mode) const
@@ -1232,16 +1258,23 @@ void AutoCameras::DrawTriggers()
 {
     for (const auto& trigger : m_Triggers)
     {
-        NDebugOverlay::Box(Vector(0, 0, 0), trigger->m_Mins, trigger->m_Maxs, 128, 255, 128, 64, 0);
+        if (m_TriggerOccupancy.IsOccupied(trigger->m_Index))
+            m_DebugDraw.Box(vec3_origin, trigger->m_Mins, trigger->m_Maxs, vec3_angle, Color(255, 128, 128, 64));
+        else
+            m_DebugDraw.Box(vec3_origin, trigger->m_Mins, trigger->m_Maxs, vec3_angle, Color(128, 255, 128, 64));
 
-        const Vector difference = VectorLerp(trigger->m_Mins, trigger->m_Maxs, 0.5);
-        NDebugOverlay::Text(VectorLerp(trigger->m_Mins, trigger->m_Maxs, 0.5), trigger->m_Name.c_str(), false, 0);
+        m_DebugDraw.Text(trigger.get(), VectorLerp(trigger->m_Mins, trigger->m_Maxs, 0.5), trigger->m_Name);
     }
 }
 
 void AutoCameras::DrawCameras()
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    const Color cameraColor(128, 128, 255, 64);
+    const Color cameraLineColor(128, 128, 255, 255);
+    const Color frustumColor(200, 200, 200, 32);
+    const Color frustumOutlineColor(200, 200, 200, 255);
+
     for (const auto& camera : m_Cameras)
     {
         Vector forward, up, right;
@@ -1250,14 +1283,14 @@ void AutoCameras::DrawCameras()
         // Draw cameras
         if (ce_autocamera_show_cameras.GetInt() > 0)
         {
-            NDebugOverlay::BoxAngles(camera->m_Pos, Vector(-16, -16, -16), Vector(16, 16, 16), camera->m_DefaultAngle,
-                                     128, 128, 255, 64, 0);
+            m_DebugDraw.Box(camera->m_Pos, Vector(-16, -16, -16), Vector(16, 16, 16), camera->m_DefaultAngle,
+                            cameraColor);
 
             const Vector endPos = camera->m_Pos + (forward * 128);
-            NDebugOverlay::Line(camera->m_Pos, endPos, 128, 128, 255, true, 0);
-            NDebugOverlay::Cross3DOriented(endPos, camera->m_DefaultAngle, 16, 128, 128, 255, true, 0);
+            m_DebugDraw.Line(camera->m_Pos, endPos, cameraLineColor, true);
+            m_DebugDraw.Cross3DOriented(endPos, camera->m_DefaultAngle, 16, cameraLineColor, true);
 
-            NDebugOverlay::Text(camera->m_Pos, camera->m_Name.c_str(), false, 0);
+            m_DebugDraw.Text(camera.get(), camera->m_Pos, camera->m_Name);
         }
 
         // From http://stackoverflow.com/a/27872276
@@ -1282,22 +1315,22 @@ void AutoCameras::DrawCameras()
             const Vector farBottomRight = farCenter - up * (farHeight * 0.5) + right * (farWidth * 0.5);
 
             // Draw camera frustums
-            NDebugOverlay::TriangleIgnoreZ(camera->m_Pos, farTopRight, farTopLeft, 200, 200, 200, 32, false, 0);
-            NDebugOverlay::TriangleIgnoreZ(camera->m_Pos, farBottomRight, farTopRight, 200, 200, 200, 32, false, 0);
-            NDebugOverlay::TriangleIgnoreZ(camera->m_Pos, farBottomLeft, farBottomRight, 200, 200, 200, 32, false, 0);
-            NDebugOverlay::TriangleIgnoreZ(camera->m_Pos, farTopLeft, farBottomLeft, 200, 200, 200, 32, false, 0);
+            m_DebugDraw.Triangle(camera->m_Pos, farTopRight, farTopLeft, frustumColor);
+            m_DebugDraw.Triangle(camera->m_Pos, farBottomRight, farTopRight, frustumColor);
+            m_DebugDraw.Triangle(camera->m_Pos, farBottomLeft, farBottomRight, frustumColor);
+            m_DebugDraw.Triangle(camera->m_Pos, farTopLeft, farBottomLeft, frustumColor);
 
             // Triangle outlines
-            NDebugOverlay::Line(camera->m_Pos, farTopRight, 200, 200, 200, false, 0);
-            NDebugOverlay::Line(camera->m_Pos, farTopLeft, 200, 200, 200, false, 0);
-            NDebugOverlay::Line(camera->m_Pos, farBottomLeft, 200, 200, 200, false, 0);
-            NDebugOverlay::Line(camera->m_Pos, farBottomRight, 200, 200, 200, false, 0);
+            m_DebugDraw.Line(camera->m_Pos, farTopRight, frustumOutlineColor);
+            m_DebugDraw.Line(camera->m_Pos, farTopLeft, frustumOutlineColor);
+            m_DebugDraw.Line(camera->m_Pos, farBottomLeft, frustumOutlineColor);
+            m_DebugDraw.Line(camera->m_Pos, farBottomRight, frustumOutlineColor);
 
             // Far plane outline
-            NDebugOverlay::Line(farTopLeft, farTopRight, 200, 200, 200, false, 0);
-            NDebugOverlay::Line(farTopRight, farBottomRight, 200, 200, 200, false, 0);
-            NDebugOverlay::Line(farBottomRight, farBottomLeft, 200, 200, 200, false, 0);
-            NDebugOverlay::Line(farBottomLeft, farTopLeft, 200, 200, 200, false, 0);
+            m_DebugDraw.Line(farTopLeft, farTopRight, frustumOutlineColor);
+            m_DebugDraw.Line(farTopRight, farBottomRight, frustumOutlineColor);
+            m_DebugDraw.Line(farBottomRight, farBottomLeft, frustumOutlineColor);
+            m_DebugDraw.Line(farBottomLeft, farTopLeft, frustumOutlineColor);
         }
     }
 }
@@ -1348,18 +1381,6 @@ const AutoCameras::Camera* AutoCameras::FindCamera(const char* const cameraName)
     return nullptr;
 }
 
-std::vector<const AutoCameras::Camera*> AutoCameras::GetAlphabeticalCameras() const
-{
-    std::vector<const Camera*> retVal;
-    for (const auto& cam : m_Cameras)
-        retVal.push_back(cam.get());
-
-    std::sort(retVal.begin(), retVal.end(),
-              [](const Camera* a, const Camera* b) { return stricmp(a->m_Name.c_str(), b->m_Name.c_str()); });
-
-    return retVal;
-}
-
 void AutoCameras::SetupMirroredCameras()
 {
     bool again;
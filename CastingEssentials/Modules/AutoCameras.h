@@ -1,4 +1,7 @@
 #pragma once
+#include "Misc/DebugDrawBatch.h"
+#include "Misc/NameIndex.h"
+#include "Misc/TriggerOccupancy.h"
 #include "PluginBase/Modules.h"
 
 #include <convar.h>
@@ -18,6 +21,10 @@ public:
 
     void OnTick(bool ingame) override;
 
+    // Occupancy of the triggers defined in the current map's autocamera config, updated once per tick.
+    // Trigger indices match the order the triggers were loaded in.
+    const TriggerOccupancy& GetTriggerOccupancy() const { return m_TriggerOccupancy; }
+
 private:
     void LevelInit() override;
 
@@ -38,7 +45,9 @@ private:
     bool LoadAction(std::unique_ptr<StoryboardElement>& action, KeyValues* actionKV, const char* storyboardName,
                     const char* filename);
 
-    void CheckTrigger(const Trigger& trigger, std::vector<C_BaseEntity*>& entities);
+    TriggerOccupancy m_TriggerOccupancy;
+    ConVar ce_autocamera_trigger_debug;
+    void UpdateTriggerOccupancy();
 
     void ExecuteStoryboardElement(const StoryboardElement& element, C_BaseEntity* triggerer);
     void ExecuteShot(const Shot& shot, C_BaseEntity* triggerer);
@@ -84,6 +93,8 @@ private:
     ConVar ce_autocamera_show_triggers;
     ConVar ce_autocamera_show_cameras;
 
+    DebugDrawBatch m_DebugDraw;
+
     float GetCameraFOV(const Camera& camera, ObserverMode mode) const;
 
     void DrawTriggers();
@@ -101,6 +112,7 @@ private:
         std::string m_Name;
         Vector m_Mins;
         Vector m_Maxs;
+        int m_Index; // Index into m_Triggers/m_TriggerOccupancy
     };
     std::vector<std::unique_ptr<const Trigger>> m_Triggers;
     std::vector<std::string> m_MalformedTriggers;
@@ -130,7 +142,7 @@ private:
     std::vector<std::unique_ptr<const Camera>> m_Cameras;
     std::vector<std::string> m_MalformedCameras;
     const Camera* FindCamera(const char* cameraName) const;
-    std::vector<const Camera*> GetAlphabeticalCameras() const;
+    NameIndex m_CameraNameIndex; // Built on demand for autocompletion
 
     void SetupMirroredCameras();
 
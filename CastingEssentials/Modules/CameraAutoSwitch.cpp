@@ -13,6 +13,7 @@
 #include "Controls/StubPanel.h"
 #include "Misc/HLTVCameraHack.h"
 #include "Modules/CameraState.h"
+#include "PluginBase/GameEventRouter.h"
 #include "PluginBase/HookManager.h"
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/player.h"
@@ -20,6 +21,7 @@
 #include <cdll_int.h>
 #include <client/c_baseentity.h>
 #include <gameeventdefs.h>
+#include <igameevents.h>
 #include <shareddefs.h>
 #include <toolframework/ienginetool.h>
 #include <vgui/IVGui.h>
@@ -29,18 +31,18 @@ MODULE_REGISTER(CameraAutoSwitch);
 
 CameraAutoSwitch::CameraAutoSwitch()
     : ce_cameraautoswitch_enabled("ce_cameraautoswitch_enabled", "0", FCVAR_NONE,
-                                  "enable automatic switching of camera"),
+                                  "enable automatic switching of camera",
+                                  [](IConVar*, const char*, float) { GetModule()->UpdateEnabledState(); }),
 
       ce_cameraautoswitch_killer("ce_cameraautoswitch_killer", "0", FCVAR_NONE,
                                  "switch to killer upon spectated player death",
-                                 [](IConVar* var, const char* pOldValue, float flOldValue) {
-                                     GetModule()->ToggleKillerEnabled(var, pOldValue, flOldValue);
-                                 }),
+                                 [](IConVar*, const char*, float) { GetModule()->UpdateEnabledState(); }),
       ce_cameraautoswitch_killer_delay("ce_cameraautoswitch_killer_delay", "0", FCVAR_NONE,
-                                       "delay before switching to killer", true, 0, false, FLT_MAX)
+                                       "delay before switching to killer", true, 0, false, FLT_MAX),
+
+      m_PlayerDeathSubscription(GAME_EVENT_PLAYER_DEATH, [](IGameEvent* event) { GetModule()->OnPlayerDeath(event); })
 {
 }
-CameraAutoSwitch::~CameraAutoSwitch() { Interfaces::GetGameEventManager()->RemoveListener(this); }
 
 bool CameraAutoSwitch::CheckDependencies()
 {
@@ -93,18 +95,12 @@ bool CameraAutoSwitch::CheckDependencies()
     return ready;
 }
 
-void CameraAutoSwitch::FireGameEvent(IGameEvent* event)
-{
-    if (!strcmp(event->GetName(), GAME_EVENT_PLAYER_DEATH))
-        OnPlayerDeath(event);
-}
-
 void CameraAutoSwitch::OnPlayerDeath(IGameEvent* event)
 {
     if (!ce_cameraautoswitch_enabled.GetBool() || !ce_cameraautoswitch_killer.GetBool())
         return;
 
-    Assert(!strcmp(event->GetName(), GAME_EVENT_PLAYER_DEATH));
+    Assert(GetGameEventRouter()->GetEventID(event) == m_PlayerDeathSubscription.GetEventID());
 
     // Ignore feign death
     const auto deathFlags = event->GetInt("death_flags");
@@ -150,18 +146,10 @@ void CameraAutoSwitch::OnPlayerDeath(IGameEvent* event)
     }
 }
 
-void CameraAutoSwitch::ToggleKillerEnabled(IConVar* var, const char* pOldValue, float flOldValue)
+void CameraAutoSwitch::UpdateEnabledState()
 {
-    if (ce_cameraautoswitch_enabled.GetBool())
-    {
-        if (!Interfaces::GetGameEventManager()->FindListener(this, GAME_EVENT_PLAYER_DEATH))
-            Interfaces::GetGameEventManager()->AddListener(this, GAME_EVENT_PLAYER_DEATH, false);
-    }
-    else
-    {
-        if (Interfaces::GetGameEventManager()->FindListener(this, GAME_EVENT_PLAYER_DEATH))
-            Interfaces::GetGameEventManager()->RemoveListener(this);
-    }
+    m_PlayerDeathSubscription.SetEnabled(ce_cameraautoswitch_enabled.GetBool() &&
+                                         ce_cameraautoswitch_killer.GetBool());
 }
 
 void CameraAutoSwitch::OnTick(bool inGame)
@@ -1,15 +1,16 @@
 #pragma once
 
+#include "PluginBase/GameEventRouter.h"
 #include "PluginBase/Modules.h"
 
 #include <convar.h>
-#include <igameevents.h>
 
-class CameraAutoSwitch final : public Module<CameraAutoSwitch>, IGameEventListener2
+class IGameEvent;
+
+class CameraAutoSwitch final : public Module<CameraAutoSwitch>
 {
 public:
     CameraAutoSwitch();
-    virtual ~CameraAutoSwitch();
 
     static bool CheckDependencies();
     static constexpr __forceinline const char* GetModuleName() { return "Camera Auto-Switch"; }
@@ -18,7 +19,7 @@ private:
     ConVar ce_cameraautoswitch_enabled;
     ConVar ce_cameraautoswitch_killer;
     ConVar ce_cameraautoswitch_killer_delay;
-    void ToggleKillerEnabled(IConVar* var, const char* pOldValue, float flOldValue);
+    void UpdateEnabledState();
 
     void QueueSwitchToPlayer(int player, int fromPlayer, float delay);
     bool m_AutoSwitchQueued;
@@ -26,8 +27,8 @@ private:
     int m_AutoSwitchToPlayer;
     float m_AutoSwitchTime;
 
-    void FireGameEvent(IGameEvent* event) override;
     void OnPlayerDeath(IGameEvent* event);
+    GameEventSubscription m_PlayerDeathSubscription;
 
     void OnTick(bool inGame) override;
 };
@@ -0,0 +1,422 @@
+#include "CameraPaths.h"
+#include "Modules/CameraState.h"
+#include "PluginBase/Interfaces.h"
+
+#include <cdll_int.h>
+#include <filesystem.h>
+#include <toolframework/ienginetool.h>
+#include <utlbuffer.h>
+#include <vprof.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <random>
+
+#undef max
+#undef min
+
+MODULE_REGISTER(CameraPaths);
+
+static constexpr uint32_t CAMPATH_FILE_MAGIC = 0x48545043; // "CPTH"
+static constexpr uint32_t CAMPATH_FILE_VERSION = 1;
+static constexpr int MAX_PATH_NAME_LENGTH = 64;
+
+CameraPaths::CameraPaths()
+    : ce_campath_speed("ce_campath_speed", "400", FCVAR_NONE,
+                       "Speed, in units per second, that ce_campath_play moves along a path if no duration is given.",
+                       true, 1, false, 0),
+
+      ce_campath_add(
+          "ce_campath_add", [](const CCommand& args) { GetModule()->AddKeyframe(args); },
+          "Appends the current camera position, angles and fov to a camera path. Usage: ce_campath_add <name>"),
+      ce_campath_record(
+          "ce_campath_record", [](const CCommand& args) { GetModule()->StartRecording(args); },
+          "Appends a keyframe to a camera path every [interval] seconds (default 0.5) until ce_campath_stop. Usage: "
+          "ce_campath_record <name> [interval]"),
+      ce_campath_play(
+          "ce_campath_play", [](const CCommand& args) { GetModule()->Play(args); },
+          "Moves the camera along a path at constant speed, over [duration] seconds or at ce_campath_speed. Usage: "
+          "ce_campath_play <name> [duration]"),
+      ce_campath_stop("ce_campath_stop", []() { GetModule()->Stop(); },
+                      "Stops camera path recording and playback."),
+      ce_campath_delete(
+          "ce_campath_delete", [](const CCommand& args) { GetModule()->DeletePath(args); },
+          "Deletes a camera path. Usage: ce_campath_delete <name>"),
+      ce_campath_list("ce_campath_list", []() { GetModule()->ListPaths(); }, "Lists camera paths for this map."),
+      ce_campath_load("ce_campath_load", []() { GetModule()->LoadPaths(); },
+                      "Reloads camera paths for this map from disk, discarding unsaved changes."),
+      ce_campath_benchmark(
+          "ce_campath_benchmark", [](const CCommand& args) { GetModule()->RunBenchmark(args); },
+          "Compiles a random path with [keyframes] keyframes (default 32) and reports compile and per-frame "
+          "evaluation cost. Usage: ce_campath_benchmark [keyframes]")
+{
+}
+
+bool CameraPaths::CheckDependencies()
+{
+    Modules().Depend<CameraState>();
+
+    bool ready = true;
+
+    if (!Interfaces::GetEngineTool())
+    {
+        PluginWarning("Required interface IEngineTool for module %s not available!\n", GetModuleName());
+        ready = false;
+    }
+
+    if (!Interfaces::GetFileSystem())
+    {
+        PluginWarning("Required interface IFileSystem for module %s not available!\n", GetModuleName());
+        ready = false;
+    }
+
+    return ready;
+}
+
+bool CameraPaths::SetupEngineViewOverride(Vector& origin, QAngle& angles, float& fov)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    if (!m_PlayingPath)
+        return false;
+
+    const float progress = (Interfaces::GetEngineTool()->HostTime() - m_PlayStartTime) / m_PlayDuration;
+    m_PlayingPath->m_Spline.Evaluate(std::clamp(progress, 0.0f, 1.0f), origin, angles, fov);
+
+    // Hold the last frame, then let go next frame
+    if (progress >= 1)
+        m_PlayingPath = nullptr;
+
+    return true;
+}
+
+void CameraPaths::OnTick(bool inGame)
+{
+    if (m_RecordingPath.empty() || !inGame)
+        return;
+
+    const float time = Interfaces::GetEngineTool()->HostTime();
+    if (time - m_LastRecordTime < m_RecordInterval)
+        return;
+
+    auto found = m_Paths.find(m_RecordingPath);
+    if (found == m_Paths.end())
+    {
+        m_RecordingPath.clear();
+        return;
+    }
+
+    CameraSpline::Keyframe keyframe;
+    if (GetCurrentView(keyframe))
+        found->second.m_Keyframes.push_back(keyframe);
+
+    m_LastRecordTime = time;
+}
+
+void CameraPaths::LevelInit() { LoadPaths(); }
+
+void CameraPaths::LevelShutdown()
+{
+    Stop();
+    m_Paths.clear();
+}
+
+bool CameraPaths::GetCurrentView(CameraSpline::Keyframe& keyframe) const
+{
+    const auto cameraState = CameraState::GetModule();
+    if (!cameraState)
+        return false;
+
+    cameraState->GetLastFramePluginView(keyframe.m_Origin, keyframe.m_Angles, &keyframe.m_FOV);
+    return true;
+}
+
+CameraPaths::Path* CameraPaths::FindPath(const CCommand& args, int argIndex)
+{
+    auto found = m_Paths.find(args.Arg(argIndex));
+    if (found == m_Paths.end())
+    {
+        Warning("%s: No camera path named \"%s\"\n", args[0], args.Arg(argIndex));
+        return nullptr;
+    }
+
+    return &found->second;
+}
+
+void CameraPaths::AddKeyframe(const CCommand& args)
+{
+    if (args.ArgC() != 2 || strlen(args[1]) >= MAX_PATH_NAME_LENGTH)
+    {
+        Warning("Usage: %s <name>\n", args[0]);
+        return;
+    }
+
+    CameraSpline::Keyframe keyframe;
+    if (!GetCurrentView(keyframe))
+        return;
+
+    auto& path = m_Paths[args[1]];
+    path.m_Keyframes.push_back(keyframe);
+    path.m_Spline.Compile(path.m_Keyframes);
+
+    Msg("%s: Added keyframe %i to \"%s\"\n", args[0], (int)path.m_Keyframes.size(), args[1]);
+    SavePaths();
+}
+
+void CameraPaths::StartRecording(const CCommand& args)
+{
+    float interval = 0.5f;
+    if (args.ArgC() < 2 || args.ArgC() > 3 || strlen(args[1]) >= MAX_PATH_NAME_LENGTH ||
+        (args.ArgC() > 2 && !TryParseFloat(args[2], interval)))
+    {
+        Warning("Usage: %s <name> [interval]\n", args[0]);
+        return;
+    }
+
+    Stop();
+
+    // Recording always starts a path over
+    m_Paths[args[1]].m_Keyframes.clear();
+    m_RecordingPath = args[1];
+    m_RecordInterval = std::max(interval, 0.0f);
+    m_LastRecordTime = -FLT_MAX;
+
+    Msg("%s: Recording \"%s\", use ce_campath_stop to finish\n", args[0], args[1]);
+}
+
+void CameraPaths::Play(const CCommand& args)
+{
+    float duration = 0;
+    if (args.ArgC() < 2 || args.ArgC() > 3 || (args.ArgC() > 2 && !TryParseFloat(args[2], duration)))
+    {
+        Warning("Usage: %s <name> [duration]\n", args[0]);
+        return;
+    }
+
+    const Path* path = FindPath(args);
+    if (!path)
+        return;
+
+    if (!path->m_Spline.IsValid())
+    {
+        Warning("%s: Camera path \"%s\" has no keyframes\n", args[0], args[1]);
+        return;
+    }
+
+    Stop();
+
+    if (duration <= 0)
+        duration = path->m_Spline.GetLength() / ce_campath_speed.GetFloat();
+
+    m_PlayingPath = path;
+    m_PlayStartTime = Interfaces::GetEngineTool()->HostTime();
+    m_PlayDuration = std::max(duration, 0.01f);
+}
+
+void CameraPaths::Stop()
+{
+    m_PlayingPath = nullptr;
+
+    if (!m_RecordingPath.empty())
+    {
+        if (auto found = m_Paths.find(m_RecordingPath); found != m_Paths.end())
+        {
+            auto& path = found->second;
+            path.m_Spline.Compile(path.m_Keyframes);
+            PluginMsg("Recorded %i keyframes to camera path \"%s\"\n", (int)path.m_Keyframes.size(),
+                      m_RecordingPath.c_str());
+        }
+
+        m_RecordingPath.clear();
+        SavePaths();
+    }
+}
+
+void CameraPaths::DeletePath(const CCommand& args)
+{
+    if (args.ArgC() != 2)
+    {
+        Warning("Usage: %s <name>\n", args[0]);
+        return;
+    }
+
+    const Path* path = FindPath(args);
+    if (!path)
+        return;
+
+    if (m_PlayingPath == path || m_RecordingPath == args[1])
+        Stop();
+
+    m_Paths.erase(args[1]);
+    SavePaths();
+}
+
+void CameraPaths::ListPaths() const
+{
+    for (const auto& [name, path] : m_Paths)
+    {
+        Msg("    %s: %i keyframes, %1.0f units\n", name.c_str(), (int)path.m_Keyframes.size(),
+            path.m_Spline.GetLength());
+    }
+
+    Msg("%i camera paths\n", (int)m_Paths.size());
+}
+
+std::string CameraPaths::GetFilename() const
+{
+    const char* const levelName = Interfaces::GetEngineClient()->GetLevelName();
+    if (!levelName || !levelName[0])
+        return std::string();
+
+    return strprintf("addons/castingessentials/campaths/%s.campath", GetMapName(levelName).c_str());
+}
+
+// File layout, little endian:
+//     uint32 magic, uint32 version, uint32 path count
+//     per path: null terminated name, uint32 keyframe count
+//         per keyframe: float origin[3], float angles[3], float fov
+void CameraPaths::SavePaths() const
+{
+    const auto filename = GetFilename();
+    if (filename.empty())
+        return;
+
+    CUtlBuffer buffer;
+    buffer.PutUnsignedInt(CAMPATH_FILE_MAGIC);
+    buffer.PutUnsignedInt(CAMPATH_FILE_VERSION);
+    buffer.PutUnsignedInt((uint32_t)m_Paths.size());
+
+    for (const auto& [name, path] : m_Paths)
+    {
+        buffer.PutString(name.c_str());
+        buffer.PutUnsignedInt((uint32_t)path.m_Keyframes.size());
+
+        for (const auto& key : path.m_Keyframes)
+        {
+            for (int i = 0; i < 3; i++)
+                buffer.PutFloat(key.m_Origin[i]);
+            for (int i = 0; i < 3; i++)
+                buffer.PutFloat(key.m_Angles[i]);
+
+            buffer.PutFloat(key.m_FOV);
+        }
+    }
+
+    const auto fs = Interfaces::GetFileSystem();
+    fs->CreateDirHierarchy("addons/castingessentials/campaths", "MOD");
+    if (!fs->WriteFile(filename.c_str(), "MOD", buffer))
+        PluginWarning("Failed to save camera paths to %s!\n", filename.c_str());
+}
+
+void CameraPaths::LoadPaths()
+{
+    Stop();
+    m_Paths.clear();
+
+    const auto filename = GetFilename();
+    if (filename.empty())
+        return;
+
+    CUtlBuffer buffer;
+    if (!Interfaces::GetFileSystem()->ReadFile(filename.c_str(), "MOD", buffer))
+        return; // No paths for this map yet
+
+    if (buffer.GetUnsignedInt() != CAMPATH_FILE_MAGIC || buffer.GetUnsignedInt() != CAMPATH_FILE_VERSION)
+    {
+        PluginWarning("Unable to load camera paths from %s: unrecognized file format\n", filename.c_str());
+        return;
+    }
+
+    const uint32_t pathCount = buffer.GetUnsignedInt();
+    for (uint32_t p = 0; p < pathCount && buffer.IsValid(); p++)
+    {
+        char name[MAX_PATH_NAME_LENGTH];
+        buffer.GetString(name, sizeof(name));
+
+        const uint32_t keyframeCount = buffer.GetUnsignedInt();
+        if (keyframeCount > (uint32_t)buffer.GetBytesRemaining() / (sizeof(float) * 7))
+            break;
+
+        auto& path = m_Paths[name];
+        path.m_Keyframes.resize(keyframeCount);
+        for (auto& key : path.m_Keyframes)
+        {
+            for (int i = 0; i < 3; i++)
+                key.m_Origin[i] = buffer.GetFloat();
+            for (int i = 0; i < 3; i++)
+                key.m_Angles[i] = buffer.GetFloat();
+
+            key.m_FOV = buffer.GetFloat();
+        }
+
+        path.m_Spline.Compile(path.m_Keyframes);
+    }
+
+    if (!buffer.IsValid() || m_Paths.size() != pathCount)
+        PluginWarning("Camera path file %s is truncated, some paths were not loaded\n", filename.c_str());
+}
+
+void CameraPaths::RunBenchmark(const CCommand& args)
+{
+    int keyframeCount = 32;
+    if (args.ArgC() > 1 && !TryParseInteger(args[1], keyframeCount))
+    {
+        Warning("Usage: %s [keyframes]\n", args[0]);
+        return;
+    }
+
+    keyframeCount = std::clamp(keyframeCount, 2, 10000);
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> step(-512, 512);
+    std::uniform_real_distribution<float> angle(-180, 180);
+
+    std::vector<CameraSpline::Keyframe> keyframes(keyframeCount);
+    Vector origin(0, 0, 0);
+    for (auto& key : keyframes)
+    {
+        origin += Vector(step(random), step(random), step(random) / 4);
+        key.m_Origin = origin;
+        key.m_Angles.Init(angle(random) / 2, angle(random), 0);
+        key.m_FOV = 90;
+    }
+
+    using clock = std::chrono::high_resolution_clock;
+
+    CameraSpline spline;
+    const auto compileStart = clock::now();
+    spline.Compile(keyframes);
+    const auto compileSeconds = std::chrono::duration<double>(clock::now() - compileStart).count();
+
+    constexpr int EVALUATIONS = 1000000;
+    Vector evalOrigin;
+    QAngle evalAngles;
+    float evalFOV;
+    float checksum = 0;
+
+    const auto evalStart = clock::now();
+    for (int i = 0; i < EVALUATIONS; i++)
+    {
+        spline.Evaluate(float(i) / (EVALUATIONS - 1), evalOrigin, evalAngles, evalFOV);
+        checksum += evalOrigin.x;
+    }
+    const auto evalSeconds = std::chrono::duration<double>(clock::now() - evalStart).count();
+
+    // Check how constant the speed actually is, over 1000 even steps
+    constexpr int SPEED_STEPS = 1000;
+    const float expectedStep = spline.GetLength() / SPEED_STEPS;
+    float worstError = 0;
+    Vector last;
+    spline.Evaluate(0, last, evalAngles, evalFOV);
+    for (int i = 1; i <= SPEED_STEPS; i++)
+    {
+        spline.Evaluate(float(i) / SPEED_STEPS, evalOrigin, evalAngles, evalFOV);
+        worstError = std::max(worstError, std::abs(evalOrigin.DistTo(last) - expectedStep) / expectedStep);
+        last = evalOrigin;
+    }
+
+    Msg("%i keyframes, %1.0f units long:\n", keyframeCount, spline.GetLength());
+    Msg("    compile: %1.3f ms\n", compileSeconds * 1000);
+    Msg("    evaluate: %1.1f ns per frame (checksum %1.0f)\n", evalSeconds * 1e9 / EVALUATIONS, checksum);
+    Msg("    worst speed deviation: %1.2f%%\n", worstError * 100);
+}
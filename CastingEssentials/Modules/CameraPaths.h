@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Misc/CameraSpline.h"
+#include "PluginBase/ICameraOverride.h"
+#include "PluginBase/Modules.h"
+
+#include <convar.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class CameraPaths final : public Module<CameraPaths>, public ICameraOverride
+{
+public:
+    CameraPaths();
+
+    static bool CheckDependencies();
+    static constexpr __forceinline const char* GetModuleName() { return "Camera Paths"; }
+
+    bool IsPlaying() const { return m_PlayingPath != nullptr; }
+
+private:
+    struct Path
+    {
+        std::vector<CameraSpline::Keyframe> m_Keyframes;
+        CameraSpline m_Spline;
+    };
+
+    bool InToolModeOverride() const override { return IsPlaying(); }
+    bool IsThirdPersonCameraOverride() const override { return IsPlaying(); }
+    bool SetupEngineViewOverride(Vector& origin, QAngle& angles, float& fov) override;
+
+    void OnTick(bool inGame) override;
+    void LevelInit() override;
+    void LevelShutdown() override;
+
+    bool GetCurrentView(CameraSpline::Keyframe& keyframe) const;
+    Path* FindPath(const CCommand& args, int argIndex = 1);
+
+    void AddKeyframe(const CCommand& args);
+    void StartRecording(const CCommand& args);
+    void Play(const CCommand& args);
+    void Stop();
+    void DeletePath(const CCommand& args);
+    void ListPaths() const;
+    void RunBenchmark(const CCommand& args);
+
+    std::string GetFilename() const;
+    void SavePaths() const;
+    void LoadPaths();
+
+    std::map<std::string, Path> m_Paths;
+
+    std::string m_RecordingPath;
+    float m_RecordInterval = 0;
+    float m_LastRecordTime = 0;
+
+    const Path* m_PlayingPath = nullptr;
+    float m_PlayStartTime = 0;
+    float m_PlayDuration = 0;
+
+    ConVar ce_campath_speed;
+
+    ConCommand ce_campath_add;
+    ConCommand ce_campath_record;
+    ConCommand ce_campath_play;
+    ConCommand ce_campath_stop;
+    ConCommand ce_campath_delete;
+    ConCommand ce_campath_list;
+    ConCommand ce_campath_load;
+    ConCommand ce_campath_benchmark;
+};
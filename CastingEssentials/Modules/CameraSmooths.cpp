@@ -1,5 +1,4 @@
 #include "CameraSmooths.h"
-#include "Misc/DebugOverlay.h"
 #include "Misc/HLTVCameraHack.h"
 #include "Modules/CameraState.h"
 #include "Modules/CameraTools.h"
@@ -7,6 +6,7 @@
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/Player.h"
 #include "PluginBase/TFDefinitions.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include <cdll_int.h>
 #include <client/hltvcamera.h>
@@ -21,6 +21,7 @@
 #undef min
 #undef max
 #include <algorithm>
+#include <cmath>
 
 MODULE_REGISTER(CameraSmooths);
 
@@ -61,7 +62,8 @@ CameraSmooths::CameraSmooths()
       ce_smoothing_los_min(
           "ce_smoothing_los_min", "0", FCVAR_NONE,
           "Minimum percentage of points that must pass the LOS check before we allow ourselves to smooth to a target.",
-          true, 0, true, 1)
+          true, 0, true, 1),
+      m_DebugDraw("CameraSmoothsDebugDraw")
 {
     m_EndMode = OBS_MODE_NONE;
     m_EndTarget = 0;
@@ -123,14 +125,16 @@ void CameraSmooths::UpdateCollisionTests()
         m_CollisionTests.clear();
 
         const Vector& viewPos = CameraState::GetModule()->GetLastFramePluginViewOrigin();
+        const auto& world = WorldSnapshot::Get();
 
         for (Player* player : Player::Iterable())
         {
-            const auto team = player->GetTeam();
-            if (team != TFTeam::Red && team != TFTeam::Blue)
+            const auto entindex = player->entindex();
+            if (!world.IsAlive(entindex))
                 continue;
 
-            if (!player->IsAlive())
+            const auto team = world.GetTeam(entindex);
+            if (team != TFTeam::Red && team != TFTeam::Blue)
                 continue;
 
             IClientEntity* const entity = player->GetEntity();
@@ -140,7 +144,7 @@ void CameraSmooths::UpdateCollisionTests()
             CollisionTest newTest;
             newTest.m_Entity = entity->GetRefEHandle();
 
-            const Vector eyePos = player->GetEyePosition();
+            const Vector& eyePos = world.GetEyePosition(entindex);
 
             {
                 const Vector buffer(ce_smoothing_los_buffer.GetFloat());
@@ -168,11 +172,13 @@ void CameraSmooths::DrawCollisionTests()
         if (!entity)
             continue;
 
-        NDebugOverlay::Box(Vector(0, 0, 0), test.m_Mins, test.m_Maxs, Lerp(test.m_Visibility, 255, 0),
-                           Lerp(test.m_Visibility, 0, 255), 0, 64, 0);
+        m_DebugDraw.Box(vec3_origin, test.m_Mins, test.m_Maxs, vec3_angle,
+                        Color(Lerp(test.m_Visibility, 255, 0), Lerp(test.m_Visibility, 0, 255), 0, 64));
 
-        const std::string success = strprintf("Success rate: %1.1f", test.m_Visibility * 100);
-        NDebugOverlay::Text(entity->GetAbsOrigin(), success.c_str(), false, 0);
+        // The label shows tenths of a percent, so only reformat it when that changes
+        const float percent = test.m_Visibility * 100;
+        m_DebugDraw.Text(entity, entity->GetAbsOrigin(), uint64_t(std::lround(percent * 10)),
+                         [percent](std::string& text) { text = strprintf("Success rate: %1.1f", percent); });
     }
 }
 
@@ -442,9 +448,12 @@ bool CameraSmooths::SetupEngineViewOverride(Vector& origin, QAngle& angles, floa
 void CameraSmooths::OnTick(bool inGame)
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    m_DebugDraw.Begin();
     if (inGame)
     {
         if (ce_smoothing_debug_los.GetBool())
             DrawCollisionTests();
     }
+
+    m_DebugDraw.End();
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Misc/DebugDrawBatch.h"
 #include "PluginBase/ICameraOverride.h"
 #include "PluginBase/Modules.h"
 
@@ -73,6 +74,7 @@ private:
     int m_CollisionTestFrame;
     std::vector<CollisionTest> m_CollisionTests;
     void UpdateCollisionTests();
+    DebugDrawBatch m_DebugDraw;
     void DrawCollisionTests();
     float GetVisibility(int entIndex);
 
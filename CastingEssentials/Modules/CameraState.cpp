@@ -1,5 +1,6 @@
 #include "CameraState.h"
 #include "Misc/HLTVCameraHack.h"
+#include "Modules/CameraPaths.h"
 #include "Modules/CameraSmooths.h"
 #include "Modules/CameraTools.h"
 #include "Modules/FOVOverride.h"
@@ -15,10 +16,9 @@
 MODULE_REGISTER(CameraState);
 
 CameraState::CameraState()
-    : m_InToolModeHook(std::bind(&CameraState::InToolModeOverride, this)),
-      m_IsThirdPersonCameraHook(std::bind(&CameraState::IsThirdPersonCameraOverride, this)),
-      m_SetupEngineViewHook(std::bind(&CameraState::SetupEngineViewOverride, this, std::placeholders::_1,
-                                      std::placeholders::_2, std::placeholders::_3))
+    : m_InToolModeHook(this),
+      m_IsThirdPersonCameraHook(this),
+      m_SetupEngineViewHook(this)
 {
     InitViews();
 
@@ -95,6 +95,9 @@ bool CameraState::InToolModeOverride()
 
         if (!m_ThisFrameInToolMode && (module = FOVOverride::GetModule()) != nullptr)
             m_ThisFrameInToolMode = module->InToolModeOverride();
+
+        if (!m_ThisFrameInToolMode && (module = CameraPaths::GetModule()) != nullptr)
+            m_ThisFrameInToolMode = module->InToolModeOverride();
     }
 
     if (m_ThisFrameInToolMode)
@@ -121,6 +124,9 @@ bool CameraState::IsThirdPersonCameraOverride()
 
         if (!m_ThisFrameIsThirdPerson && (module = FOVOverride::GetModule()) != nullptr)
             m_ThisFrameIsThirdPerson = module->IsThirdPersonCameraOverride();
+
+        if (!m_ThisFrameIsThirdPerson && (module = CameraPaths::GetModule()) != nullptr)
+            m_ThisFrameIsThirdPerson = module->IsThirdPersonCameraOverride();
     }
 
     if (m_ThisFrameIsThirdPerson)
@@ -132,6 +138,7 @@ bool CameraState::IsThirdPersonCameraOverride()
 bool CameraState::SetupEngineViewOverride(Vector& origin, QAngle& angles, float& fov)
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
     m_LastFrameEngineView = m_ThisFrameEngineView;
     m_LastFramePluginView = m_ThisFramePluginView;
 
@@ -159,6 +166,13 @@ bool CameraState::SetupEngineViewOverride(Vector& origin, QAngle& angles, float&
             retVal = module->SetupEngineViewOverride(origin, angles, fov) || retVal;
             m_ThisFramePluginView.Set(origin, angles, fov);
         }
+
+        // Last, so a playing camera path owns the whole view
+        if ((module = CameraPaths::GetModule()) != nullptr)
+        {
+            retVal = module->SetupEngineViewOverride(origin, angles, fov) || retVal;
+            m_ThisFramePluginView.Set(origin, angles, fov);
+        }
     }
 
     if (retVal)
@@ -63,9 +63,10 @@ private:
 
     void Invalidate(bool& b);
 
-    Hook<HookFunc::IClientEngineTools_InToolMode> m_InToolModeHook;
-    Hook<HookFunc::IClientEngineTools_IsThirdPersonCamera> m_IsThirdPersonCameraHook;
-    Hook<HookFunc::IClientEngineTools_SetupEngineView> m_SetupEngineViewHook;
+    Hook<HookFunc::IClientEngineTools_InToolMode, &CameraState::InToolModeOverride> m_InToolModeHook;
+    Hook<HookFunc::IClientEngineTools_IsThirdPersonCamera, &CameraState::IsThirdPersonCameraOverride>
+        m_IsThirdPersonCameraHook;
+    Hook<HookFunc::IClientEngineTools_SetupEngineView, &CameraState::SetupEngineViewOverride> m_SetupEngineViewHook;
     void SetupHooks(bool connect);
 };
 
@@ -8,6 +8,7 @@
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/Player.h"
 #include "PluginBase/TFDefinitions.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include <cdll_int.h>
 #include <characterset.h>
@@ -131,8 +132,8 @@ CameraTools::CameraTools()
           "ce_cameratools_show_users", [](const CCommand& args) { GetModule()->ShowUsers(args); },
           "Lists all currently connected players on the server."),
 
-      m_SetModeHook(std::bind(&CameraTools::SetModeOverride, this, std::placeholders::_1)),
-      m_SetPrimaryTargetHook(std::bind(&CameraTools::SetPrimaryTargetOverride, this, std::placeholders::_1))
+      m_SetModeHook(this),
+      m_SetPrimaryTargetHook(this)
 {
     m_SwitchReason = ModeSwitchReason::Unknown;
     m_SpecGUISettings = new KeyValues("Resource/UI/SpectatorTournament.res");
@@ -512,12 +513,14 @@ void CameraTools::SpecClass(TFTeam team, TFClassType playerClass, int classIndex
     int validPlayersCount = 0;
     Player* validPlayers[MAX_PLAYERS];
 
+    const auto& world = WorldSnapshot::Get();
     for (Player* player : Player::Iterable())
     {
-        if (player->GetTeam() != team || player->GetClass() != playerClass)
+        const auto entindex = player->entindex();
+        if (!world.IsAlive(entindex))
             continue;
 
-        if (!player->IsAlive())
+        if (world.GetTeam(entindex) != team || world.GetClass(entindex) != playerClass)
             continue;
 
         validPlayers[validPlayersCount++] = player;
@@ -624,7 +627,7 @@ void CameraTools::OnTick(bool inGame)
         {
             int mode = -1;
             int target = -1;
-            std::string playerName;
+            const char* playerName = nullptr;
             if (Interfaces::GetEngineClient()->IsHLTV())
             {
                 mode = Interfaces::GetHLTVCamera()->GetMode();
@@ -646,9 +649,8 @@ void CameraTools::OnTick(bool inGame)
                 Interfaces::GetEngineClient()->Con_NPrintf(
                     GetConLine(), "Current spec_mode: %i %s", mode,
                     mode >= 0 && mode < NUM_OBSERVER_MODES ? s_ObserverModes[mode] : "INVALID");
-                Interfaces::GetEngineClient()->Con_NPrintf(
-                    GetConLine(), "Current target: %i%s", target,
-                    target == 0 ? " (Unspecified)" : (strprintf(" (%s)", playerName.c_str())).c_str());
+                Interfaces::GetEngineClient()->Con_NPrintf(GetConLine(), "Current target: %i (%s)", target,
+                                                           target == 0 ? "Unspecified" : playerName ? playerName : "");
             }
         }
 
@@ -724,18 +726,19 @@ void CameraTools::ToggleDisableViewPunches(const ConVar* var)
             return;
         }
 
-        RecvVarProxyFn zeroProxy = [](const CRecvProxyData* pData, void* pStruct, void* pOut) {
+        const auto zeroProxy = [](const CRecvProxyData* pData, void* pStruct, void* pOut, const RecvProxyRouter::Next&)
+        {
             auto outVec = reinterpret_cast<Vector*>(pOut);
             outVec->Init(0, 0, 0);
         };
 
-        m_vecPunchAngleProxy = CreateVariablePusher(angle->m_ProxyFn, zeroProxy);
-        m_vecPunchAngleVelProxy = CreateVariablePusher(velocity->m_ProxyFn, zeroProxy);
+        m_vecPunchAngleProxy.emplace(angle, zeroProxy, RecvProxyRouter::SlotRange::Players()).Enable();
+        m_vecPunchAngleVelProxy.emplace(velocity, zeroProxy, RecvProxyRouter::SlotRange::Players()).Enable();
     }
     else
     {
-        m_vecPunchAngleProxy.Clear();
-        m_vecPunchAngleVelProxy.Clear();
+        m_vecPunchAngleProxy.reset();
+        m_vecPunchAngleVelProxy.reset();
     }
 }
 
@@ -756,7 +759,7 @@ void CameraTools::UpdateIsTaunting()
     if (!player)
         return;
 
-    m_IsTaunting = player->CheckCondition(TFCond::TFCond_Taunting);
+    m_IsTaunting = WorldSnapshot::Get().CheckCondition(player->entindex(), TFCond::TFCond_Taunting);
 }
 
 void CameraTools::AttachHooks(bool attach) { m_SetModeHook.SetEnabled(attach); }
@@ -3,6 +3,7 @@
 #include "PluginBase/Hook.h"
 #include "PluginBase/ICameraOverride.h"
 #include "PluginBase/Modules.h"
+#include "PluginBase/RecvProxyRouter.h"
 
 #include <convar.h>
 #include <mathlib/vector.h>
@@ -49,13 +50,13 @@ protected:
     bool SetupEngineViewOverride(Vector& origin, QAngle& angles, float& fov) override;
 
 private:
-    Hook<HookFunc::C_HLTVCamera_SetMode> m_SetModeHook;
-    Hook<HookFunc::C_HLTVCamera_SetPrimaryTarget> m_SetPrimaryTargetHook;
-    KeyValues* m_SpecGUISettings;
-
     void SetModeOverride(int iMode);
     void SetPrimaryTargetOverride(int nEntity);
 
+    Hook<HookFunc::C_HLTVCamera_SetMode, &CameraTools::SetModeOverride> m_SetModeHook;
+    Hook<HookFunc::C_HLTVCamera_SetPrimaryTarget, &CameraTools::SetPrimaryTargetOverride> m_SetPrimaryTargetHook;
+    KeyValues* m_SpecGUISettings;
+
     ConVar ce_cameratools_show_mode;
     ConVar ce_cameratools_autodirector_mode;
     ConVar ce_cameratools_force_target;
@@ -147,8 +148,8 @@ private:
     bool FixViewHeights();
 
     void ToggleDisableViewPunches(const ConVar* var);
-    VariablePusher<RecvVarProxyFn> m_vecPunchAngleProxy;
-    VariablePusher<RecvVarProxyFn> m_vecPunchAngleVelProxy;
+    std::optional<RecvProxySubscription> m_vecPunchAngleProxy;
+    std::optional<RecvProxySubscription> m_vecPunchAngleVelProxy;
 
     Vector CalcPosForAngle(const TPLockRuleset& ruleset, const Vector& orbitCenter, const QAngle& angle) const;
 
@@ -7,6 +7,7 @@
 
 #include <vprof.h>
 
+#include <algorithm>
 #include <optional>
 #include <regex>
 #include <sstream>
@@ -66,10 +67,9 @@ ConsoleTools::ConsoleTools()
       ce_consoletools_unhide_all_cvars("ce_consoletools_unhide_all_cvars", UnhideAllCvars,
                                        "Removes FCVAR_DEVELOPMENTONLY and FCVAR_HIDDEN from all cvars."),
 
-      m_ConsoleColorPrintfHook(
-          std::bind(&ConsoleTools::ConsoleColorPrintfHook, this, std::placeholders::_1, std::placeholders::_2)),
-      m_ConsoleDPrintfHook(std::bind(&ConsoleTools::ConsoleDPrintfHook, this, std::placeholders::_1)),
-      m_ConsolePrintfHook(std::bind(&ConsoleTools::ConsolePrintfHook, this, std::placeholders::_1)),
+      m_ConsoleColorPrintfHook(this),
+      m_ConsoleDPrintfHook(this),
+      m_ConsolePrintfHook(this),
 
       m_SetLimitsCallbacks(&SetLimits, &SetLimitsAutocomplete), m_AddFlagsCallbacks(&AddFlags, &FlagModifyAutocomplete),
       m_RemoveFlagsCallbacks(&RemoveFlags, &FlagModifyAutocomplete),
@@ -225,48 +225,47 @@ void ConsoleTools::SetLimitsAutocomplete(const CCommand& partial, CUtlVector<CUt
     if (partial.ArgC() < 1 || partial.ArgC() > 2)
         return;
 
-    const auto partialCvarLength = strlen(partial[1]);
-    SuggestionList<> suggestions;
+    SuggestCommands(partial, outSuggestions, COMMAND_INDEX_CONVAR); // Only care about actual ConVars
+}
 
-    for (const ConCommandBase* cmd = g_pCVar->GetCommands(); cmd; cmd = cmd->GetNext())
-    {
-        if (cmd->IsCommand())
-            continue; // Only care about actual ConVars
+void ConsoleTools::FlagModifyAutocomplete(const CCommand& partial, CUtlVector<CUtlString>& outSuggestions)
+{
+    if (partial.ArgC() < 1 || partial.ArgC() > 2)
+        return;
 
-        const char* const cmdName = cmd->GetName();
-        if (strnicmp(cmdName, partial[1], partialCvarLength))
-            continue;
+    SuggestCommands(partial, outSuggestions, 0);
+}
 
-        suggestions.insert(cmdName);
-    }
+void ConsoleTools::RebuildCommandIndex()
+{
+    m_CommandIndex.Clear();
+    m_CommandIndexHead = g_pCVar->GetCommands();
 
-    // Copy suggestions into output array
-    suggestions.EnsureSorted();
-    for (const auto& suggestion : suggestions)
-    {
-        char buf[512];
-        const auto length = sprintf_s(buf, "%s %s", partial[0], suggestion);
-        outSuggestions.AddToTail(CUtlString(buf, length));
-    }
+    for (const ConCommandBase* cmd = m_CommandIndexHead; cmd; cmd = cmd->GetNext())
+        m_CommandIndex.Add(cmd->GetName(), cmd->IsCommand() ? 0 : COMMAND_INDEX_CONVAR);
+
+    m_CommandIndex.Build();
 }
 
-void ConsoleTools::FlagModifyAutocomplete(const CCommand& partial, CUtlVector<CUtlString>& outSuggestions)
+void ConsoleTools::SuggestCommands(const CCommand& partial, CUtlVector<CUtlString>& outSuggestions,
+                                   uint32_t requiredFlags)
 {
-    if (partial.ArgC() < 1 || partial.ArgC() > 2)
-        return;
+    ConsoleTools* const module = GetModule();
 
-    const auto arg1Length = partial.ArgC() > 1 ? strlen(partial[1]) : 0;
+    // New registrations always go on the front of the list
+    if (!module->m_CommandIndex.IsBuilt() || module->m_CommandIndexHead != g_pCVar->GetCommands())
+        module->RebuildCommandIndex();
 
-    SuggestionList<> suggestions;
-    for (const ConCommandBase* cmd = g_pCVar->GetCommands(); cmd; cmd = cmd->GetNext())
+    auto suggestions = module->m_CommandIndex.FindPrefix(partial[1], COMMAND_COMPLETION_MAXITEMS, requiredFlags);
+
+    // ...but they can be removed from anywhere, so make sure nothing we're about to suggest is gone
+    if (std::any_of(suggestions.begin(), suggestions.end(),
+                    [](const char* name) { return !g_pCVar->FindCommandBase(name); }))
     {
-        const char* const cmdName = cmd->GetName();
-        if (!strnicmp(cmdName, partial[1], arg1Length))
-            suggestions.insert(cmdName);
+        module->RebuildCommandIndex();
+        suggestions = module->m_CommandIndex.FindPrefix(partial[1], COMMAND_COMPLETION_MAXITEMS, requiredFlags);
     }
 
-    // Copy suggestions into output array
-    suggestions.EnsureSorted();
     for (const auto& suggestion : suggestions)
     {
         char buf[512];
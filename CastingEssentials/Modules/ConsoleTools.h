@@ -1,5 +1,6 @@
 #pragma once
 #include "Misc/CommandCallbacks.h"
+#include "Misc/NameIndex.h"
 #include "PluginBase/Hook.h"
 #include "PluginBase/Modules.h"
 
@@ -23,9 +24,9 @@ private:
 
     bool CheckFilters(const char* msg) const;
 
-    Hook<HookFunc::ICvar_ConsoleColorPrintf> m_ConsoleColorPrintfHook;
-    Hook<HookFunc::ICvar_ConsoleDPrintf> m_ConsoleDPrintfHook;
-    Hook<HookFunc::ICvar_ConsolePrintf> m_ConsolePrintfHook;
+    Hook<HookFunc::ICvar_ConsoleColorPrintf, &ConsoleTools::ConsoleColorPrintfHook> m_ConsoleColorPrintfHook;
+    Hook<HookFunc::ICvar_ConsoleDPrintf, &ConsoleTools::ConsoleDPrintfHook> m_ConsoleDPrintfHook;
+    Hook<HookFunc::ICvar_ConsolePrintf, &ConsoleTools::ConsolePrintfHook> m_ConsolePrintfHook;
 
     std::unordered_map<std::string, std::regex> m_Filters;
 
@@ -59,6 +60,13 @@ private:
     static void RemoveFlags(const CCommand& command);
     static void FlagModifyAutocomplete(const CCommand& partial, CUtlVector<CUtlString>& suggestions);
 
+    // Every registered ConCommand and ConVar name, rebuilt whenever the registrations change
+    static constexpr uint32_t COMMAND_INDEX_CONVAR = 1 << 0;
+    NameIndex m_CommandIndex;
+    const ConCommandBase* m_CommandIndexHead = nullptr;
+    void RebuildCommandIndex();
+    static void SuggestCommands(const CCommand& partial, CUtlVector<CUtlString>& suggestions, uint32_t requiredFlags);
+
     CommandCallbacks m_RemoveAliasCallbacks;
     static void RemoveAlias(const CCommand& command);
     static void RemoveAliasAutocomplete(const CCommand& partial, CUtlVector<CUtlString>& suggestions);
@@ -10,7 +10,7 @@
 #include "PluginBase/HookManager.h"
 #include "PluginBase/Interfaces.h"
 
-MODULE_REGISTER(FreezeInfo);
+MODULE_REGISTER_LAZY(FreezeInfo);
 
 class FreezeInfo::Panel : public vgui::EditablePanel
 {
@@ -28,20 +28,32 @@ private:
     float threshold;
 };
 
+ConVar FreezeInfo::ce_freezeinfo_enabled(
+    "ce_freezeinfo_enabled", "0", FCVAR_NONE, "enables display of an info panel when a freeze is detected",
+    [](IConVar* var, const char*, float)
+    {
+        const auto enabled = static_cast<ConVar*>(var);
+        Modules().UpdateLazyModule<FreezeInfo>(enabled->GetBool(),
+                                               [&](FreezeInfo* module) { module->ToggleEnabled(enabled); });
+    });
+ConVar FreezeInfo::ce_freezeinfo_threshold("ce_freezeinfo_threshold", "1", FCVAR_NONE,
+                                           "the time of a freeze (in seconds) before the info panel is displayed",
+                                           [](IConVar* var, const char* pOldValue, float flOldValue)
+                                           {
+                                               if (auto module = TryGetModule())
+                                                   module->ChangeThreshold(var, pOldValue, flOldValue);
+                                           });
+ConCommand FreezeInfo::ce_freezeinfo_reload_settings(
+    "ce_freezeinfo_reload_settings",
+    []()
+    {
+        if (auto module = TryGetModule())
+            module->ReloadSettings();
+    },
+    "reload settings for the freeze info panel from the resource file", FCVAR_NONE);
+
 FreezeInfo::FreezeInfo()
-    : ce_freezeinfo_enabled(
-          "ce_freezeinfo_enabled", "0", FCVAR_NONE, "enables display of an info panel when a freeze is detected",
-          [](IConVar* var, const char*, float) { GetModule()->ToggleEnabled(static_cast<ConVar*>(var)); }),
-      ce_freezeinfo_threshold("ce_freezeinfo_threshold", "1", FCVAR_NONE,
-                              "the time of a freeze (in seconds) before the info panel is displayed",
-                              [](IConVar* var, const char* pOldValue, float flOldValue) {
-                                  GetModule()->ChangeThreshold(var, pOldValue, flOldValue);
-                              }),
-      ce_freezeinfo_reload_settings(
-          "ce_freezeinfo_reload_settings", []() { GetModule()->ReloadSettings(); },
-          "reload settings for the freeze info panel from the resource file", FCVAR_NONE),
-
-      m_PostEntityPacketReceivedHook(std::bind(&FreezeInfo::PostEntityPacketReceivedHook, this))
+    : m_PostEntityPacketReceivedHook(this)
 {
 }
 
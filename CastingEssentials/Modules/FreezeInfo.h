@@ -20,11 +20,12 @@ private:
     std::unique_ptr<Panel> m_Panel;
 
     void PostEntityPacketReceivedHook();
-    Hook<HookFunc::IPrediction_PostEntityPacketReceived> m_PostEntityPacketReceivedHook;
+    Hook<HookFunc::IPrediction_PostEntityPacketReceived, &FreezeInfo::PostEntityPacketReceivedHook>
+        m_PostEntityPacketReceivedHook;
 
-    ConVar ce_freezeinfo_enabled;
-    ConVar ce_freezeinfo_threshold;
-    ConCommand ce_freezeinfo_reload_settings;
+    static ConVar ce_freezeinfo_enabled;
+    static ConVar ce_freezeinfo_threshold;
+    static ConCommand ce_freezeinfo_reload_settings;
 
     void ChangeThreshold(IConVar* var, const char* pOldValue, float flOldValue);
     void ReloadSettings();
@@ -0,0 +1,365 @@
+#include "Modules/GameStateFeed.h"
+#include "Misc/GameStateFeedLayout.h"
+#include "Modules/CameraState.h"
+#include "PluginBase/Interfaces.h"
+#include "PluginBase/Player.h"
+#include "PluginBase/TFDefinitions.h"
+#include "PluginBase/TFPlayerResource.h"
+#include "PluginBase/TFTeamResource.h"
+#include "PluginBase/WorldSnapshot.h"
+
+#include <cdll_int.h>
+#include <client/c_baseentity.h>
+#include <toolframework/ienginetool.h>
+#include <vprof.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#undef max
+#undef min
+
+MODULE_REGISTER(GameStateFeed);
+
+using namespace StateFeed;
+
+static_assert(MAX_FEED_PLAYERS >= MAX_PLAYERS);
+
+struct GameStateFeed::Benchmark
+{
+    std::string m_MappingName;
+    std::chrono::steady_clock::duration m_Duration;
+    std::atomic<bool> m_Cancel = false;
+    std::atomic<bool> m_Done = false;
+
+    bool m_Opened = false;
+    int64_t m_TimerFrequency = 1;
+    uint64_t m_Reads = 0;
+    uint64_t m_Retries = 0;
+    std::vector<int64_t> m_Latencies; // QPC ticks from publish to read
+};
+
+static int64_t GetTimestamp()
+{
+    LARGE_INTEGER value;
+    QueryPerformanceCounter(&value);
+    return value.QuadPart;
+}
+
+GameStateFeed::GameStateFeed()
+    : ce_statefeed_enabled(
+          "ce_statefeed_enabled", "0", FCVAR_NONE,
+          "Publishes player, score and camera state every tick into a named shared memory ring buffer for external "
+          "tools. See Misc/GameStateFeedLayout.h for the layout.",
+          [](IConVar*, const char*, float) { GetModule()->UpdateEnabledState(); }),
+      ce_statefeed_name("ce_statefeed_name", DEFAULT_MAPPING_NAME, FCVAR_NONE,
+                        "Name of the shared memory mapping for ce_statefeed_enabled.",
+                        [](IConVar*, const char*, float) { GetModule()->UpdateEnabledState(); }),
+      ce_statefeed_benchmark(
+          "ce_statefeed_benchmark", [](const CCommand& args) { GetModule()->StartBenchmark(args); },
+          "Runs the reference reader on a background thread for the given number of seconds (default 10) and reports "
+          "publish-to-read latency. Requires ce_statefeed_enabled 1 and a running game.")
+{
+}
+
+GameStateFeed::~GameStateFeed()
+{
+    if (m_Benchmark)
+        m_Benchmark->m_Cancel.store(true, std::memory_order_relaxed);
+
+    if (m_BenchmarkThread.joinable())
+        m_BenchmarkThread.join();
+
+    CloseMapping();
+}
+
+void GameStateFeed::UpdateEnabledState()
+{
+    // Always reopen, in case the name changed
+    CloseMapping();
+
+    if (ce_statefeed_enabled.GetBool())
+        OpenMapping();
+}
+
+bool GameStateFeed::OpenMapping()
+{
+    const auto name = ce_statefeed_name.GetString();
+
+    const HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(Header), name);
+    if (!mapping)
+    {
+        Warning("%s: Failed to create shared memory mapping \"%s\" (error %lu)\n", GetModuleName(), name,
+                GetLastError());
+        return false;
+    }
+
+    const bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+
+    auto header = static_cast<Header*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Header)));
+    if (!header)
+    {
+        Warning("%s: Failed to map shared memory \"%s\" (error %lu)\n", GetModuleName(), name, GetLastError());
+        CloseHandle(mapping);
+        return false;
+    }
+
+    if (existed && header->m_Magic == MAGIC && !IsCompatible(*header))
+    {
+        Warning("%s: Shared memory \"%s\" is already in use with a different layout version\n", GetModuleName(),
+                name);
+        UnmapViewOfFile(header);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // Readers that are still attached from a previous session keep working: the publish count
+    // and slot sequences only ever move forward.
+    if (!existed || header->m_Magic != MAGIC)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        header->m_Version = VERSION;
+        header->m_HeaderSize = sizeof(Header);
+        header->m_RecordSize = sizeof(Record);
+        header->m_SlotCount = SLOT_COUNT;
+        header->m_TimerFrequency = frequency.QuadPart;
+        header->m_PublishCount.store(0, std::memory_order_relaxed);
+        for (auto& slot : header->m_Slots)
+            slot.m_Sequence.store(0, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_release);
+        header->m_Magic = MAGIC;
+    }
+
+    m_MappingHandle = mapping;
+    m_Header = header;
+    m_LastPublishedTick = -1;
+    return true;
+}
+
+void GameStateFeed::CloseMapping()
+{
+    if (m_Header)
+    {
+        UnmapViewOfFile(m_Header);
+        m_Header = nullptr;
+    }
+
+    if (m_MappingHandle)
+    {
+        CloseHandle(m_MappingHandle);
+        m_MappingHandle = nullptr;
+    }
+}
+
+void GameStateFeed::OnTick(bool inGame)
+{
+    if (m_Benchmark && m_Benchmark->m_Done.load(std::memory_order_acquire))
+        FinishBenchmark();
+
+    if (!m_Header || !inGame)
+        return;
+
+    const auto tick = Interfaces::GetEngineTool()->ClientTick();
+    if (tick == m_LastPublishedTick)
+        return;
+
+    Publish(tick);
+    m_LastPublishedTick = tick;
+}
+
+void GameStateFeed::Publish(int tick)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    const auto& snapshot = WorldSnapshot::Get();
+    const auto playerResource = TFPlayerResource::GetPlayerResource();
+    const auto teamResource = TFTeamResource::GetTeamResource();
+
+    const uint64_t publishCount = m_Header->m_PublishCount.load(std::memory_order_relaxed);
+    Record& record = m_Header->m_Slots[publishCount % SLOT_COUNT];
+
+    // Seqlock: odd while we're writing. The release fence keeps the field writes below from
+    // becoming visible before the odd sequence number does.
+    const uint32_t sequence = record.m_Sequence.load(std::memory_order_relaxed);
+    record.m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    record.m_Tick = tick;
+    record.m_ClientTime = Interfaces::GetEngineTool()->ClientTime();
+
+    record.m_ObserverMode = CameraState::GetLocalObserverMode();
+    const auto target = CameraState::GetLocalObserverTarget();
+    record.m_ObserverTarget = target ? target->entindex() : 0;
+
+    record.m_RedScore = teamResource ? teamResource->GetTeamScore(TFTeam::Red) : 0;
+    record.m_BlueScore = teamResource ? teamResource->GetTeamScore(TFTeam::Blue) : 0;
+
+    uint32_t count = 0;
+    for (Player* player : Player::Iterable())
+    {
+        const auto entindex = player->entindex();
+        if (!snapshot.IsValid(entindex))
+            continue;
+
+        PlayerRecord& out = record.m_Players[count++];
+        out.m_EntIndex = entindex;
+        out.m_UserID = player->GetUserID();
+        out.m_Team = Team(snapshot.GetTeam(entindex));
+        out.m_Class = uint8_t(snapshot.GetClass(entindex));
+        out.m_Alive = snapshot.IsAlive(entindex);
+        out.m_Padding = 0;
+        out.m_Health = snapshot.GetHealth(entindex);
+        out.m_MaxHealth = snapshot.GetMaxHealth(entindex);
+        out.m_UberCharge = snapshot.GetUberCharge(entindex);
+
+        if (const auto stats = playerResource ? playerResource->GetStats(entindex) : nullptr)
+        {
+            out.m_Killstreak = stats->m_Killstreaks[0];
+            out.m_Damage = stats->m_Damage;
+        }
+        else
+        {
+            out.m_Killstreak = out.m_Damage = 0;
+        }
+
+        strncpy_s(out.m_Name, player->GetName(), _TRUNCATE);
+
+        if (count >= MAX_FEED_PLAYERS)
+            break;
+    }
+    record.m_PlayerCount = count;
+
+    // Stamped last so the measured latency doesn't include the time spent filling the record
+    record.m_PublishTime = GetTimestamp();
+
+    record.m_Sequence.store(sequence + 2, std::memory_order_release);
+    m_Header->m_PublishCount.store(publishCount + 1, std::memory_order_release);
+}
+
+// Attaches to the feed the same way an external process would: by name, read-only, knowing
+// nothing but the layout header.
+void GameStateFeed::RunBenchmarkReader(Benchmark& benchmark)
+{
+    const HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, benchmark.m_MappingName.c_str());
+    if (!mapping)
+        return;
+
+    const auto header = static_cast<const Header*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(Header)));
+    if (header && IsCompatible(*header))
+    {
+        benchmark.m_Opened = true;
+        benchmark.m_TimerFrequency = header->m_TimerFrequency;
+
+        // Too big for the stack of a thread we didn't size ourselves
+        auto record = std::make_unique<Record>();
+        uint64_t lastPublishCount = header->m_PublishCount.load(std::memory_order_acquire);
+
+        const auto endTime = std::chrono::steady_clock::now() + benchmark.m_Duration;
+        while (std::chrono::steady_clock::now() < endTime && !benchmark.m_Cancel.load(std::memory_order_relaxed))
+        {
+            const auto published = header->m_PublishCount.load(std::memory_order_acquire);
+            if (published == lastPublishCount)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            if (!TryReadLatest(*header, *record, lastPublishCount))
+            {
+                benchmark.m_Retries++;
+                continue;
+            }
+
+            benchmark.m_Reads++;
+            benchmark.m_Latencies.push_back(GetTimestamp() - record->m_PublishTime);
+        }
+    }
+
+    if (header)
+        UnmapViewOfFile(header);
+
+    CloseHandle(mapping);
+}
+
+void GameStateFeed::StartBenchmark(const CCommand& args)
+{
+    if (m_Benchmark)
+    {
+        Warning("%s: A benchmark is already running\n", args[0]);
+        return;
+    }
+
+    if (!m_Header)
+    {
+        Warning("%s: ce_statefeed_enabled must be set to 1\n", args[0]);
+        return;
+    }
+
+    float seconds = 10;
+    if (args.ArgC() > 1 && !TryParseFloat(args[1], seconds))
+    {
+        Warning("Usage: %s [seconds]\n", args[0]);
+        return;
+    }
+
+    if (m_BenchmarkThread.joinable())
+        m_BenchmarkThread.join();
+
+    m_Benchmark = std::make_unique<Benchmark>();
+    m_Benchmark->m_MappingName = ce_statefeed_name.GetString();
+    m_Benchmark->m_Duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(std::clamp(seconds, 1.0f, 300.0f)));
+
+    m_BenchmarkThread = std::thread(
+        [](Benchmark* benchmark)
+        {
+            RunBenchmarkReader(*benchmark);
+            benchmark->m_Done.store(true, std::memory_order_release);
+        },
+        m_Benchmark.get());
+
+    Msg("%s: Reading for %.0f seconds...\n", args[0],
+        std::chrono::duration<float>(m_Benchmark->m_Duration).count());
+}
+
+void GameStateFeed::FinishBenchmark()
+{
+    m_BenchmarkThread.join();
+    const auto benchmark = std::move(m_Benchmark);
+
+    if (!benchmark->m_Opened)
+    {
+        Warning("ce_statefeed_benchmark: Unable to open shared memory \"%s\"\n", benchmark->m_MappingName.c_str());
+        return;
+    }
+
+    auto& latencies = benchmark->m_Latencies;
+    if (latencies.empty())
+    {
+        Warning("ce_statefeed_benchmark: No records were published while the benchmark was running\n");
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    const double toMicroseconds = 1e6 / benchmark->m_TimerFrequency;
+    const auto percentile = [&](double p) { return latencies[size_t((latencies.size() - 1) * p)] * toMicroseconds; };
+
+    int64_t total = 0;
+    for (auto latency : latencies)
+        total += latency;
+
+    Msg("ce_statefeed_benchmark: %llu records read, %llu torn reads retried\n", benchmark->m_Reads,
+        benchmark->m_Retries);
+    Msg("    publish to read latency: min %.1f us, avg %.1f us, p50 %.1f us, p99 %.1f us, max %.1f us\n",
+        latencies.front() * toMicroseconds, double(total) / latencies.size() * toMicroseconds, percentile(0.5),
+        percentile(0.99), latencies.back() * toMicroseconds);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "PluginBase/Modules.h"
+
+#include <convar.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace StateFeed
+{
+    struct Header;
+}
+
+class GameStateFeed final : public Module<GameStateFeed>
+{
+public:
+    GameStateFeed();
+    ~GameStateFeed();
+
+    static constexpr __forceinline const char* GetModuleName() { return "Game State Feed"; }
+
+private:
+    void OnTick(bool inGame) override;
+
+    void UpdateEnabledState();
+    bool OpenMapping();
+    void CloseMapping();
+
+    void Publish(int tick);
+
+    void StartBenchmark(const CCommand& args);
+    void FinishBenchmark();
+    struct Benchmark;
+    static void RunBenchmarkReader(Benchmark& benchmark);
+
+    void* m_MappingHandle = nullptr;
+    StateFeed::Header* m_Header = nullptr;
+    int m_LastPublishedTick = -1;
+
+    std::unique_ptr<Benchmark> m_Benchmark;
+    std::thread m_BenchmarkThread;
+
+    ConVar ce_statefeed_enabled;
+    ConVar ce_statefeed_name;
+    ConCommand ce_statefeed_benchmark;
+};
@@ -9,6 +9,7 @@
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/Player.h"
 #include "PluginBase/TFDefinitions.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include <../materialsystem/itextureinternal.h>
 #include <../materialsystem/texturemanager.h>
@@ -40,6 +41,9 @@ EntityTypeChecker Graphics::s_BuildingType;
 
 static constexpr auto STENCIL_INDEX_MASK = 0xFC;
 
+// Far enough in the past that the infill hurt effects have long since finished
+static constexpr float NEVER_HURT_TIME = -10000;
+
 // Should we use a hook to disable IStudioRender::ForcedMaterialOverride?
 static bool s_DisableForcedMaterialOverride = false;
 
@@ -125,28 +129,22 @@ Graphics::Graphics()
                                      m_ShaderParamsCallbacks),
       ce_graphics_dump_rts("ce_graphics_dump_rts", DumpRTs, "Dump all rendertargets to console."),
 
-      m_PostEffectsHook(std::bind(&Graphics::PostEffectsOverride, this, std::placeholders::_1, std::placeholders::_2,
-                                  std::placeholders::_3, std::placeholders::_4, std::placeholders::_5)),
+      m_PostEffectsHook(this),
 
-      m_ComputePropOpacityHook(
-          std::bind(&Graphics::ComputePropOpacityOverride, this, std::placeholders::_1, std::placeholders::_2)),
-      m_ComputeEntityFadeHook(std::bind(&Graphics::ComputeEntityFadeOveride, this, std::placeholders::_1,
-                                        std::placeholders::_2, std::placeholders::_3, std::placeholders::_4)),
+      m_ComputePropOpacityHook(this),
+      m_ComputeEntityFadeHook(this),
 
-      m_ApplyEntityGlowEffectsHook(std::bind(&Graphics::ApplyEntityGlowEffectsOverride, this, std::placeholders::_1,
-                                             std::placeholders::_2, std::placeholders::_3, std::placeholders::_4,
-                                             std::placeholders::_5, std::placeholders::_6, std::placeholders::_7,
-                                             std::placeholders::_8, std::placeholders::_9)),
+      m_ApplyEntityGlowEffectsHook(this),
 
-      m_ForcedMaterialOverrideHook(
-          std::bind(&Graphics::ForcedMaterialOverrideOverride, this, std::placeholders::_1, std::placeholders::_2)),
+      m_ForcedMaterialOverrideHook(this),
 
-      m_PostDataUpdateHook(
-          std::bind(&Graphics::PostDataUpdateOverride, this, std::placeholders::_1, std::placeholders::_2)),
-      m_ShouldDrawLocalPlayerHook(std::bind(&Graphics::ShouldDrawLocalPlayerOverride, this, std::placeholders::_1))
+      m_PostDataUpdateHook(this),
+      m_ShouldDrawLocalPlayerHook(this)
 {
     ToggleImprovedGlows(&ce_graphics_improved_glows);
     ToggleFixViewmodel(&ce_graphics_fix_viewmodel_particles);
+
+    m_LastHurtTimes.fill(NEVER_HURT_TIME);
 }
 
 bool Graphics::IsDefaultParam(const char* paramName)
@@ -694,25 +692,25 @@ void Graphics::BuildExtraGlowData(CGlowObjectManager* glowMgr, bool& anyAlways,
     anyOccluded = false;
     anyUnoccluded = false;
 
-    bool hasRedOverride, hasBlueOverride;
-    Vector redOverride = ColorToVector(ColorFromConVar(ce_outlines_players_override_red, &hasRedOverride));
-    Vector blueOverride = ColorToVector(ColorFromConVar(ce_outlines_players_override_blue, &hasBlueOverride));
+    const bool hasRedOverride = ce_outlines_players_override_red.HasValue();
+    const bool hasBlueOverride = ce_outlines_players_override_blue.HasValue();
+    const Vector redOverride = ColorToVector(ce_outlines_players_override_red.GetValue());
+    const Vector blueOverride = ColorToVector(ce_outlines_players_override_blue.GetValue());
 
-    bool hasRedBuildingOverride, hasBlueBuildingOverride;
-    Vector redBuildingOverride =
-        ColorToVector(ColorFromConVar(ce_outlines_buildings_override_red, &hasRedBuildingOverride));
-    Vector blueBuildingOverride =
-        ColorToVector(ColorFromConVar(ce_outlines_buildings_override_blue, &hasBlueBuildingOverride));
+    const bool hasRedBuildingOverride = ce_outlines_buildings_override_red.HasValue();
+    const bool hasBlueBuildingOverride = ce_outlines_buildings_override_blue.HasValue();
+    const Vector redBuildingOverride = ColorToVector(ce_outlines_buildings_override_red.GetValue());
+    const Vector blueBuildingOverride = ColorToVector(ce_outlines_buildings_override_blue.GetValue());
 
     uint8_t stencilIndex = 0;
 
     const bool infillsEnable = ce_infills_enable.GetBool();
     const bool bInfillDebug = ce_infills_debug.GetBool();
 
-    const Color redInfillNormal = ColorFromConVar(ce_infills_hurt_red);
-    const Color blueInfillNormal = ColorFromConVar(ce_infills_hurt_blue);
-    const Color redInfillBuffed = ColorFromConVar(ce_infills_buffed_red);
-    const Color blueInfillBuffed = ColorFromConVar(ce_infills_buffed_blue);
+    const Color& redInfillNormal = ce_infills_hurt_red.GetValue();
+    const Color& blueInfillNormal = ce_infills_hurt_blue.GetValue();
+    const Color& redInfillBuffed = ce_infills_buffed_red.GetValue();
+    const Color& blueInfillBuffed = ce_infills_buffed_blue.GetValue();
 
     Frustum_t viewFrustum;
     GeneratePerspectiveFrustum(m_View->origin, m_View->angles, m_View->zNear, m_View->zFar, m_View->fov,
@@ -816,8 +814,9 @@ void Graphics::BuildExtraGlowData(CGlowObjectManager* glowMgr, bool& anyAlways,
                             if (currentExtra.m_StencilIndex >= (1 << 6))
                                 PluginWarning("Ran out of stencil indices for players???");
 
-                            const auto& playerHealth = player->GetHealth();
-                            const auto& playerMaxHealth = player->GetMaxHealth();
+                            const auto& world = WorldSnapshot::Get();
+                            const auto playerHealth = world.GetHealth(player->entindex());
+                            const auto playerMaxHealth = world.GetMaxHealth(player->entindex());
                             const auto healthPercentage = playerHealth / (float)playerMaxHealth;
                             const auto overhealPercentage = RemapValClamped(playerHealth, playerMaxHealth,
                                                                             int(playerMaxHealth * 1.5 / 5) * 5, 0, 1);
@@ -832,9 +831,9 @@ void Graphics::BuildExtraGlowData(CGlowObjectManager* glowMgr, bool& anyAlways,
                                         hurtInfill.m_RectMin.Init();
 
                                     hurtInfill.m_Color = team == TFTeam::Red ? redInfillNormal : blueInfillNormal;
+                                    // Infill fading/flickering
                                     hurtInfill.m_Color.a() *=
-                                        ApplyInfillTimeEffects(player->GetState<PlayerHealthState>()
-                                                                   .GetLastHurtTime()); // Infill fading/flickering
+                                        ApplyInfillTimeEffects(GetTimeSinceHurt(player->entindex()));
 
                                     hurtInfill.m_RectMax.Init(bInfillDebug ? screenMaxs.x : m_View->width,
                                                               Lerp(healthPercentage, screenMaxs.y, screenMins.y));
@@ -1092,10 +1091,23 @@ void Graphics::DrawInfills(CMatRenderContextPtr& pRenderContext)
     pRenderContext->PopMatrix();
 }
 
-void Graphics::ResetPlayerHurtTimes()
+void Graphics::ResetPlayerHurtTimes() { m_LastHurtTimes.fill(Interfaces::GetEngineTool()->ClientTime()); }
+
+void Graphics::UpdateLastHurtTimes()
+{
+    const auto& world = WorldSnapshot::Get();
+    for (const auto& delta : world.GetDeltas())
+    {
+        if (delta.m_Type == WorldSnapshot::DeltaType::PlayerAdded)
+            m_LastHurtTimes[delta.m_PlayerIndex - 1] = NEVER_HURT_TIME;
+        else if (delta.m_Type == WorldSnapshot::DeltaType::HealthChanged && delta.m_NewValue < delta.m_OldValue)
+            m_LastHurtTimes[delta.m_PlayerIndex - 1] = Interfaces::GetEngineTool()->ClientTime();
+    }
+}
+
+float Graphics::GetTimeSinceHurt(int entindex) const
 {
-    for (Player* player : Player::Iterable())
-        player->GetState<PlayerHealthState>().ResetLastHurtTime();
+    return Interfaces::GetEngineTool()->ClientTime() - m_LastHurtTimes[entindex - 1];
 }
 
 void Graphics::BuildMoveChildLists()
@@ -1683,6 +1695,8 @@ void Graphics::OnTick(bool inGame)
     if (!Interfaces::GetEngineClient()->IsInGame())
         return;
 
+    UpdateLastHurtTimes();
+
     if (ce_graphics_fix_invisible_players.GetBool())
     {
         for (Player* p : Player::Iterable())
@@ -1736,24 +1750,3 @@ void Graphics::ExtraGlowData::ApplyGlowColor() const
         render->SetColorModulation(m_Base->m_vGlowColor.Base());
     }
 }
-
-float Graphics::PlayerHealthState::GetLastHurtTime() const
-{
-    return Interfaces::GetEngineTool()->ClientTime() - m_LastHurtTime;
-}
-
-void Graphics::PlayerHealthState::ResetLastHurtTime() { m_LastHurtTime = Interfaces::GetEngineTool()->ClientTime(); }
-
-void Graphics::PlayerHealthState::UpdateInternal(bool tickUpdate, bool frameUpdate)
-{
-    if (!tickUpdate)
-        return;
-
-    auto health = GetPlayer().GetHealth();
-
-    // Update last hurt time
-    if (health < m_LastHurtHealth)
-        m_LastHurtTime = Interfaces::GetEngineTool()->ClientTime();
-
-    m_LastHurtHealth = health;
-}
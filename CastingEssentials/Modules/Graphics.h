@@ -5,7 +5,7 @@
 #include "PluginBase/EntityOffset.h"
 #include "PluginBase/Hook.h"
 #include "PluginBase/Modules.h"
-#include "PluginBase/PlayerStateBase.h"
+#include "PluginBase/TypedConVar.h"
 
 #include <client/glow_outline_effect.h>
 
@@ -46,10 +46,10 @@ private:
     ConVar ce_graphics_fxaa;
     ConVar ce_graphics_fxaa_debug;
 
-    ConVar ce_outlines_players_override_red;
-    ConVar ce_outlines_players_override_blue;
-    ConVar ce_outlines_buildings_override_red;
-    ConVar ce_outlines_buildings_override_blue;
+    TypedConVar<Color> ce_outlines_players_override_red;
+    TypedConVar<Color> ce_outlines_players_override_blue;
+    TypedConVar<Color> ce_outlines_buildings_override_red;
+    TypedConVar<Color> ce_outlines_buildings_override_blue;
     ConVar ce_outlines_blur;
     ConVar ce_outlines_expand;
     ConVar ce_outlines_debug_stencil_out;
@@ -62,11 +62,11 @@ private:
     ConVar ce_infills_enable;
     ConVar ce_infills_additive;
     ConVar ce_infills_debug;
-    ConVar ce_infills_hurt_red;
-    ConVar ce_infills_hurt_blue;
+    TypedConVar<Color> ce_infills_hurt_red;
+    TypedConVar<Color> ce_infills_hurt_blue;
     // ConVar* ce_infills_normal_direction;
-    ConVar ce_infills_buffed_red;
-    ConVar ce_infills_buffed_blue;
+    TypedConVar<Color> ce_infills_buffed_red;
+    TypedConVar<Color> ce_infills_buffed_blue;
     // ConVar* ce_infills_buffed_direction;
 
     ConVar ce_infills_flicker_hertz;
@@ -87,31 +87,35 @@ private:
     static void DumpRTs(const CCommand& cmd);
 
     void ToggleFXAA(const ConVar* var);
-    Hook<HookFunc::CViewRender_PerformScreenSpaceEffects> m_PostEffectsHook;
     void PostEffectsOverride(CViewRender* pThis, int x, int y, int w, int h);
+    Hook<HookFunc::CViewRender_PerformScreenSpaceEffects, &Graphics::PostEffectsOverride> m_PostEffectsHook;
     void DrawFXAA(int x, int y, int w, int h);
 
-    Hook<HookFunc::IStaticPropMgrClient_ComputePropOpacity> m_ComputePropOpacityHook;
-    Hook<HookFunc::Global_UTILComputeEntityFade> m_ComputeEntityFadeHook;
     void TogglePropFade(const ConVar* var);
     void ComputePropOpacityOverride(const Vector& viewOrigin, float factor);
     unsigned char ComputeEntityFadeOveride(C_BaseEntity* entity, float minDist, float maxDist, float fadeScale);
+    Hook<HookFunc::IStaticPropMgrClient_ComputePropOpacity, &Graphics::ComputePropOpacityOverride>
+        m_ComputePropOpacityHook;
+    Hook<HookFunc::Global_UTILComputeEntityFade, &Graphics::ComputeEntityFadeOveride> m_ComputeEntityFadeHook;
 
-    Hook<HookFunc::CGlowObjectManager_ApplyEntityGlowEffects> m_ApplyEntityGlowEffectsHook;
     void ToggleImprovedGlows(const ConVar* var);
     void ApplyEntityGlowEffectsOverride(CGlowObjectManager* pThis, const CViewSetup* pSetup, int nSplitScreenSlot,
                                         CMatRenderContextPtr& pRenderContext, float flBloomScale, int x, int y, int w,
                                         int h);
+    Hook<HookFunc::CGlowObjectManager_ApplyEntityGlowEffects, &Graphics::ApplyEntityGlowEffectsOverride>
+        m_ApplyEntityGlowEffectsHook;
 
-    Hook<HookFunc::IStudioRender_ForcedMaterialOverride> m_ForcedMaterialOverrideHook;
     void ForcedMaterialOverrideOverride(IMaterial* material, OverrideType_t overrideType);
+    Hook<HookFunc::IStudioRender_ForcedMaterialOverride, &Graphics::ForcedMaterialOverrideOverride>
+        m_ForcedMaterialOverrideHook;
 
-    Hook<HookFunc::C_BasePlayer_ShouldDrawThisPlayer> m_ShouldDrawLocalPlayerHook;
-    Hook<HookFunc::C_TFWeaponBase_PostDataUpdate> m_PostDataUpdateHook;
-    C_BaseEntity* m_LocalOwner{nullptr};
     void ToggleFixViewmodel(const ConVar* var);
     void PostDataUpdateOverride(IClientNetworkable* pThis, int updateType);
     bool ShouldDrawLocalPlayerOverride(C_BasePlayer* pThis);
+    Hook<HookFunc::C_BasePlayer_ShouldDrawThisPlayer, &Graphics::ShouldDrawLocalPlayerOverride>
+        m_ShouldDrawLocalPlayerHook;
+    Hook<HookFunc::C_TFWeaponBase_PostDataUpdate, &Graphics::PostDataUpdateOverride> m_PostDataUpdateHook;
+    C_BaseEntity* m_LocalOwner{nullptr};
 
     void DrawGlowAlways(int nSplitScreenSlot, CMatRenderContextPtr& pRenderContext) const;
     void DrawGlowOccluded(int nSplitScreenSlot, CMatRenderContextPtr& pRenderContext) const;
@@ -141,21 +145,10 @@ private:
         Vector2D m_RectMax = Vector2D(-1, -1);
     };
 
-    class PlayerHealthState : public PlayerStateBase
-    {
-    public:
-        PlayerHealthState(Player& player) : PlayerStateBase(player) {}
-
-        void ResetLastHurtTime();
-        float GetLastHurtTime() const;
-
-    protected:
-        void UpdateInternal(bool tickUpdate, bool frameUpdate) override;
-
-    private:
-        float m_LastHurtTime;
-        int m_LastHurtHealth;
-    };
+    // ClientTime() each player last lost health, indexed by entindex - 1
+    std::array<float, MAX_PLAYERS> m_LastHurtTimes;
+    void UpdateLastHurtTimes();
+    float GetTimeSinceHurt(int entindex) const;
 
     friend class CGlowObjectManager;
     struct ExtraGlowData
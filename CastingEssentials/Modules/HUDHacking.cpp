@@ -8,6 +8,7 @@
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/Player.h"
 #include "PluginBase/TFDefinitions.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include <KeyValues.h>
 #include <client/c_basecombatweapon.h>
@@ -145,8 +146,7 @@ HUDHacking::HUDHacking()
           "Runs PlayerPanel_ClassChangedRed/Blue hudanims on the playerpanels whenever a player changes class."),
 
       m_ApplySettingsHook(std::bind(ProgressBarApplySettingsHook, std::placeholders::_1, std::placeholders::_2)),
-      m_FindChildByNameHook(std::bind(&HUDHacking::FindChildByNameOverride, this, std::placeholders::_1,
-                                      std::placeholders::_2, std::placeholders::_3))
+      m_FindChildByNameHook(this)
 {
     for (int i = 0; i < (int)ChargeBarType::COUNT; i++)
         m_ChargeBarCvars[i].emplace(s_ChargeBarInfo[i]);
@@ -670,7 +670,7 @@ void HUDHacking::UpdateClassChangeAnimations(vgui::VPANEL playerVPanel, vgui::Ed
 
     const auto team = player.GetTeam();
 
-    if (player.GetState<PlayerState>().WasClassChangedThisFrame())
+    if (WorldSnapshot::Get().HasChanged(player.entindex(), WorldSnapshot::DeltaType::ClassChanged))
     {
         auto startAnimSequence = HookManager::GetRawFunc<HookFunc::vgui_AnimationController_StartAnimationSequence>();
         startAnimSequence(
@@ -784,10 +784,15 @@ void HUDHacking::ForwardPlayerPanelBorder(vgui::VPANEL playerVPanel, vgui::Edita
 
 void HUDHacking::UpdatePlayerHealth(vgui::VPANEL playerVPanel, vgui::EditablePanel* playerPanel, const Player& player)
 {
-    const auto health = player.IsAlive() ? player.GetHealth() : 0;
-    const auto maxHealth = player.GetMaxHealth();
+    const auto& world = WorldSnapshot::Get();
+    const auto entindex = player.entindex();
+    if (!world.IsValid(entindex))
+        return;
+
+    const auto health = world.IsAlive(entindex) ? world.GetHealth(entindex) : 0;
+    const auto maxHealth = world.GetMaxHealth(entindex);
     const auto healthProgress = std::min<float>(1, health / (float)maxHealth);
-    const auto overhealProgress = RemapValClamped(health, maxHealth, player.GetMaxOverheal(), 0, 1);
+    const auto overhealProgress = RemapValClamped(health, maxHealth, Player::GetMaxOverheal(maxHealth), 0, 1);
 
     struct ProgressBarName
     {
@@ -813,7 +818,7 @@ void HUDHacking::UpdatePlayerHealth(vgui::VPANEL playerVPanel, vgui::EditablePan
         ProgressBarName("PlayerHealthOverhealBlue", TFTeam::Blue, true, false),
         ProgressBarName("PlayerHealthInverseOverhealBlue", TFTeam::Blue, true, true)};
 
-    const auto team = player.GetTeam();
+    const auto team = world.GetTeam(entindex);
 
     // Show/hide progress bars
     for (const auto& bar : s_ProgressBars)
@@ -871,11 +876,6 @@ vgui::Panel* HUDHacking::FindChildByNameOverride(vgui::Panel* pThis, const char*
     return m_FindChildByNameHook.GetOriginal()(pThis, name, recurseDown);
 }
 
-bool HUDHacking::PlayerState::WasClassChangedThisFrame() const
-{
-    return Interfaces::GetEngineTool()->HostFrameCount() == m_LastClassChangedFrame;
-}
-
 float HUDHacking::PlayerState::GetCleanersCarbineCharge() const
 {
     if (m_CleanersCarbineEmptyTime > 0)
@@ -890,21 +890,7 @@ float HUDHacking::PlayerState::GetCleanersCarbineCharge() const
 void HUDHacking::PlayerState::UpdateInternal(bool tickUpdate, bool frameUpdate)
 {
     if (tickUpdate)
-    {
-        UpdateClass();
         UpdateCleanersCarbineMeter();
-    }
-}
-
-void HUDHacking::PlayerState::UpdateClass()
-{
-    auto playerClass = GetPlayer().GetClass();
-
-    // Update last class changed frame
-    if (playerClass != m_LastClassChangedClass)
-        m_LastClassChangedFrame = Interfaces::GetEngineTool()->HostFrameCount();
-
-    m_LastClassChangedClass = playerClass;
 }
 
 void HUDHacking::PlayerState::UpdateCleanersCarbineMeter()
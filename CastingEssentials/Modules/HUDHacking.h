@@ -195,7 +195,6 @@ private:
     {
     public:
         PlayerState(Player& player) : PlayerStateBase(player) {}
-        bool WasClassChangedThisFrame() const;
 
         float GetCleanersCarbineCharge() const;
 
@@ -203,15 +202,11 @@ private:
         void UpdateInternal(bool tickUpdate, bool frameUpdate) override;
 
     private:
-        void UpdateClass();
         void UpdateCleanersCarbineMeter();
 
         static constexpr float CLEANERS_CARBINE_DURATION = 8;
         float m_LastCleanersCarbineCharge = 0;
         float m_CleanersCarbineEmptyTime = 0;
-
-        int m_LastClassChangedFrame;
-        TFClassType m_LastClassChangedClass;
     };
 
     ConVar ce_hud_statistics_enabled;
@@ -251,8 +246,8 @@ private:
     Hook<HookFunc::vgui_ProgressBar_ApplySettings> m_ApplySettingsHook;
     static void ProgressBarApplySettingsHook(vgui::ProgressBar* pThis, KeyValues* pSettings);
 
-    Hook<HookFunc::vgui_Panel_FindChildByName> m_FindChildByNameHook;
     vgui::Panel* FindChildByNameOverride(vgui::Panel* pThis, const char* name, bool recurseDown);
+    Hook<HookFunc::vgui_Panel_FindChildByName, &HUDHacking::FindChildByNameOverride> m_FindChildByNameHook;
 
     static vgui::AnimationController* GetAnimationController();
 
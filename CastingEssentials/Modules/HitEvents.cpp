@@ -14,31 +14,37 @@
 
 #include <sstream>
 
-MODULE_REGISTER(HitEvents);
+MODULE_REGISTER_LAZY(HitEvents);
+
+ConVar HitEvents::ce_hitevents_enabled(
+    "ce_hitevents_enabled", "0", FCVAR_NONE, "Enables hitsounds and damage numbers in STVs.",
+    [](IConVar* var, const char*, float)
+    {
+        Modules().UpdateLazyModule<HitEvents>(static_cast<ConVar*>(var)->GetBool(),
+                                              [](HitEvents* module) { module->UpdateEnabledState(); });
+    });
+ConVar HitEvents::ce_hitevents_dmgnumbers_los("ce_hitevents_dmgnumbers_los", "1", FCVAR_NONE,
+                                              "Should we require LOS to the target before showing a damage number? "
+                                              "For a \"normal\" TF2 experience, this would be set to 1.");
+ConVar HitEvents::ce_hitevents_healing_crossbow_only(
+    "ce_hitevents_healing_crossbow_only", "0", FCVAR_NONE,
+    "Only show healing events originating from the Crusader's Crossbow.");
 
 HitEvents::HitEvents()
-    : ce_hitevents_enabled(
-          "ce_hitevents_enabled", "0", FCVAR_NONE, "Enables hitsounds and damage numbers in STVs.",
-          [](IConVar* var, const char* oldValue, float fOldValue) { GetModule()->UpdateEnabledState(); }),
-      ce_hitevents_dmgnumbers_los("ce_hitevents_dmgnumbers_los", "1", FCVAR_NONE,
-                                  "Should we require LOS to the target before showing a damage number? For a "
-                                  "\"normal\" TF2 experience, this would be set to 1."),
-      ce_hitevents_healing_crossbow_only("ce_hitevents_healing_crossbow_only", "0", FCVAR_NONE,
-                                         "Only show healing events originating from the Crusader's Crossbow."),
-
-      m_FireGameEventHook(
-          std::bind(&HitEvents::FireGameEventOverride, this, std::placeholders::_1, std::placeholders::_2)),
-
-      m_UTILTracelineHook(std::bind(&HitEvents::UTILTracelineOverride, this, std::placeholders::_1,
-                                    std::placeholders::_2, std::placeholders::_3, std::placeholders::_4,
-                                    std::placeholders::_5, std::placeholders::_6)),
-
-      m_DamageAccountPanelShouldDrawHook(
-          std::bind(&HitEvents::DamageAccountPanelShouldDrawOverride, this, std::placeholders::_1))
+    : m_FireGameEventHook(this),
+
+      m_UTILTracelineHook(this),
+
+      m_DamageAccountPanelShouldDrawHook(this)
 {
     m_OverrideUTILTraceline = false;
 
     m_LastDamageAccount = nullptr;
+
+    auto router = GetGameEventRouter();
+    m_PlayerHurtEvent = router->GetEventID("player_hurt");
+    m_PlayerHealedEvent = router->GetEventID("player_healed");
+    m_CrossbowHealEvent = router->GetEventID("crossbow_heal");
 }
 
 class CAccountPanel : public vgui::EditablePanel
@@ -142,7 +148,6 @@ void HitEvents::LevelInit()
 void HitEvents::LevelShutdown()
 {
     UpdateEnabledState();
-    m_EventsToIgnore.clear();
     m_Panel = nullptr;
 }
 
@@ -156,21 +161,21 @@ void HitEvents::UpdateEnabledState()
 
 void HitEvents::FireGameEventOverride(CDamageAccountPanel* pThis, IGameEvent* event)
 {
-
-    if (auto it = std::find(m_EventsToIgnore.cbegin(), m_EventsToIgnore.cend(), event); it != m_EventsToIgnore.cend())
+    auto router = GetGameEventRouter();
+    if (router->IsInjectedEvent(event, this))
     {
         // We injected this event ourselves, ignore it.
         m_FireGameEventHook.SetState(Hooking::HookAction::SUPERCEDE);
-        m_EventsToIgnore.erase(it);
         return;
     }
 
-    auto is_player_hurt = stricmp(event->GetName(), "player_hurt") == 0;
+    const auto eventID = router->GetEventID(event);
+    auto is_player_hurt = eventID == m_PlayerHurtEvent;
 
     auto crossbow_only = ce_hitevents_healing_crossbow_only.GetBool();
 
-    auto is_player_healed = !crossbow_only && !is_player_hurt && stricmp(event->GetName(), "player_healed") == 0;
-    auto is_crossbow = !is_player_healed && crossbow_only && stricmp(event->GetName(), "crossbow_heal") == 0;
+    auto is_player_healed = !crossbow_only && eventID == m_PlayerHealedEvent;
+    auto is_crossbow = crossbow_only && eventID == m_CrossbowHealEvent;
 
     if (is_player_hurt || is_player_healed || is_crossbow)
     {
@@ -227,9 +232,8 @@ void HitEvents::FireGameEventOverride(CDamageAccountPanel* pThis, IGameEvent* ev
         if (is_player_hurt)
         {
             // We re-inject player hurt events with the updated info so that stuff like "crit!" sprites will show up.
-            m_EventsToIgnore.push_back(newEvent.get());
-            gameeventmanager->FireEventClientSide(
-                newEvent.release()); // We need to release ownership here as FireEventClientSide will free the event!
+            // We need to release ownership here as FireEventClientSide will free the event!
+            router->FireInjectedEvent(newEvent.release(), this);
         }
     }
     else
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "PluginBase/GameEventRouter.h"
 #include "PluginBase/Hook.h"
 #include "PluginBase/Modules.h"
 
@@ -7,8 +8,6 @@
 #include <igameevents.h>
 #include <shareddefs.h>
 
-#include <vector>
-
 class C_BaseCombatCharacter;
 class CAccountPanel;
 class CDamageAccountPanel;
@@ -29,9 +28,12 @@ protected:
     void LevelShutdown() override;
 
 private:
-    std::vector<IGameEvent*> m_EventsToIgnore;
     CDamageAccountPanel* m_Panel{nullptr};
 
+    GameEventRouter::EventID m_PlayerHurtEvent;
+    GameEventRouter::EventID m_PlayerHealedEvent;
+    GameEventRouter::EventID m_CrossbowHealEvent;
+
     void UpdateEnabledState();
 
     void FireGameEventOverride(CDamageAccountPanel* pThis, IGameEvent* event);
@@ -42,13 +44,14 @@ private:
 
     bool DamageAccountPanelShouldDrawOverride(CDamageAccountPanel* pThis);
 
-    Hook<HookFunc::CDamageAccountPanel_FireGameEvent> m_FireGameEventHook;
-    Hook<HookFunc::Global_UTIL_TraceLine> m_UTILTracelineHook;
-    Hook<HookFunc::CDamageAccountPanel_ShouldDraw> m_DamageAccountPanelShouldDrawHook;
+    Hook<HookFunc::CDamageAccountPanel_FireGameEvent, &HitEvents::FireGameEventOverride> m_FireGameEventHook;
+    Hook<HookFunc::Global_UTIL_TraceLine, &HitEvents::UTILTracelineOverride> m_UTILTracelineHook;
+    Hook<HookFunc::CDamageAccountPanel_ShouldDraw, &HitEvents::DamageAccountPanelShouldDrawOverride>
+        m_DamageAccountPanelShouldDrawHook;
 
     CAccountPanel* m_LastDamageAccount;
 
-    ConVar ce_hitevents_enabled;
-    ConVar ce_hitevents_dmgnumbers_los;
-    ConVar ce_hitevents_healing_crossbow_only;
+    static ConVar ce_hitevents_enabled;
+    static ConVar ce_hitevents_dmgnumbers_los;
+    static ConVar ce_hitevents_healing_crossbow_only;
 };
\ No newline at end of file
@@ -1,11 +1,13 @@
 #include "ItemSchema.h"
 #include "PluginBase/Interfaces.h"
+#include "PluginBase/StartupTasks.h"
 
 #include <KeyValues.h>
 #include <filesystem.h>
 #include <utlbuffer.h>
 
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 // dumb macro names
@@ -21,6 +23,9 @@ ItemSchema::ItemSchema()
       ce_itemschema_reload(
           "ce_itemschema_reload", []() { GetModule()->LoadItemSchema(); }, "Reloads the item schema module.")
 {
+    // Parse items_game.txt while the rest of the plugin loads, rather than stalling the first level load
+    if (auto startup = StartupTasks::GetCurrent())
+        startup->Launch("Item schema parsing", [this]() { m_LoadedAtStartup = LoadItemSchema(); });
 }
 
 void ItemSchema::PrintAliases()
@@ -63,7 +68,13 @@ void ItemSchema::PrintAliases()
     }
 }
 
-void ItemSchema::LevelInit() { LoadItemSchema(); }
+void ItemSchema::LevelInit()
+{
+    if (std::exchange(m_LoadedAtStartup, false))
+        return;
+
+    LoadItemSchema();
+}
 
 bool ItemSchema::CheckDependencies()
 {
@@ -90,7 +101,7 @@ int ItemSchema::GetBaseItemID(int specializedID) const
 
 #pragma warning(push)
 #pragma warning(disable : 4706) // Assignment within conditional expression
-void ItemSchema::LoadItemSchema()
+bool ItemSchema::LoadItemSchema()
 {
     m_PrefabsLinked = false;
 
@@ -100,7 +111,7 @@ void ItemSchema::LoadItemSchema()
     if (!basekv->LoadFromFile(Interfaces::GetFileSystem(), FILENAME))
     {
         PluginWarning("Failed to load %s for module %s!\n", FILENAME, GetModuleName());
-        return;
+        return false;
     }
 
     LoadPrefabs(basekv->FindKey("prefabs"));
@@ -132,7 +143,7 @@ void ItemSchema::LoadItemSchema()
         }
     }
 
-    return;
+    return true;
 }
 #pragma warning(pop)
 
@@ -559,7 +570,7 @@ void ItemSchema::LoadOverrides(const std::forward_list<ItemEntry>& items)
     if (!basekv->LoadFromFile(Interfaces::GetFileSystem(), FILENAME))
     {
         PluginWarning("Failed to load %s for module %s!\n", FILENAME, GetModuleName());
-        return;
+        return false;
     }
 
     m_Remaps.clear();
@@ -33,7 +33,8 @@ private:
     void PrintAliases();
 
     void LevelInit() override;
-    void LoadItemSchema();
+    bool LoadItemSchema();
+    bool m_LoadedAtStartup = false; // Only if the startup load succeeded, otherwise LevelInit tries again
 
     static void GetFirstPrefabType(const char* prefabsGroup, char* prefabOut, size_t maxOutSize);
     int GetFirstItemUsingPrefab(KeyValues* items, const char* prefabName);
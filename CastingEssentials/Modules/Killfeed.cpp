@@ -7,9 +7,6 @@
 #include <igameevents.h>
 #include <vprof.h>
 
-#include <codecvt>
-#include <locale>
-
 MODULE_REGISTER(Killfeed);
 
 Killfeed::Killfeed()
@@ -18,6 +15,7 @@ Killfeed::Killfeed()
           "Continually updates the killfeed background/icons based on the local player index.")
 {
     m_DeathNoticePanel = nullptr;
+    m_LastLocalPlayerIndex = -1;
 }
 
 Killfeed::DeathNoticePanelOverride* Killfeed::FindDeathNoticePanel()
@@ -43,6 +41,15 @@ Killfeed::DeathNoticePanelOverride* Killfeed::FindDeathNoticePanel()
     return nullptr;
 }
 
+void Killfeed::LevelInit()
+{
+    m_ProcessedNotices.clear();
+    m_IconPairs.clear();
+    m_LastLocalPlayerIndex = -1;
+}
+
+void Killfeed::LevelShutdown() { LevelInit(); }
+
 void Killfeed::OnTick(bool inGame)
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
@@ -50,7 +57,11 @@ void Killfeed::OnTick(bool inGame)
         return;
 
     if (!ce_killfeed_continuous_update.GetBool())
+    {
+        m_ProcessedNotices.clear();
+        m_LastLocalPlayerIndex = -1;
         return;
+    }
 
     if (!m_DeathNoticePanel)
     {
@@ -63,96 +74,144 @@ void Killfeed::OnTick(bool inGame)
 
     // static_assert(sizeof(DeathNoticeItem) == 408, "sizeof(DeathNoticeItem) doesn't match TF2!");
 
+    SyncProcessedNotices();
+
+    // Everything we've already processed is still correct unless the local player changed, in which case we only
+    // need to re-apply the cached state. Otherwise, only the notices that were just appended need fixing up.
     auto const localPlayerIndex = GetHooks()->GetRawFunc<HookFunc::Global_GetLocalPlayerIndex>()();
+    const size_t firstNew = localPlayerIndex != m_LastLocalPlayerIndex ? 0 : m_ProcessedNotices.size();
+    m_LastLocalPlayerIndex = localPlayerIndex;
+
+    if (firstNew >= (size_t)m_DeathNotices->Count())
+        return; // Nothing changed
+
     Player* localPlayer = Player::GetPlayer(localPlayerIndex, __FUNCSIG__);
-    auto const localPlayerUserID = localPlayer->GetUserID();
+    auto const localPlayerUserID = localPlayer ? localPlayer->GetUserID() : -1;
 
-    for (int i = 0; i < m_DeathNotices->Count(); i++)
+    m_ProcessedNotices.resize(m_DeathNotices->Count(), ProcessedNotice{-1, -1, -1, 0});
+    for (size_t i = firstNew; i < m_ProcessedNotices.size(); i++)
     {
         DeathNoticeItem& current = m_DeathNotices->Element(i);
+        auto& processed = m_ProcessedNotices[i];
 
-        current.bLocalPlayerInvolved = false;
+        if (!processed.Matches(current))
+        {
+            processed.m_KillerID = current.iKillerID;
+            processed.m_VictimID = current.iVictimID;
+            processed.m_CreationTime = current.flCreationTime;
+            processed.m_AssisterIndex = FindAssisterIndex(current);
+        }
 
-        Player* killer = Player::GetPlayerFromUserID(current.iKillerID);
-        if (!killer)
-            continue;
+        ApplyNotice(current, processed, localPlayerIndex, localPlayerUserID);
+    }
+}
 
-        const std::string& killerName = killer->GetName();
-        if (!killerName.empty())
+void Killfeed::SyncProcessedNotices()
+{
+    const auto count = m_DeathNotices->Count();
+    if (count < 1)
+    {
+        m_ProcessedNotices.clear();
+        return;
+    }
+
+    // Drop anything that expired off the front of the list
+    const auto& first = m_DeathNotices->Element(0);
+    size_t expired = 0;
+    while (expired < m_ProcessedNotices.size() && !m_ProcessedNotices[expired].Matches(first))
+        expired++;
+
+    m_ProcessedNotices.erase(m_ProcessedNotices.begin(), m_ProcessedNotices.begin() + expired);
+
+    // The remaining notices should line up exactly, if they don't something other than expiration/appending happened
+    if (m_ProcessedNotices.size() > (size_t)count)
+    {
+        m_ProcessedNotices.clear();
+        return;
+    }
+
+    for (size_t i = 1; i < m_ProcessedNotices.size(); i++)
+    {
+        if (!m_ProcessedNotices[i].Matches(m_DeathNotices->Element(i)))
         {
-            auto const killerNameLength = killerName.size();
-            std::string killerAndAssisterName = current.Killer.szName; // "Killer + Assister"
-            killerAndAssisterName.erase(0, killerNameLength);
-
-            // Now we should just have " + Assister"
-            static constexpr const char plus[] = " + ";
-            if (!strncmp(plus, killerAndAssisterName.c_str(), arraysize(plus) - 1))
-            {
-                // We started with " + ", so remove it
-                killerAndAssisterName.erase(0, 3);
-
-                // Now we should just have "Assister", try to find a player with that name
-                for (Player* assister : Player::Iterable())
-                {
-                    if (!strcmp(assister->GetName(), killerAndAssisterName.c_str()))
-                    {
-                        // Matches our local player
-                        if (assister->entindex() == localPlayerIndex)
-                            current.bLocalPlayerInvolved = true;
-
-                        break;
-                    }
-                }
-            }
+            m_ProcessedNotices.clear();
+            return;
         }
+    }
+}
 
-        current.bLocalPlayerInvolved = current.bLocalPlayerInvolved || current.iKillerID == localPlayerUserID ||
-                                       current.iVictimID == localPlayerUserID;
+int Killfeed::FindAssisterIndex(const DeathNoticeItem& item)
+{
+    Player* killer = Player::GetPlayerFromUserID(item.iKillerID);
+    if (!killer)
+        return 0;
+
+    const char* killerName = killer->GetName();
+    const auto killerNameLength = killerName ? strlen(killerName) : 0;
+    if (!killerNameLength || strncmp(item.Killer.szName, killerName, killerNameLength))
+        return 0;
+
+    // Now we should just have " + Assister"
+    const char* assisterName = item.Killer.szName + killerNameLength;
+    static constexpr const char plus[] = " + ";
+    if (strncmp(plus, assisterName, arraysize(plus) - 1))
+        return 0;
+
+    // We started with " + ", so skip it. Now we should just have "Assister", try to find a player with that name
+    assisterName += arraysize(plus) - 1;
+    if (Player* assister = Player::GetPlayerFromName(assisterName))
+        return assister->entindex();
+
+    return 0;
+}
+
+CHudTexture* Killfeed::GetIcon(CHudTexture* texture, EDeathNoticeIconFormat fmt)
+{
+    if (!texture)
+        return nullptr;
 
+    auto found = m_IconPairs.find(texture);
+    if (found == m_IconPairs.end())
+    {
         auto const GetIcon = GetHooks()->GetRawFunc<HookFunc::CHudBaseDeathNotice_GetIcon>();
 
-        const EDeathNoticeIconFormat fmt = current.bLocalPlayerInvolved
-                                               ? EDeathNoticeIconFormat::kDeathNoticeIcon_Inverted
-                                               : EDeathNoticeIconFormat::kDeathNoticeIcon_Standard;
-
-        auto const GetUpdatedIcon = [&](CHudTexture* texture) -> CHudTexture* {
-            if (!texture)
-                return nullptr;
-
-            bool updated = false;
-            char buffer[256]; // 256 is used internally by CHudBaseDeathNotice::GetIcon
-
-            if (fmt == EDeathNoticeIconFormat::kDeathNoticeIcon_Inverted)
-            {
-                if (!strncmp(texture->szShortName, "d_", 2))
-                {
-                    strcpy(buffer, "dneg_");
-                    strcpy(buffer + 5, texture->szShortName + 2);
-                    updated = true;
-                }
-            }
-            else
-            {
-                if (!strncmp(texture->szShortName, "dneg_", 5))
-                {
-                    strcpy(buffer, "d_");
-                    strcpy(buffer + 2, texture->szShortName + 5);
-                    updated = true;
-                }
-            }
-
-            if (updated)
-                return GetIcon(buffer, EDeathNoticeIconFormat::kDeathNoticeIcon_Standard); // I'm lazy
-            else
-                return texture;
-        };
-
-        current.iconDeath = GetUpdatedIcon(current.iconDeath);
-        current.iconCritDeath = GetUpdatedIcon(current.iconCritDeath);
-        current.iconPostKillerName = GetUpdatedIcon(current.iconPostKillerName);
-        current.iconPostVictimName = GetUpdatedIcon(current.iconPostVictimName);
-        current.iconPreKillerName = GetUpdatedIcon(current.iconPreKillerName);
-
-        // GetHooks()->GetFunc<CHudBaseDeathNotice_GetIcon>()()
+        IconPair pair{texture, texture};
+        char buffer[256]; // 256 is used internally by CHudBaseDeathNotice::GetIcon
+        if (!strncmp(texture->szShortName, "d_", 2))
+        {
+            sprintf_s(buffer, "dneg_%s", texture->szShortName + 2);
+            if (auto inverted = GetIcon(buffer, EDeathNoticeIconFormat::kDeathNoticeIcon_Standard)) // I'm lazy
+                pair.m_Inverted = inverted;
+        }
+        else if (!strncmp(texture->szShortName, "dneg_", 5))
+        {
+            sprintf_s(buffer, "d_%s", texture->szShortName + 5);
+            if (auto standard = GetIcon(buffer, EDeathNoticeIconFormat::kDeathNoticeIcon_Standard))
+                pair.m_Standard = standard;
+        }
+
+        // Register both sides so swapping back and forth never has to go through GetIcon again
+        m_IconPairs.emplace(pair.m_Standard, pair);
+        found = m_IconPairs.emplace(pair.m_Inverted, pair).first;
     }
-}
\ No newline at end of file
+
+    return fmt == EDeathNoticeIconFormat::kDeathNoticeIcon_Inverted ? found->second.m_Inverted
+                                                                     : found->second.m_Standard;
+}
+
+void Killfeed::ApplyNotice(DeathNoticeItem& current, const ProcessedNotice& processed, int localPlayerIndex,
+                           int localPlayerUserID)
+{
+    current.bLocalPlayerInvolved = (processed.m_AssisterIndex && processed.m_AssisterIndex == localPlayerIndex) ||
+                                   current.iKillerID == localPlayerUserID || current.iVictimID == localPlayerUserID;
+
+    const EDeathNoticeIconFormat fmt = current.bLocalPlayerInvolved
+                                           ? EDeathNoticeIconFormat::kDeathNoticeIcon_Inverted
+                                           : EDeathNoticeIconFormat::kDeathNoticeIcon_Standard;
+
+    current.iconDeath = GetIcon(current.iconDeath, fmt);
+    current.iconCritDeath = GetIcon(current.iconCritDeath, fmt);
+    current.iconPostKillerName = GetIcon(current.iconPostKillerName, fmt);
+    current.iconPostVictimName = GetIcon(current.iconPostVictimName, fmt);
+    current.iconPreKillerName = GetIcon(current.iconPreKillerName, fmt);
+}
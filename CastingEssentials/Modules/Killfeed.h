@@ -3,6 +3,9 @@
 
 #include <client/hud_basedeathnotice.h>
 
+#include <unordered_map>
+#include <vector>
+
 class ConVarRef;
 
 class Killfeed final : public Module<Killfeed>
@@ -33,5 +36,42 @@ private:
     static constexpr int DEATH_NOTICES_OFFSET = 448;
     CUtlVector<DeathNoticeItem>* m_DeathNotices;
 
+    // Derived state for a death notice we've already processed. Notices are appended to the end of
+    // m_DeathNotices and expire from the front, so this is kept in the same order.
+    struct ProcessedNotice
+    {
+        int m_KillerID;
+        int m_VictimID;
+        float m_CreationTime;
+
+        int m_AssisterIndex; // entindex, or 0 if there was no assister (or we couldn't find them)
+
+        bool Matches(const DeathNoticeItem& item) const
+        {
+            return m_KillerID == item.iKillerID && m_VictimID == item.iVictimID &&
+                   m_CreationTime == item.flCreationTime;
+        }
+    };
+    std::vector<ProcessedNotice> m_ProcessedNotices;
+    int m_LastLocalPlayerIndex;
+
+    void SyncProcessedNotices();
+    static int FindAssisterIndex(const DeathNoticeItem& item);
+
+    // d_ and dneg_ versions of each killfeed icon. Filled lazily and cleared on level change, since that's
+    // when the hud textures get reloaded.
+    struct IconPair
+    {
+        CHudTexture* m_Standard;
+        CHudTexture* m_Inverted;
+    };
+    std::unordered_map<const CHudTexture*, IconPair> m_IconPairs;
+    CHudTexture* GetIcon(CHudTexture* texture, EDeathNoticeIconFormat fmt);
+
+    void ApplyNotice(DeathNoticeItem& item, const ProcessedNotice& processed, int localPlayerIndex,
+                     int localPlayerUserID);
+
     void OnTick(bool inGame) override;
+    void LevelInit() override;
+    void LevelShutdown() override;
 };
\ No newline at end of file
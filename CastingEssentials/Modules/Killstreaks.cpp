@@ -30,27 +30,33 @@
 
 #include "Controls/StubPanel.h"
 
-MODULE_REGISTER(Killstreaks);
+MODULE_REGISTER_LAZY(Killstreaks);
 
 std::array<EntityOffset<int>, 4> Killstreaks::s_PlayerStreaks;
 EntityOffset<bool> Killstreaks::s_MedigunHealing;
 EntityOffset<EHANDLE> Killstreaks::s_MedigunHealingTarget;
 EntityTypeChecker Killstreaks::s_MedigunType;
 
+ConVar Killstreaks::ce_killstreaks_enabled("ce_killstreaks_enabled", "0", FCVAR_NONE,
+                                           "Show killstreak counts on the hud for all weapons, not just killstreak "
+                                           "weapons.",
+                                           [](IConVar*, const char*, float) { UpdateActive(); });
+ConVar Killstreaks::ce_killstreaks_debug("ce_killstreaks_debug", "0");
+
+ConVar Killstreaks::ce_killstreaks_hide_firstperson_effects(
+    "ce_killstreaks_hide_firstperson_effects", "0", FCVAR_NONE,
+    "Don't show professional killstreak eye effects in the middle of the screen for the person we're spectating "
+    "when in firstperson camera mode.",
+    [](IConVar*, const char*, float) { UpdateActive(); });
+
 Killstreaks::Killstreaks()
-    : ce_killstreaks_enabled("ce_killstreaks_enabled", "0", FCVAR_NONE,
-                             "Show killstreak counts on the hud for all weapons, not just killstreak weapons."),
-      ce_killstreaks_debug("ce_killstreaks_debug", "0"),
-
-      ce_killstreaks_hide_firstperson_effects(
-          "ce_killstreaks_hide_firstperson_effects", "0", FCVAR_NONE,
-          "Don't show professional killstreak eye effects in the middle of the screen for the person we're spectating "
-          "when in firstperson camera mode."),
-
-      m_FireEventClientSideHook(
-          std::bind(&Killstreaks::FireEventClientSideOverride, this, std::placeholders::_1, std::placeholders::_2)),
-      m_RequestPriceSheetHook(std::bind(&Killstreaks::RequestPriceSheetOverride, this, std::placeholders::_1))
+    : m_PlayerSpawnSubscription("player_spawn", [this](IGameEvent* event) { OnPlayerSpawn(event); }),
+      m_PlayerDeathSubscription("player_death", [this](IGameEvent* event) { OnPlayerDeath(event); }),
+      m_WinPanelSubscription("teamplay_win_panel", [this](IGameEvent* event) { OnWinPanel(event); }),
+      m_RoundStartSubscription("teamplay_round_start", [this](IGameEvent* event) { OnRoundStart(event); }),
+      m_RequestPriceSheetHook(this)
 {
+    m_CurrentKillstreaks.fill(0);
 }
 
 bool Killstreaks::CheckDependencies()
@@ -106,6 +112,13 @@ bool Killstreaks::CheckDependencies()
     return ready;
 }
 
+void Killstreaks::UpdateActive()
+{
+    // Both features are polled from OnTick, so there's nothing else to toggle
+    Modules().UpdateLazyModule<Killstreaks>(
+        ce_killstreaks_enabled.GetBool() || ce_killstreaks_hide_firstperson_effects.GetBool(), [](Killstreaks*) {});
+}
+
 void Killstreaks::OnTick(bool inGame)
 {
     VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
@@ -145,10 +158,11 @@ void Killstreaks::UpdateKillstreaks(bool inGame)
     if (inGame)
     {
         m_RequestPriceSheetHook.Enable();
-        m_FireEventClientSideHook.Enable();
+        SetEventSubscriptionsEnabled(true);
 
-        Assert(TFPlayerResource::GetPlayerResource());
-        if (!TFPlayerResource::GetPlayerResource())
+        const auto playerResource = TFPlayerResource::GetPlayerResource();
+        Assert(playerResource);
+        if (!playerResource)
         {
             Warning("%s: TFPlayerResource unavailable!\n", Killstreaks::GetModuleName());
             return;
@@ -167,179 +181,196 @@ void Killstreaks::UpdateKillstreaks(bool inGame)
             if (!playerEntity)
                 continue;
 
-            const int userid = player->GetUserID();
             const auto entindex = player->entindex();
-
-            int newStreak = 0;
-            if (auto found = m_CurrentKillstreaks.find(userid); found != m_CurrentKillstreaks.end())
-                newStreak = found->second;
+            const int newStreak = m_CurrentKillstreaks[entindex - 1];
 
             if (ce_killstreaks_debug.GetBool())
                 engine->Con_NPrintf(printIndex++, "%s: %i", player->GetName(), newStreak);
 
             for (auto& streak : s_PlayerStreaks)
-                streak.GetValue(playerEntity) = newStreak;
+            {
+                if (auto& value = streak.GetValue(playerEntity); value != newStreak)
+                    value = newStreak;
+            }
+
+            // The stats block is only refreshed when a packet comes in, so this only writes after the server has
+            // overwritten our values
+            const auto stats = playerResource->GetStats(entindex);
+            if (!stats)
+                continue;
 
             for (int i = 0; i < TFPlayerResource::STREAK_WEAPONS; i++)
             {
-                auto streak = TFPlayerResource::GetPlayerResource()->GetKillstreak(entindex, i);
-                if (streak)
-                    *streak = newStreak;
+                if (stats->m_Killstreaks[i] != newStreak)
+                    playerResource->SetKillstreak(entindex, i, newStreak);
             }
         }
     }
     else
     {
-        m_CurrentKillstreaks.clear();
-        m_FireEventClientSideHook.Disable();
+        m_CurrentKillstreaks.fill(0);
+        SetEventSubscriptionsEnabled(false);
         m_RequestPriceSheetHook.Disable();
     }
 }
 
-bool Killstreaks::FireEventClientSideOverride(IGameEventManager2* pThis, IGameEvent* event)
+int& Killstreaks::GetKillstreakForUserID(int userID)
 {
-    Assert(event);
-    if (!event)
-        return false;
+    const auto entindex = Interfaces::GetEngineClient()->GetPlayerForUserID(userID);
+    if (entindex < 1 || entindex > (int)m_CurrentKillstreaks.size())
+    {
+        static int s_Dummy;
+        s_Dummy = 0;
+        return s_Dummy;
+    }
 
-    static constexpr Color DBG_COLOR(89, 191, 45, 255);
+    return m_CurrentKillstreaks[entindex - 1];
+}
 
-    const char* eventName = event->GetName();
-    if (!strcmp(eventName, "player_spawn"))
-    {
-        int userID = event->GetInt("userid", -1);
+void Killstreaks::SetEventSubscriptionsEnabled(bool enabled)
+{
+    m_PlayerSpawnSubscription.SetEnabled(enabled);
+    m_PlayerDeathSubscription.SetEnabled(enabled);
+    m_WinPanelSubscription.SetEnabled(enabled);
+    m_RoundStartSubscription.SetEnabled(enabled);
+}
 
-        if (userID > 0)
-            m_CurrentKillstreaks.erase(userID);
-    }
-    else if (!strcmp(eventName, "player_death"))
+void Killstreaks::OnPlayerSpawn(IGameEvent* event)
+{
+    int userID = event->GetInt("userid", -1);
+
+    if (userID > 0)
+        GetKillstreakForUserID(userID) = 0;
+}
+
+void Killstreaks::OnPlayerDeath(IGameEvent* event)
+{
+    static constexpr Color DBG_COLOR(89, 191, 45, 255);
+
+    const int victimUserID = event->GetInt("userid", -1);
+    const int attackerUserID = event->GetInt("attacker", -1);
+    if (attackerUserID > 0)
     {
-        const int victimUserID = event->GetInt("userid", -1);
-        const int attackerUserID = event->GetInt("attacker", -1);
-        if (attackerUserID > 0)
+        if (attackerUserID != victimUserID)
         {
-            if (attackerUserID != victimUserID)
-            {
-                const auto killstreak = ++m_CurrentKillstreaks[attackerUserID];
+            const auto killstreak = ++GetKillstreakForUserID(attackerUserID);
 
-                event->SetInt("kill_streak_total", killstreak);
-                event->SetInt("kill_streak_wep", killstreak);
+            event->SetInt("kill_streak_total", killstreak);
+            event->SetInt("kill_streak_wep", killstreak);
 
-                Player* attacker = Player::GetPlayerFromUserID(attackerUserID);
+            Player* attacker = Player::GetPlayerFromUserID(attackerUserID);
 
-                if (ce_killstreaks_debug.GetBool())
-                {
-                    const char* victimName = "(null)";
-                    if (auto victim = Player::GetPlayerFromUserID(victimUserID))
-                        victimName = victim->GetName();
+            if (ce_killstreaks_debug.GetBool())
+            {
+                const char* victimName = "(null)";
+                if (auto victim = Player::GetPlayerFromUserID(victimUserID))
+                    victimName = victim->GetName();
 
-                    ConColorMsg(DBG_COLOR, "[ce_killstreaks_debug]: %s killed %s (killstreak %i)\n",
-                                attacker->GetName(), victimName, killstreak);
-                }
+                ConColorMsg(DBG_COLOR, "[ce_killstreaks_debug]: %s killed %s (killstreak %i)\n",
+                            attacker->GetName(), victimName, killstreak);
+            }
 
-                if (attacker)
+            if (attacker)
+            {
+                if (attacker->GetTeam() == TFTeam::Red)
                 {
-                    if (attacker->GetTeam() == TFTeam::Red)
+                    if (killstreak > m_RedTopKillstreak)
                     {
-                        if (killstreak > m_RedTopKillstreak)
-                        {
-                            m_RedTopKillstreak = killstreak;
-                            m_RedTopKillstreakPlayer = attackerUserID;
-                        }
+                        m_RedTopKillstreak = killstreak;
+                        m_RedTopKillstreakPlayer = attackerUserID;
                     }
-                    else if (attacker->GetTeam() == TFTeam::Blue)
+                }
+                else if (attacker->GetTeam() == TFTeam::Blue)
+                {
+                    if (killstreak > m_BluTopKillstreak)
                     {
-                        if (killstreak > m_BluTopKillstreak)
-                        {
-                            m_BluTopKillstreak = killstreak;
-                            m_BluTopKillstreakPlayer = attackerUserID;
-                        }
+                        m_BluTopKillstreak = killstreak;
+                        m_BluTopKillstreakPlayer = attackerUserID;
                     }
                 }
             }
-            else
-            {
-                event->SetInt("kill_streak_total", 0);
-                event->SetInt("kill_streak_wep", 0);
-            }
         }
+        else
+        {
+            event->SetInt("kill_streak_total", 0);
+            event->SetInt("kill_streak_wep", 0);
+        }
+    }
 
-        const int assisterUserID = event->GetInt("assister", -1);
-        if (assisterUserID > 0)
+    const int assisterUserID = event->GetInt("assister", -1);
+    if (assisterUserID > 0)
+    {
+        if (Player* assister = Player::GetPlayerFromUserID(assisterUserID))
         {
-            if (Player* assister = Player::GetPlayerFromUserID(assisterUserID))
+            if (auto medigun = assister->GetMedigun())
             {
-                if (auto medigun = assister->GetMedigun())
+                if (s_MedigunHealing.GetValue(medigun))
                 {
-                    if (s_MedigunHealing.GetValue(medigun))
+                    int healingTarget = s_MedigunHealingTarget.GetValue(medigun).GetEntryIndex();
+                    if (healingTarget == Interfaces::GetEngineClient()->GetPlayerForUserID(attackerUserID))
                     {
-                        int healingTarget = s_MedigunHealingTarget.GetValue(medigun).GetEntryIndex();
-                        if (healingTarget == Interfaces::GetEngineClient()->GetPlayerForUserID(attackerUserID))
-                        {
-                            const auto killstreak = ++m_CurrentKillstreaks[assisterUserID];
+                        const auto killstreak = ++GetKillstreakForUserID(assisterUserID);
 
-                            if (ce_killstreaks_debug.GetBool())
-                            {
-                                const char* victimName = "(null)";
-                                if (auto victim = Player::GetPlayerFromUserID(victimUserID))
-                                    victimName = victim->GetName();
+                        if (ce_killstreaks_debug.GetBool())
+                        {
+                            const char* victimName = "(null)";
+                            if (auto victim = Player::GetPlayerFromUserID(victimUserID))
+                                victimName = victim->GetName();
 
-                                ConColorMsg(DBG_COLOR,
-                                            "[ce_killstreaks_debug]: %s assisted against %s (killstreak %i)\n",
-                                            assister->GetName(), victimName);
-                            }
+                            ConColorMsg(DBG_COLOR, "[ce_killstreaks_debug]: %s assisted against %s (killstreak %i)\n",
+                                        assister->GetName(), victimName);
+                        }
 
-                            if (assister->GetTeam() == TFTeam::Red)
+                        if (assister->GetTeam() == TFTeam::Red)
+                        {
+                            if (killstreak > m_RedTopKillstreak)
                             {
-                                if (killstreak > m_RedTopKillstreak)
-                                {
-                                    m_RedTopKillstreak = killstreak;
-                                    m_RedTopKillstreakPlayer = assisterUserID;
-                                }
+                                m_RedTopKillstreak = killstreak;
+                                m_RedTopKillstreakPlayer = assisterUserID;
                             }
-                            else if (assister->GetTeam() == TFTeam::Blue)
+                        }
+                        else if (assister->GetTeam() == TFTeam::Blue)
+                        {
+                            if (killstreak > m_BluTopKillstreak)
                             {
-                                if (killstreak > m_BluTopKillstreak)
-                                {
-                                    m_BluTopKillstreak = killstreak;
-                                    m_BluTopKillstreakPlayer = assisterUserID;
-                                }
+                                m_BluTopKillstreak = killstreak;
+                                m_BluTopKillstreakPlayer = assisterUserID;
                             }
                         }
                     }
                 }
             }
-
-            event->SetInt("kill_streak_assist", m_CurrentKillstreaks[assisterUserID]);
         }
 
-        if (victimUserID > 0)
-            event->SetInt("kill_streak_victim", m_CurrentKillstreaks[victimUserID]);
+        event->SetInt("kill_streak_assist", GetKillstreakForUserID(assisterUserID));
     }
-    else if (!strcmp(eventName, "teamplay_win_panel"))
+
+    if (victimUserID > 0)
+        event->SetInt("kill_streak_victim", GetKillstreakForUserID(victimUserID));
+}
+
+void Killstreaks::OnWinPanel(IGameEvent* event)
+{
+    if (event->GetInt("winning_team") == (int)TFTeam::Red)
     {
-        if (event->GetInt("winning_team") == (int)TFTeam::Red)
-        {
-            event->SetInt("killstreak_player_1",
-                          Interfaces::GetEngineClient()->GetPlayerForUserID(m_RedTopKillstreakPlayer));
-            event->SetInt("killstreak_player_1_count", m_RedTopKillstreak);
-        }
-        else if (event->GetInt("winning_team") == (int)TFTeam::Blue)
-        {
-            event->SetInt("killstreak_player_1",
-                          Interfaces::GetEngineClient()->GetPlayerForUserID(m_BluTopKillstreakPlayer));
-            event->SetInt("killstreak_player_1_count", m_BluTopKillstreak);
-        }
+        event->SetInt("killstreak_player_1",
+                      Interfaces::GetEngineClient()->GetPlayerForUserID(m_RedTopKillstreakPlayer));
+        event->SetInt("killstreak_player_1_count", m_RedTopKillstreak);
     }
-    else if (!strcmp(eventName, "teamplay_round_start"))
+    else if (event->GetInt("winning_team") == (int)TFTeam::Blue)
     {
-        m_BluTopKillstreak = 0;
-        m_BluTopKillstreakPlayer = 0;
-        m_RedTopKillstreak = 0;
-        m_RedTopKillstreakPlayer = 0;
+        event->SetInt("killstreak_player_1",
+                      Interfaces::GetEngineClient()->GetPlayerForUserID(m_BluTopKillstreakPlayer));
+        event->SetInt("killstreak_player_1_count", m_BluTopKillstreak);
     }
+}
 
-    return true;
+void Killstreaks::OnRoundStart(IGameEvent*)
+{
+    m_BluTopKillstreak = 0;
+    m_BluTopKillstreakPlayer = 0;
+    m_RedTopKillstreak = 0;
+    m_RedTopKillstreakPlayer = 0;
 }
 
 void Killstreaks::RequestPriceSheetOverride(CStorePanel*)
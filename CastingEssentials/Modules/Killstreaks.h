@@ -1,14 +1,15 @@
 #pragma once
 
 #include "PluginBase/Entities.h"
+#include "PluginBase/GameEventRouter.h"
 #include "PluginBase/Hook.h"
 #include "PluginBase/Modules.h"
 
 #include <convar.h>
 #include <shared/ehandle.h>
+#include <shareddefs.h>
 
 #include <array>
-#include <map>
 
 class C_BaseEntity;
 
@@ -24,14 +25,19 @@ protected:
     void OnTick(bool inGame) override;
 
 private:
-    ConVar ce_killstreaks_enabled;
-    ConVar ce_killstreaks_debug;
+    static ConVar ce_killstreaks_enabled;
+    static ConVar ce_killstreaks_debug;
     void UpdateKillstreaks(bool inGame);
 
-    ConVar ce_killstreaks_hide_firstperson_effects;
+    static ConVar ce_killstreaks_hide_firstperson_effects;
     void HideFirstPersonEffects() const;
 
-    bool FireEventClientSideOverride(IGameEventManager2* pThis, IGameEvent* event);
+    static void UpdateActive();
+
+    void OnPlayerSpawn(IGameEvent* event);
+    void OnPlayerDeath(IGameEvent* event);
+    void OnWinPanel(IGameEvent* event);
+    void OnRoundStart(IGameEvent* event);
     void RequestPriceSheetOverride(CStorePanel*);
 
     int m_BluTopKillstreak;
@@ -39,9 +45,16 @@ private:
     int m_RedTopKillstreak;
     int m_RedTopKillstreakPlayer;
 
-    std::map<int, int> m_CurrentKillstreaks;
-    Hook<HookFunc::IGameEventManager2_FireEventClientSide> m_FireEventClientSideHook;
-    Hook<HookFunc::CStorePanel_RequestPricesheet> m_RequestPriceSheetHook;
+    // Indexed by entindex - 1
+    std::array<int, MAX_PLAYERS> m_CurrentKillstreaks;
+    int& GetKillstreakForUserID(int userID);
+
+    void SetEventSubscriptionsEnabled(bool enabled);
+    GameEventSubscription m_PlayerSpawnSubscription;
+    GameEventSubscription m_PlayerDeathSubscription;
+    GameEventSubscription m_WinPanelSubscription;
+    GameEventSubscription m_RoundStartSubscription;
+    Hook<HookFunc::CStorePanel_RequestPricesheet, &Killstreaks::RequestPriceSheetOverride> m_RequestPriceSheetHook;
 
     static std::array<EntityOffset<int>, 4> s_PlayerStreaks;
     static EntityOffset<bool> s_MedigunHealing;
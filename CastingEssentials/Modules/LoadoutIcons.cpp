@@ -20,16 +20,23 @@ LoadoutIcons::LoadoutIcons()
     : ce_loadout_enabled("ce_loadout_enabled", "0", FCVAR_NONE,
                          "Enable weapon icons inside player panels in the specgui."),
       ce_loadout_filter_active_red("ce_loadout_filter_active_red", "255 255 255 255", FCVAR_NONE,
-                                   "drawcolor_override for red team's active loadout items."),
+                                   "drawcolor_override for red team's active loadout items.",
+                                   [](IConVar*, const char*, float) { GetModule()->m_ColorsVersion++; }),
       ce_loadout_filter_active_blu("ce_loadout_filter_active_blu", "255 255 255 255", FCVAR_NONE,
-                                   "drawcolor_override for blu team's active loadout items."),
+                                   "drawcolor_override for blu team's active loadout items.",
+                                   [](IConVar*, const char*, float) { GetModule()->m_ColorsVersion++; }),
       ce_loadout_filter_inactive_red("ce_loadout_filter_inactive_red", "255 255 255 255", FCVAR_NONE,
-                                     "drawcolor_override for red team's inactive loadout items."),
+                                     "drawcolor_override for red team's inactive loadout items.",
+                                     [](IConVar*, const char*, float) { GetModule()->m_ColorsVersion++; }),
       ce_loadout_filter_inactive_blu("ce_loadout_filter_inactive_blu", "255 255 255 255", FCVAR_NONE,
-                                     "drawcolor_override for blu team's inactive loadout items.")
+                                     "drawcolor_override for blu team's inactive loadout items.",
+                                     [](IConVar*, const char*, float) { GetModule()->m_ColorsVersion++; })
 {
-    memset(m_Weapons, 0, sizeof(m_Weapons));
-    memset(m_ActiveWeaponIndices, 0, sizeof(m_ActiveWeaponIndices));
+    for (auto& loadout : m_Loadouts)
+    {
+        loadout.m_Weapons.fill(-1);
+        loadout.m_ActiveWeaponIndex = IDX_ACTIVE;
+    }
 }
 
 bool LoadoutIcons::CheckDependencies()
@@ -67,23 +74,38 @@ void LoadoutIcons::GatherWeapons()
     for (Player* player : Player::Iterable())
     {
         const auto playerIndex = player->entindex() - 1;
+        auto& loadout = m_Loadouts[playerIndex];
 
-        const auto& activeWeapon = player->GetActiveWeapon();
-
-        m_Weapons[playerIndex][IDX_ACTIVE] =
-            activeWeapon ? ItemSchema::GetModule()->GetBaseItemID(Entities::GetItemDefinitionIndex(activeWeapon)) : -1;
+        LoadoutSignature signature;
+        if (auto activeWeapon = player->GetActiveWeapon())
+            signature.m_Active = {activeWeapon->GetRefEHandle(), Entities::GetItemDefinitionIndex(activeWeapon)};
 
-        for (int weaponIndex = 0; weaponIndex < 5; weaponIndex++)
+        for (int weaponIndex = 0; weaponIndex < SLOT_COUNT; weaponIndex++)
         {
-            C_BaseCombatWeapon* weapon = player->GetWeapon(weaponIndex);
-            if (!weapon)
-                continue;
+            if (auto weapon = player->GetWeapon(weaponIndex))
+                signature.m_Slots[weaponIndex] = {weapon->GetRefEHandle(), Entities::GetItemDefinitionIndex(weapon)};
+        }
+
+        if (signature == loadout.m_Signature)
+            continue;
 
-            auto currentID = ItemSchema::GetModule()->GetBaseItemID(Entities::GetItemDefinitionIndex(weapon));
-            if (currentID == m_Weapons[playerIndex][IDX_ACTIVE])
-                m_ActiveWeaponIndices[playerIndex] = weaponIndex;
+        loadout.m_Signature = signature;
+        loadout.m_Version++;
 
-            m_Weapons[playerIndex][weaponIndex] = currentID;
+        const auto itemSchema = ItemSchema::GetModule();
+        const auto getBaseItemID = [&](const WeaponKey& key)
+        { return key.m_Handle.IsValid() ? itemSchema->GetBaseItemID(key.m_DefinitionIndex) : -1; };
+
+        loadout.m_Weapons[IDX_ACTIVE] = getBaseItemID(signature.m_Active);
+        loadout.m_ActiveWeaponIndex = IDX_ACTIVE;
+
+        for (int weaponIndex = 0; weaponIndex < SLOT_COUNT; weaponIndex++)
+        {
+            const auto currentID = getBaseItemID(signature.m_Slots[weaponIndex]);
+            if (currentID >= 0 && currentID == loadout.m_Weapons[IDX_ACTIVE])
+                loadout.m_ActiveWeaponIndex = weaponIndex;
+
+            loadout.m_Weapons[weaponIndex] = currentID;
         }
     }
 }
@@ -95,6 +117,14 @@ void LoadoutIcons::DrawIcons()
     if (!specguiPanel)
         return;
 
+    // The whole specgui gets rebuilt when the HUD is reloaded
+    if (specguiPanel != m_SpecGUI || SchemeWasReloaded())
+    {
+        m_SpecGUI = specguiPanel;
+        m_PanelCache.clear();
+        m_SchemeCheckIcon = 0;
+    }
+
     const auto specguiChildCount = g_pVGuiPanel->GetChildCount(specguiPanel);
     for (int playerPanelIndex = 0; playerPanelIndex < specguiChildCount; playerPanelIndex++)
     {
@@ -107,11 +137,43 @@ void LoadoutIcons::DrawIcons()
         vgui::EditablePanel* player =
             assert_cast<vgui::EditablePanel*>(g_pVGuiPanel->GetPanel(playerVPanel, "ClientDLL"));
 
-        PlayerPanelUpdateIcons(player);
+        PlayerPanelUpdateIcons(playerVPanel, player);
     }
 }
 
-void LoadoutIcons::PlayerPanelUpdateIcons(vgui::EditablePanel* playerPanel)
+void LoadoutIcons::ResolveIconPanels(vgui::VPANEL playerVPanel, PlayerPanelCache& cache) const
+{
+    cache = {};
+    cache.m_Resolved = true;
+    cache.m_Handle = vgui::ivgui()->PanelToHandle(playerVPanel);
+
+    const auto childCount = g_pVGuiPanel->GetChildCount(playerVPanel);
+    for (int i = 0; i < childCount; i++)
+    {
+        auto childVPANEL = g_pVGuiPanel->GetChild(playerVPanel, i);
+        auto childPanelName = g_pVGuiPanel->GetName(childVPANEL);
+
+        for (uint_fast8_t iconIndex = 0; iconIndex < ITEM_COUNT; iconIndex++)
+        {
+            for (int teamIndex = 0; teamIndex < 2; teamIndex++)
+            {
+                if (!strcmp(childPanelName, LOADOUT_ICONS[iconIndex][teamIndex]))
+                    cache.m_Icons[iconIndex][teamIndex] = childVPANEL;
+            }
+        }
+    }
+}
+
+bool LoadoutIcons::SchemeWasReloaded() const
+{
+    if (!m_SchemeCheckIcon || vgui::ivgui()->HandleToPanel(m_SchemeCheckHandle) != m_SchemeCheckIcon)
+        return false;
+
+    auto icon = dynamic_cast<vgui::ImagePanel*>(g_pVGuiPanel->GetPanel(m_SchemeCheckIcon, "ClientDLL"));
+    return icon && icon->GetDrawColor() != m_SchemeCheckColor;
+}
+
+void LoadoutIcons::PlayerPanelUpdateIcons(vgui::VPANEL playerVPanel, vgui::EditablePanel* playerPanel)
 {
     const int playerIndex = GetPlayerIndex(playerPanel);
     if (playerIndex < 0 || playerIndex >= MAX_PLAYERS)
@@ -129,48 +191,68 @@ void LoadoutIcons::PlayerPanelUpdateIcons(vgui::EditablePanel* playerPanel)
 
     const int teamIndex = (int)team - (int)TFTeam::Red;
 
-    // Force get the panel even though we're in a different module
-    const auto playerVPANEL = playerPanel->GetVPanel();
-    for (int i = 0; i < g_pVGuiPanel->GetChildCount(playerVPANEL); i++)
+    auto& cache = m_PanelCache[playerVPanel];
+    if (!cache.m_Resolved || vgui::ivgui()->HandleToPanel(cache.m_Handle) != playerVPanel)
+        ResolveIconPanels(playerVPanel, cache);
+
+    // Player panels get shuffled around between players, so this is checked per panel rather than per player
+    const auto& loadout = m_Loadouts[playerIndex];
+    if (cache.m_Applied && cache.m_PlayerIndex == playerIndex && cache.m_Team == team &&
+        cache.m_LoadoutVersion == loadout.m_Version && cache.m_ColorsVersion == m_ColorsVersion)
     {
-        auto childVPANEL = g_pVGuiPanel->GetChild(playerVPANEL, i);
-        auto childPanelName = g_pVGuiPanel->GetName(childVPANEL);
+        return;
+    }
 
-        for (uint_fast8_t iconIndex = 0; iconIndex < ITEM_COUNT; iconIndex++)
-        {
-            if (strcmp(childPanelName, LOADOUT_ICONS[iconIndex][teamIndex]))
-                continue;
+    cache.m_Applied = true;
+    cache.m_PlayerIndex = playerIndex;
+    cache.m_Team = team;
+    cache.m_LoadoutVersion = loadout.m_Version;
+    cache.m_ColorsVersion = m_ColorsVersion;
 
-            auto iconPanel = g_pVGuiPanel->GetPanel(childVPANEL, "ClientDLL");
+    for (uint_fast8_t iconIndex = 0; iconIndex < ITEM_COUNT; iconIndex++)
+    {
+        const auto iconVPANEL = cache.m_Icons[iconIndex][teamIndex];
+        if (!iconVPANEL)
+            continue;
 
-            const auto weaponIndex = m_Weapons[playerIndex][iconIndex];
+        // Force get the panel even though we're in a different module
+        auto iconPanel = g_pVGuiPanel->GetPanel(iconVPANEL, "ClientDLL");
 
-            if (weaponIndex < 0)
-            {
-                iconPanel->SetVisible(false);
-            }
-            else
+        const auto weaponIndex = loadout.m_Weapons[iconIndex];
+
+        if (weaponIndex < 0)
+        {
+            iconPanel->SetVisible(false);
+        }
+        else
+        {
+            // Dumb, evil, unsafe hacks
+            if (auto imgPanel = dynamic_cast<vgui::ImagePanel*>(iconPanel))
             {
+                // By name, so the panel keeps its own scaling setting and can reload the image itself
                 char materialBuffer[32];
                 sprintf_s(materialBuffer, "loadout_icons/%i_%s", weaponIndex, TF_TEAM_NAMES[(int)team]);
+                imgPanel->SetImage(materialBuffer);
+
+                Color color;
+                if (iconIndex == IDX_ACTIVE || loadout.m_ActiveWeaponIndex == iconIndex)
+                    color = team == TFTeam::Red ? ce_loadout_filter_active_red.GetValue()
+                                                : ce_loadout_filter_active_blu.GetValue();
+                else
+                    color = team == TFTeam::Red ? ce_loadout_filter_inactive_red.GetValue()
+                                                : ce_loadout_filter_inactive_blu.GetValue();
 
-                // Dumb, evil, unsafe hacks
-                if (auto imgPanel = dynamic_cast<vgui::ImagePanel*>(iconPanel))
+                imgPanel->SetDrawColor(color);
+
+                if (!m_SchemeCheckIcon || m_SchemeCheckIcon == iconVPANEL)
                 {
-                    imgPanel->SetImage(materialBuffer);
-
-                    if (iconIndex == IDX_ACTIVE || m_ActiveWeaponIndices[playerIndex] == iconIndex)
-                        imgPanel->SetDrawColor(ColorFromConVar(team == TFTeam::Red ? ce_loadout_filter_active_red
-                                                                                   : ce_loadout_filter_active_blu));
-                    else
-                        imgPanel->SetDrawColor(ColorFromConVar(team == TFTeam::Red ? ce_loadout_filter_inactive_red
-                                                                                   : ce_loadout_filter_inactive_blu));
+                    m_SchemeCheckIcon = iconVPANEL;
+                    m_SchemeCheckHandle = vgui::ivgui()->PanelToHandle(iconVPANEL);
+                    m_SchemeCheckColor = color;
                 }
-
-                iconPanel->SetVisible(true);
             }
 
-            break;
+            iconPanel->SetVisible(true);
         }
     }
 }
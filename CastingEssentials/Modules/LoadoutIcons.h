@@ -1,10 +1,16 @@
 #pragma once
 #include "PluginBase/Modules.h"
+#include "PluginBase/TypedConVar.h"
 
 #include <convar.h>
+#include <shared/ehandle.h>
 #include <shareddefs.h>
 
+#include <array>
+#include <unordered_map>
+
 class IClientNetworkable;
+enum class TFTeam;
 
 namespace vgui
 {
@@ -12,6 +18,7 @@ class Panel;
 class ImagePanel;
 class EditablePanel;
 typedef uintptr_t VPANEL;
+typedef unsigned long HPanel;
 }
 
 class LoadoutIcons : public Module<LoadoutIcons>
@@ -28,15 +35,15 @@ protected:
 private:
     void GatherWeapons();
     void DrawIcons();
-    void PlayerPanelUpdateIcons(vgui::EditablePanel* playerPanel);
+    void PlayerPanelUpdateIcons(vgui::VPANEL playerVPanel, vgui::EditablePanel* playerPanel);
 
     static int GetPlayerIndex(vgui::EditablePanel* playerPanel);
 
     ConVar ce_loadout_enabled;
-    ConVar ce_loadout_filter_active_red;
-    ConVar ce_loadout_filter_active_blu;
-    ConVar ce_loadout_filter_inactive_red;
-    ConVar ce_loadout_filter_inactive_blu;
+    TypedConVar<Color> ce_loadout_filter_active_red;
+    TypedConVar<Color> ce_loadout_filter_active_blu;
+    TypedConVar<Color> ce_loadout_filter_inactive_red;
+    TypedConVar<Color> ce_loadout_filter_inactive_blu;
 
     enum ItemIndex
     {
@@ -57,6 +64,58 @@ private:
         {"LoadoutIconsItem5Red", "LoadoutIconsItem5Blue"}, {"LoadoutIconsActiveItemRed", "LoadoutIconsActiveItemBlue"},
     };
 
-    byte m_ActiveWeaponIndices[MAX_PLAYERS]; // Index into m_Weapons
-    int m_Weapons[MAX_PLAYERS][ITEM_COUNT];
+    static constexpr int SLOT_COUNT = IDX_ACTIVE;
+
+    // Which weapons a player is holding. Base item IDs are only looked up in the item schema when
+    // this changes.
+    struct WeaponKey
+    {
+        CBaseHandle m_Handle;
+        int m_DefinitionIndex = -1;
+
+        bool operator==(const WeaponKey& other) const = default;
+    };
+    struct LoadoutSignature
+    {
+        std::array<WeaponKey, SLOT_COUNT> m_Slots;
+        WeaponKey m_Active;
+
+        bool operator==(const LoadoutSignature& other) const = default;
+    };
+
+    struct Loadout
+    {
+        LoadoutSignature m_Signature;
+        std::array<int, ITEM_COUNT> m_Weapons; // Base item IDs, -1 if empty
+        byte m_ActiveWeaponIndex;              // Slot holding the active weapon, or IDX_ACTIVE if none
+        uint32_t m_Version = 0;
+    };
+    std::array<Loadout, MAX_PLAYERS> m_Loadouts;
+
+    // Icon panels for one player panel, resolved once per HUD load, along with what was last shown
+    // on them so vgui is only touched when something changes.
+    struct PlayerPanelCache
+    {
+        bool m_Resolved = false;
+        vgui::HPanel m_Handle;
+        vgui::VPANEL m_Icons[ITEM_COUNT][2];
+
+        bool m_Applied = false;
+        int m_PlayerIndex;
+        TFTeam m_Team;
+        uint32_t m_LoadoutVersion;
+        uint32_t m_ColorsVersion;
+    };
+    vgui::VPANEL m_SpecGUI = 0;
+    std::unordered_map<vgui::VPANEL, PlayerPanelCache> m_PanelCache;
+    void ResolveIconPanels(vgui::VPANEL playerVPanel, PlayerPanelCache& cache) const;
+
+    uint32_t m_ColorsVersion = 0;
+
+    // One icon we colored, and what we colored it. Reloading the scheme re-applies the icons'
+    // resource settings over ours, so when this stops matching every panel is redone.
+    vgui::VPANEL m_SchemeCheckIcon = 0;
+    vgui::HPanel m_SchemeCheckHandle;
+    Color m_SchemeCheckColor;
+    bool SchemeWasReloaded() const;
 };
\ No newline at end of file
@@ -29,7 +29,7 @@ LocalPlayer::LocalPlayer()
       ce_localplayer_track_spec_target("ce_localplayer_track_spec_target", "0", FCVAR_NONE,
                                        "have the local player value track the spectator target"),
 
-      m_GetLocalPlayerIndexHook(std::bind(&LocalPlayer::GetLocalPlayerIndexOverride, this))
+      m_GetLocalPlayerIndexHook(this)
 {
 }
 
@@ -19,7 +19,7 @@ private:
 
     int GetLocalPlayerIndexOverride();
 
-    Hook<HookFunc::Global_GetLocalPlayerIndex> m_GetLocalPlayerIndexHook;
+    Hook<HookFunc::Global_GetLocalPlayerIndex, &LocalPlayer::GetLocalPlayerIndexOverride> m_GetLocalPlayerIndexHook;
 
     ConVar ce_localplayer_enabled;
     ConVar ce_localplayer_player;
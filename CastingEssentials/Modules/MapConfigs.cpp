@@ -15,10 +15,7 @@ void MapConfigs::LevelInit()
     if (!ce_mapconfigs_enabled.GetBool())
         return;
 
-    const char* const bspName = Interfaces::GetEngineClient()->GetLevelName();
-    std::string mapName(bspName);
-    mapName.erase(mapName.size() - 4, 4); // remove .bsp
-    mapName.erase(0, 5);                  // remove /maps/
+    const std::string mapName = GetMapName(Interfaces::GetEngineClient()->GetLevelName());
 
     if (Interfaces::GetEngineClient()->IsPlayingDemo() || Interfaces::GetEngineClient()->IsHLTV())
         Interfaces::GetEngineClient()->ExecuteClientCmd(strprintf("exec %s", mapName.c_str()).c_str());
@@ -16,6 +16,7 @@
 #include "PluginBase/Player.h"
 #include "PluginBase/TFDefinitions.h"
 #include "PluginBase/TFPlayerResource.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include "vgui/IScheme.h"
 #include "vgui/ISurface.h"
@@ -151,14 +152,16 @@ void MedigunInfo::CollectMedigunData()
 {
     m_MedigunPanelData.clear();
 
+    const auto& world = WorldSnapshot::Get();
     for (Player* player : Player::Iterable())
     {
-        if (player->GetClass() != TFClassType::Medic)
+        const auto entindex = player->entindex();
+        if (!world.IsValid(entindex) || world.GetClass(entindex) != TFClassType::Medic)
             continue;
 
-        Data& medigunData = m_MedigunPanelData.insert(std::make_pair(player->entindex() - 1, Data())).first->second;
-        medigunData.m_Alive = player->IsAlive();
-        medigunData.m_Team = player->GetTeam();
+        Data& medigunData = m_MedigunPanelData.insert(std::make_pair(entindex - 1, Data())).first->second;
+        medigunData.m_Alive = world.IsAlive(entindex);
+        medigunData.m_Team = world.GetTeam(entindex);
 
         if (medigunData.m_Alive)
         {
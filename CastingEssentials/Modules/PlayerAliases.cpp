@@ -14,10 +14,16 @@ PlayerAliases::PlayerAliases()
           "ce_playeraliases_enabled", "0", FCVAR_NONE, "Enables player aliases.",
           [](IConVar* var, const char*, float) { GetModule()->ToggleEnabled(static_cast<ConVar*>(var)); }),
 
-      ce_playeraliases_format_mode("ce_playeraliases_format_mode", "0", FCVAR_NONE,
-                                   "0 = apply format to all players, 1 = apply format to aliased players only"),
-      ce_playeraliases_format_blu("ce_playeraliases_format_blu", "%alias%", FCVAR_NONE, "Name format for BLU players."),
-      ce_playeraliases_format_red("ce_playeraliases_format_red", "%alias%", FCVAR_NONE, "Name format for RED players."),
+      ce_playeraliases_format_mode(
+          "ce_playeraliases_format_mode", "0", FCVAR_NONE,
+          "0 = apply format to all players, 1 = apply format to aliased players only",
+          [](IConVar*, const char*, float) { GetModule()->InvalidateNameCache(); }),
+      ce_playeraliases_format_blu(
+          "ce_playeraliases_format_blu", "%alias%", FCVAR_NONE, "Name format for BLU players.",
+          [](IConVar*, const char*, float) { GetModule()->InvalidateNameCache(); }),
+      ce_playeraliases_format_red(
+          "ce_playeraliases_format_red", "%alias%", FCVAR_NONE, "Name format for RED players.",
+          [](IConVar*, const char*, float) { GetModule()->InvalidateNameCache(); }),
       ce_playeraliases_format_swap(
           "ce_playeraliases_format_swap", []() { GetModule()->SwapTeamFormats(); },
           "Swaps the values of ce_playeraliases_format_red and ce_playeraliases_format_blu."),
@@ -32,9 +38,10 @@ PlayerAliases::PlayerAliases()
           "ce_playeraliases_remove", [](const CCommand& args) { GetModule()->RemovePlayerAlias(args); },
           "Removes an existing player alias."),
 
-      m_GetPlayerInfoHook(
-          std::bind(&PlayerAliases::GetPlayerInfoOverride, this, std::placeholders::_1, std::placeholders::_2))
+      m_GetPlayerInfoHook(this),
+      m_UserInfoChangedHook(this)
 {
+    InvalidateNameCache();
 }
 
 bool PlayerAliases::CheckDependencies()
@@ -65,6 +72,13 @@ bool PlayerAliases::CheckDependencies()
         ready = false;
     }
 
+    // Cached names are only invalidated through this
+    if (!GetHooks()->GetHook<HookFunc::Global_UserInfoChangedCallback>())
+    {
+        PluginWarning("Required hook UserInfoChangedCallback for module %s not available!\n", GetModuleName());
+        ready = false;
+    }
+
     return ready;
 }
 
@@ -74,10 +88,40 @@ bool PlayerAliases::GetPlayerInfoOverride(int ent_num, player_info_s* pinfo)
     if (ent_num < 1 || ent_num > Interfaces::GetEngineTool()->GetMaxClients())
         return false;
 
-    Player* player = Player::GetPlayer(ent_num, __FUNCSIG__);
-    if (!player)
-        return false;
+    auto& entry = m_NameCache[ent_num - 1];
+    bool result;
+    if (entry.m_Valid)
+    {
+        if (!entry.m_Override)
+            return true;
+
+        result = m_GetPlayerInfoHook.GetOriginal()(ent_num, pinfo);
+        if (!result)
+            return true; // pinfo wasn't filled in, so leave the engine's answer alone
+    }
+    else
+    {
+        Player* player = Player::GetPlayer(ent_num, __FUNCSIG__);
+        if (!player)
+            return false;
 
+        result = m_GetPlayerInfoHook.GetOriginal()(ent_num, pinfo);
+        if (!result)
+            return true; // Don't cache anything for a slot the engine doesn't know about yet
+
+        BuildNameCacheEntry(entry, player->GetTeam(), *pinfo);
+        if (!entry.m_Override)
+            return true;
+    }
+
+    V_strcpy_safe(pinfo->name, entry.m_Name);
+
+    GetHooks()->SetState<HookFunc::IVEngineClient_GetPlayerInfo>(Hooking::HookAction::SUPERCEDE);
+    return result;
+}
+
+void PlayerAliases::BuildNameCacheEntry(NameCacheEntry& entry, TFTeam team, const player_info_s& info) const
+{
     static EUniverse universe = k_EUniverseInvalid;
     if (universe == k_EUniverseInvalid)
     {
@@ -90,40 +134,66 @@ bool PlayerAliases::GetPlayerInfoOverride(int ent_num, player_info_s* pinfo)
         }
     }
 
-    bool result = m_GetPlayerInfoHook.GetOriginal()(ent_num, pinfo);
+    entry.m_Valid = true;
+    entry.m_Team = team;
 
-    CSteamID playerSteamID(pinfo->friendsID, 1, universe, k_EAccountTypeIndividual);
+    CSteamID playerSteamID(info.friendsID, 1, universe, k_EAccountTypeIndividual);
     const char* alias = GetAlias(playerSteamID);
 
-    if (auto mode = ce_playeraliases_format_mode.GetInt(); mode == 0 || (mode == 1 && alias))
+    const auto mode = ce_playeraliases_format_mode.GetValue();
+    entry.m_Override = mode == FormatMode::AllPlayers || (mode == FormatMode::AliasedOnly && alias);
+    if (!entry.m_Override)
+        return;
+
+    if (!alias)
+        alias = info.name;
+
+    std::string gameName;
+    switch (team)
     {
-        if (!alias)
-            alias = pinfo->name;
+        case TFTeam::Red:
+            gameName = ce_playeraliases_format_red.GetString();
+            break;
 
-        std::string gameName;
-        switch (player->GetTeam())
-        {
-            case TFTeam::Red:
-                gameName = ce_playeraliases_format_red.GetString();
-                break;
+        case TFTeam::Blue:
+            gameName = ce_playeraliases_format_blu.GetString();
+            break;
 
-            case TFTeam::Blue:
-                gameName = ce_playeraliases_format_blu.GetString();
-                break;
+        default:
+            gameName = "%alias%";
+            break;
+    }
 
-            default:
-                gameName = "%alias%";
-                break;
-        }
+    FindAndReplaceInString(gameName, "%alias%", alias);
+    V_strcpy_safe(entry.m_Name, gameName.c_str());
+}
 
-        FindAndReplaceInString(gameName, "%alias%", alias);
-        V_strcpy_safe(pinfo->name, gameName.c_str());
+void PlayerAliases::InvalidateNameCache()
+{
+    for (auto& entry : m_NameCache)
+        entry.m_Valid = false;
+}
 
-        GetHooks()->SetState<HookFunc::IVEngineClient_GetPlayerInfo>(Hooking::HookAction::SUPERCEDE);
-        return result;
-    }
+void PlayerAliases::UserInfoChangedCallbackOverride(void*, INetworkStringTable*, int stringNumber, const char*,
+                                                    const void*)
+{
+    if (stringNumber >= 0 && stringNumber < (int)m_NameCache.size())
+        m_NameCache[stringNumber].m_Valid = false;
+}
+
+void PlayerAliases::OnTick(bool inGame)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    if (!inGame || !m_GetPlayerInfoHook.IsEnabled())
+        return;
 
-    return true;
+    // The format depends on team, so catch team switches here rather than re-checking on every GetPlayerInfo call
+    for (Player* player : Player::Iterable())
+    {
+        auto& entry = m_NameCache[player->entindex() - 1];
+        if (entry.m_Valid && entry.m_Team != player->GetTeam())
+            entry.m_Valid = false;
+    }
 }
 
 const char* PlayerAliases::GetAlias(const CSteamID& player) const
@@ -184,6 +254,7 @@ void PlayerAliases::AddPlayerAlias(const CCommand& brokenCommand)
         m_CustomAliases.insert(std::make_pair(id, name));
     }
 
+    InvalidateNameCache();
     return;
 }
 
@@ -216,6 +287,7 @@ void PlayerAliases::RemovePlayerAlias(const CCommand& brokenCommand)
             }
         }
 
+        InvalidateNameCache();
         return;
     }
 
@@ -238,4 +310,9 @@ void PlayerAliases::FindAndReplaceInString(std::string& str, const std::string_v
     }
 }
 
-void PlayerAliases::ToggleEnabled(const ConVar* var) { m_GetPlayerInfoHook.SetEnabled(var->GetBool()); }
\ No newline at end of file
+void PlayerAliases::ToggleEnabled(const ConVar* var)
+{
+    InvalidateNameCache();
+    m_GetPlayerInfoHook.SetEnabled(var->GetBool());
+    m_UserInfoChangedHook.SetEnabled(var->GetBool());
+}
\ No newline at end of file
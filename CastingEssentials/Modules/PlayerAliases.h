@@ -1,10 +1,17 @@
 #pragma once
 #include "PluginBase/Hook.h"
 #include "PluginBase/Modules.h"
+#include "PluginBase/TypedConVar.h"
 
+#include <cdll_int.h>
 #include <convar.h>
+#include <shareddefs.h>
+
+#include <array>
 
 struct player_info_s;
+class INetworkStringTable;
+enum class TFTeam;
 
 class PlayerAliases final : public Module<PlayerAliases>
 {
@@ -15,18 +22,46 @@ public:
     static bool CheckDependencies();
     static constexpr __forceinline const char* GetModuleName() { return "Player Aliases"; }
 
+protected:
+    void OnTick(bool inGame) override;
+    void LevelInit() override { InvalidateNameCache(); }
+    void LevelShutdown() override { InvalidateNameCache(); }
+
 private:
     bool GetPlayerInfoOverride(int ent_num, player_info_s* pInfo);
+    void UserInfoChangedCallbackOverride(void*, INetworkStringTable* stringTable, int stringNumber,
+                                         const char* newString, const void* newData);
 
     std::map<CSteamID, std::string> m_CustomAliases;
-    Hook<HookFunc::IVEngineClient_GetPlayerInfo> m_GetPlayerInfoHook;
+    Hook<HookFunc::IVEngineClient_GetPlayerInfo, &PlayerAliases::GetPlayerInfoOverride> m_GetPlayerInfoHook;
+    Hook<HookFunc::Global_UserInfoChangedCallback, &PlayerAliases::UserInfoChangedCallbackOverride>
+        m_UserInfoChangedHook;
+
+    // Final formatted names, indexed by entindex - 1. Rebuilt lazily in GetPlayerInfoOverride after being
+    // invalidated by a userinfo change, team change, alias add/remove or format convar change.
+    struct NameCacheEntry
+    {
+        bool m_Valid;
+        bool m_Override; // False if the format doesn't apply to this player and the engine name should be used
+        TFTeam m_Team;
+        char m_Name[MAX_PLAYER_NAME_LENGTH];
+    };
+    std::array<NameCacheEntry, MAX_PLAYERS> m_NameCache;
+    void InvalidateNameCache();
+    void BuildNameCacheEntry(NameCacheEntry& entry, TFTeam team, const player_info_s& info) const;
 
     static void FindAndReplaceInString(std::string& str, const std::string_view& find, const std::string_view& replace);
 
     const char* GetAlias(const CSteamID& player) const;
 
+    enum class FormatMode
+    {
+        AllPlayers = 0,
+        AliasedOnly = 1,
+    };
+
     ConVar ce_playeraliases_enabled;
-    ConVar ce_playeraliases_format_mode;
+    TypedConVar<FormatMode> ce_playeraliases_format_mode;
     ConVar ce_playeraliases_format_blu;
     ConVar ce_playeraliases_format_red;
 
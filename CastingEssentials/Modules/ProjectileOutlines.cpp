@@ -1,5 +1,6 @@
 #include "ProjectileOutlines.h"
 #include "PluginBase/Entities.h"
+#include "PluginBase/FrameArena.h"
 #include "PluginBase/Interfaces.h"
 #include "PluginBase/TFDefinitions.h"
 
@@ -10,7 +11,7 @@
 // smh windows
 #undef IGNORE
 
-MODULE_REGISTER(ProjectileOutlines);
+MODULE_REGISTER_LAZY(ProjectileOutlines);
 
 EntityOffset<bool> ProjectileOutlines::s_GlowDisabledOffset;
 EntityOffset<int> ProjectileOutlines::s_GlowModeOffset;
@@ -20,42 +21,53 @@ EntityOffset<Color> ProjectileOutlines::s_GlowColorOffset;
 EntityOffset<TFGrenadePipebombType> ProjectileOutlines::s_PipeTypeOffset;
 const ClientClass* ProjectileOutlines::s_RocketType;
 
+ConVar ProjectileOutlines::ce_projectileoutlines_rockets("ce_projectileoutlines_rockets", "0", FCVAR_NONE,
+                                                         "Enable projectile outlines for rockets.",
+                                                         [](IConVar*, const char*, float) { UpdateEnabled(); });
+ConVar ProjectileOutlines::ce_projectileoutlines_pills("ce_projectileoutlines_pills", "0", FCVAR_NONE,
+                                                       "Enable projectile outlines for pills.",
+                                                       [](IConVar*, const char*, float) { UpdateEnabled(); });
+ConVar ProjectileOutlines::ce_projectileoutlines_stickies("ce_projectileoutlines_stickies", "0", FCVAR_NONE,
+                                                          "Enable projectile outlines for stickies.",
+                                                          [](IConVar*, const char*, float) { UpdateEnabled(); });
+
+ConVar ProjectileOutlines::ce_projectileoutlines_color_blu(
+    "ce_projectileoutlines_color_blu", "125 169 197 255", FCVAR_NONE,
+    "The color used for outlines of BLU team's projectiles.",
+    [](IConVar* var, const char* pOld, float) { ColorChanged(static_cast<ConVar*>(var), pOld); });
+ConVar ProjectileOutlines::ce_projectileoutlines_color_red(
+    "ce_projectileoutlines_color_red", "189 55 55 255", FCVAR_NONE,
+    "The color used for outlines of RED team's projectiles.",
+    [](IConVar* var, const char* pOld, float) { ColorChanged(static_cast<ConVar*>(var), pOld); });
+ConVar ProjectileOutlines::ce_projectileoutlines_fade_start(
+    "ce_projectileoutlines_fade_start", "-1", FCVAR_NONE,
+    "Distance from the camera at which projectile outlines begin fading out.");
+ConVar ProjectileOutlines::ce_projectileoutlines_fade_end(
+    "ce_projectileoutlines_fade_end", "-1", FCVAR_NONE,
+    "Distance from the camera at which projectile outlines finish fading out.");
+
+ConVar ProjectileOutlines::ce_projectileoutlines_mode("ce_projectileoutlines_mode", "1", FCVAR_NONE,
+                                                      "Modes:"
+                                                      "\n\t0: always"
+                                                      "\n\t1: only when occluded"
+                                                      "\n\t2: only when model is visible",
+                                                      true, 0, true, 2);
+
 ProjectileOutlines::ProjectileOutlines()
-    : ce_projectileoutlines_rockets("ce_projectileoutlines_rockets", "0", FCVAR_NONE,
-                                    "Enable projectile outlines for rockets.",
-                                    [](IConVar*, const char*, float) { GetModule()->UpdateEnabled(); }),
-      ce_projectileoutlines_pills("ce_projectileoutlines_pills", "0", FCVAR_NONE,
-                                  "Enable projectile outlines for pills.",
-                                  [](IConVar*, const char*, float) { GetModule()->UpdateEnabled(); }),
-      ce_projectileoutlines_stickies("ce_projectileoutlines_stickies", "0", FCVAR_NONE,
-                                     "Enable projectile outlines for stickies.",
-                                     [](IConVar*, const char*, float) { GetModule()->UpdateEnabled(); }),
-
-      ce_projectileoutlines_color_blu(
-          "ce_projectileoutlines_color_blu", "125 169 197 255", FCVAR_NONE,
-          "The color used for outlines of BLU team's projectiles.",
-          [](IConVar* var, const char* pOld, float) { GetModule()->ColorChanged(static_cast<ConVar*>(var), pOld); }),
-      ce_projectileoutlines_color_red(
-          "ce_projectileoutlines_color_red", "189 55 55 255", FCVAR_NONE,
-          "The color used for outlines of RED team's projectiles.",
-          [](IConVar* var, const char* pOld, float) { GetModule()->ColorChanged(static_cast<ConVar*>(var), pOld); }),
-      ce_projectileoutlines_fade_start("ce_projectileoutlines_fade_start", "-1", FCVAR_NONE,
-                                       "Distance from the camera at which projectile outlines begin fading out."),
-      ce_projectileoutlines_fade_end("ce_projectileoutlines_fade_end", "-1", FCVAR_NONE,
-                                     "Distance from the camera at which projectile outlines finish fading out."),
-
-      ce_projectileoutlines_mode("ce_projectileoutlines_mode", "1", FCVAR_NONE,
-                                 "Modes:"
-                                 "\n\t0: always"
-                                 "\n\t1: only when occluded"
-                                 "\n\t2: only when model is visible",
-                                 true, 0, true, 2),
-
-      m_BaseEntityInitHook(std::bind(&ProjectileOutlines::InitDetour, this, std::placeholders::_1,
-                                     std::placeholders::_2, std::placeholders::_3))
+    : m_BaseEntityInitHook(this)
 {
-    ColorChanged(&ce_projectileoutlines_color_blu, "");
-    ColorChanged(&ce_projectileoutlines_color_red, "");
+    ColorFromConVar(ce_projectileoutlines_color_blu, m_ColorBlu);
+    ColorFromConVar(ce_projectileoutlines_color_red, m_ColorRed);
+}
+
+ProjectileOutlines::~ProjectileOutlines()
+{
+    // We're destroyed whenever every outline type is turned off, so don't leave our glows behind
+    for (const auto& glow : m_GlowEntities)
+    {
+        if (C_BaseEntity* glowEntity = glow.second.Get())
+            glowEntity->Release();
+    }
 }
 
 bool ProjectileOutlines::CheckDependencies()
@@ -109,7 +121,7 @@ void ProjectileOutlines::OnTick(bool inGame)
 
         // Remove glows for dead entities
         {
-            std::vector<int> toEraseList;
+            ArenaVector<int> toEraseList(FrameArena::GetTickArena());
             for (const auto& glow : m_GlowEntities)
             {
                 if (EHANDLE::FromIndex(glow.first).Get())
@@ -256,10 +268,14 @@ void ProjectileOutlines::ColorChanged(ConVar* var, const char* oldValue)
     if (!ColorFromConVar(*var, scannedColor))
         goto Usage;
 
-    if (var == &ce_projectileoutlines_color_blu)
-        m_ColorBlu = scannedColor;
-    else if (var == &ce_projectileoutlines_color_red)
-        m_ColorRed = scannedColor;
+    // Picked up by the constructor if we're dormant
+    if (auto module = TryGetModule())
+    {
+        if (var == &ce_projectileoutlines_color_blu)
+            module->m_ColorBlu = scannedColor;
+        else if (var == &ce_projectileoutlines_color_red)
+            module->m_ColorRed = scannedColor;
+    }
 
     return;
 
@@ -270,6 +286,9 @@ Usage:
 
 void ProjectileOutlines::UpdateEnabled()
 {
-    m_BaseEntityInitHook.SetEnabled(ce_projectileoutlines_pills.GetBool() || ce_projectileoutlines_rockets.GetBool() ||
-                                    ce_projectileoutlines_stickies.GetBool());
+    const bool enabled = ce_projectileoutlines_pills.GetBool() || ce_projectileoutlines_rockets.GetBool() ||
+                         ce_projectileoutlines_stickies.GetBool();
+
+    Modules().UpdateLazyModule<ProjectileOutlines>(
+        enabled, [&](ProjectileOutlines* module) { module->m_BaseEntityInitHook.SetEnabled(enabled); });
 }
@@ -18,22 +18,23 @@ class ProjectileOutlines final : public Module<ProjectileOutlines>
 {
 public:
     ProjectileOutlines();
+    ~ProjectileOutlines();
 
     static bool CheckDependencies();
     static constexpr __forceinline const char* GetModuleName() { return "Projectile Outlines"; }
 
 private:
-    ConVar ce_projectileoutlines_rockets;
-    ConVar ce_projectileoutlines_pills;
-    ConVar ce_projectileoutlines_stickies;
+    static ConVar ce_projectileoutlines_rockets;
+    static ConVar ce_projectileoutlines_pills;
+    static ConVar ce_projectileoutlines_stickies;
 
-    ConVar ce_projectileoutlines_mode;
+    static ConVar ce_projectileoutlines_mode;
 
-    ConVar ce_projectileoutlines_color_blu;
-    ConVar ce_projectileoutlines_color_red;
+    static ConVar ce_projectileoutlines_color_blu;
+    static ConVar ce_projectileoutlines_color_red;
 
-    ConVar ce_projectileoutlines_fade_start;
-    ConVar ce_projectileoutlines_fade_end;
+    static ConVar ce_projectileoutlines_fade_start;
+    static ConVar ce_projectileoutlines_fade_end;
 
     void OnTick(bool inGame) override;
 
@@ -48,19 +49,19 @@ private:
     static constexpr int MAGIC_ENTNUM = 0x141BCF9B;
     static constexpr int MAGIC_SERIALNUM = 0x0FCAD8B9;
 
-    Hook<HookFunc::C_BaseEntity_Init> m_BaseEntityInitHook;
     bool InitDetour(C_BaseEntity* pThis, int entnum, int iSerialNum);
+    Hook<HookFunc::C_BaseEntity_Init, &ProjectileOutlines::InitDetour> m_BaseEntityInitHook;
 
     // List of entities that had C_BaseEntity::Init() called on them since our last
     // pass through OnTick()
     std::vector<int> m_NewEntities;
 
     bool m_Init;
-    void ColorChanged(ConVar* var, const char* oldValue);
+    static void ColorChanged(ConVar* var, const char* oldValue);
     Color m_ColorRed;
     Color m_ColorBlu;
 
-    void UpdateEnabled();
+    static void UpdateEnabled();
 
     static EntityOffset<bool> s_GlowDisabledOffset;
     static EntityOffset<int> s_GlowModeOffset;
@@ -12,31 +12,23 @@
 #include <tier2/beamsegdraw.h>
 #include <toolframework/ienginetool.h>
 
-MODULE_REGISTER(SniperLOS);
+MODULE_REGISTER_LAZY(SniperLOS);
 
 EntityTypeChecker SniperLOS::s_SniperRifleType;
 
-SniperLOS::SniperLOS()
-    : ce_sniperlos_enabled(
-          "ce_sniperlos_enabled", "0", FCVAR_NONE, "Enables drawing beams representing sniper line of sight.",
-          [](IConVar* var, const char*, float) { GetModule()->ToggleEnabled(static_cast<ConVar*>(var)); }),
-      ce_sniperlos_width("ce_sniperlos_width", "5", FCVAR_NONE, "Width of the sniper line of sight beam."),
-
-      ce_sniperlos_color_blu("ce_sniperlos_color_blu", "125 169 197 255", FCVAR_NONE,
-                             "RGBA color for the blue sniper line of sight beams.",
-                             [](IConVar* var, const char*, float) {
-                                 ColorFromConVar(*static_cast<ConVar*>(var), GetModule()->m_BeamColorBlue);
-                             }),
-      ce_sniperlos_color_red("ce_sniperlos_color_red", "185 55 55 255", FCVAR_NONE,
-                             "RGBA color for the red sniper line of sight beams.",
-                             [](IConVar* var, const char*, float) {
-                                 ColorFromConVar(*static_cast<ConVar*>(var), GetModule()->m_BeamColorRed);
-                             })
-{
-    // Initialize with defaults
-    ColorFromConVar(ce_sniperlos_color_blu, m_BeamColorBlue);
-    ColorFromConVar(ce_sniperlos_color_red, m_BeamColorRed);
-}
+ConVar SniperLOS::ce_sniperlos_enabled(
+    "ce_sniperlos_enabled", "0", FCVAR_NONE, "Enables drawing beams representing sniper line of sight.",
+    [](IConVar* var, const char*, float)
+    {
+        const auto enabled = static_cast<ConVar*>(var);
+        Modules().UpdateLazyModule<SniperLOS>(enabled->GetBool(),
+                                              [&](SniperLOS* module) { module->ToggleEnabled(enabled); });
+    });
+ConVar SniperLOS::ce_sniperlos_width("ce_sniperlos_width", "5", FCVAR_NONE, "Width of the sniper line of sight beam.");
+TypedConVar<Color> SniperLOS::ce_sniperlos_color_blu("ce_sniperlos_color_blu", "125 169 197 255", FCVAR_NONE,
+                                                     "RGBA color for the blue sniper line of sight beams.");
+TypedConVar<Color> SniperLOS::ce_sniperlos_color_red("ce_sniperlos_color_red", "185 55 55 255", FCVAR_NONE,
+                                                     "RGBA color for the red sniper line of sight beams.");
 
 bool SniperLOS::CheckDependencies()
 {
@@ -62,9 +54,9 @@ void SniperLOS::LOSRenderer::PostRender()
     IMaterial* beamMaterial = materials->FindMaterial("castingessentials/sniperlos/beam", TEXTURE_GROUP_OTHER, true);
 
     const auto curtime = Interfaces::GetEngineTool()->ClientTime();
-    const float beamWidth = GetModule()->ce_sniperlos_width.GetFloat();
-    const auto& beamColorBlue = GetModule()->m_BeamColorBlue;
-    const auto& beamColorRed = GetModule()->m_BeamColorRed;
+    const float beamWidth = ce_sniperlos_width.GetFloat();
+    const auto& beamColorBlue = ce_sniperlos_color_blu.GetValue();
+    const auto& beamColorRed = ce_sniperlos_color_red.GetValue();
     const auto specTarget = CameraState::GetLocalObserverTarget(true);
 
     for (const auto& player : Player::Iterable())
@@ -2,6 +2,7 @@
 
 #include "PluginBase/EntityOffset.h"
 #include "PluginBase/Modules.h"
+#include "PluginBase/TypedConVar.h"
 
 #include <convar.h>
 #include <igamesystem.h>
@@ -11,8 +12,6 @@
 class SniperLOS : public Module<SniperLOS>
 {
 public:
-    SniperLOS();
-
     static bool CheckDependencies();
     static constexpr __forceinline const char* GetModuleName() { return "Sniper LOS Beams"; }
 
@@ -30,11 +29,8 @@ private:
 
     void ToggleEnabled(const ConVar* var);
 
-    ConVar ce_sniperlos_enabled;
-    ConVar ce_sniperlos_width;
-    ConVar ce_sniperlos_color_blu;
-    ConVar ce_sniperlos_color_red;
-
-    Color m_BeamColorBlue;
-    Color m_BeamColorRed;
+    static ConVar ce_sniperlos_enabled;
+    static ConVar ce_sniperlos_width;
+    static TypedConVar<Color> ce_sniperlos_color_blu;
+    static TypedConVar<Color> ce_sniperlos_color_red;
 };
@@ -1,11 +1,11 @@
 #include <Modules/SrcTVPlus.h>
 #include <PluginBase/Interfaces.h>
-#include <PluginBase/VariablePusher.h>
 #include <client/c_baseentity.h>
 #include <client/c_baseplayer.h>
-#include <set>
 #include <toolframework/ienginetool.h>
 
+#include <array>
+
 MODULE_REGISTER(SrcTVPlus);
 
 bool SrcTVPlus::s_Detected = false;
@@ -26,23 +26,86 @@ void SrcTVPlus::SetDetected(bool value, bool force_broadcast)
 }
 
 static RecvProp* g_Prop = nullptr;
-static VariablePusher<RecvVarProxyFn> g_ProxyPusher;
-static std::map<int, int> g_SeenEntities; // Entity ID + serial -> number of times seen
 
-void SrcTVPlus::DetectorProxy(const CRecvProxyData* pData, void* pStruct, void* pOut)
+// Number of m_nTickBase updates for a non-local player before we consider SrcTV+ present
+static constexpr int DETECTION_THRESHOLD = 10;
+
+// Indexed by entindex. The serial number guards against a slot being reused by a new entity mid-detection.
+struct SeenSlot
+{
+    int m_SerialNumber;
+    int m_Count;
+};
+static std::array<SeenSlot, MAX_PLAYERS + 1> g_SeenSlots;
+
+static struct
+{
+    double m_EnabledTime;
+    int m_EnabledTick;
+
+    float m_LatencySeconds;
+    int m_LatencyTicks;
+
+    int m_ProxyCalls;
+    int m_IgnoredUpdates;   // Local player
+    int m_StaleSlotResets;  // Slot was reused by a different entity before hitting the threshold
+    int m_PartialSightings; // Slots that were seen, but never reached the threshold before the detector was disabled
+} g_DetectorStats;
+
+SrcTVPlus::SrcTVPlus()
+    : ce_srctvplus_status(
+          "ce_srctvplus_status", []() { GetModule()->PrintStatus(); },
+          "Prints SrcTV+ detection state, detection latency and false positive counters."),
+      m_DetectorProxy(
+          g_Prop,
+          [this](const CRecvProxyData* pData, void* pStruct, void* pOut, const RecvProxyRouter::Next& next)
+          { DetectorProxy(pData, pStruct, pOut, next); },
+          RecvProxyRouter::SlotRange::Players())
+{
+}
+
+void SrcTVPlus::DetectorProxy(const CRecvProxyData* pData, void* pStruct, void* pOut,
+                              const RecvProxyRouter::Next& next)
 {
-    auto ent = static_cast<C_BasePlayer*>(pStruct);
-    if (pData->m_ObjectID != Interfaces::GetEngineClient()->GetLocalPlayer())
+    g_DetectorStats.m_ProxyCalls++;
+
+    const int slot = pData->m_ObjectID;
+    if (slot < 1 || slot >= (int)g_SeenSlots.size() || slot == Interfaces::GetEngineClient()->GetLocalPlayer())
     {
-        auto id = ent->GetRefEHandle().ToInt();
-        if (++g_SeenEntities[id] >= 10)
+        g_DetectorStats.m_IgnoredUpdates++;
+    }
+    else
+    {
+        const int serial = static_cast<C_BasePlayer*>(pStruct)->GetRefEHandle().GetSerialNumber();
+
+        auto& seen = g_SeenSlots[slot];
+        if (seen.m_SerialNumber != serial)
         {
-            SrcTVPlus::DisableDetector();
-            PluginMsg("SrcTV+ detected\n");
+            if (seen.m_Count > 0)
+                g_DetectorStats.m_StaleSlotResets++;
+
+            seen.m_SerialNumber = serial;
+            seen.m_Count = 0;
+        }
+
+        if (++seen.m_Count >= DETECTION_THRESHOLD)
+        {
+            g_DetectorStats.m_LatencySeconds = float(Plat_FloatTime() - g_DetectorStats.m_EnabledTime);
+            g_DetectorStats.m_LatencyTicks =
+                Interfaces::GetEngineTool()->ClientTick() - g_DetectorStats.m_EnabledTick;
+
+            // Safe to unsubscribe from inside our own callback, next() still passes the update on
+            DisableDetector();
+            PluginMsg("SrcTV+ detected after %1.2f seconds (%i ticks)\n", g_DetectorStats.m_LatencySeconds,
+                      g_DetectorStats.m_LatencyTicks);
             SrcTVPlus::SetDetected(true);
+
+            next(pData, pStruct, pOut);
+            return;
         }
     }
-    g_ProxyPusher.GetOldValue()(pData, pStruct, pOut);
+
+    next(pData, pStruct, pOut);
 }
 
 bool SrcTVPlus::CheckDependencies()
@@ -68,14 +131,57 @@ void SrcTVPlus::EnableDetector()
 {
     if (s_Detected)
         return; // Already detected, no need to enable
-    if (!g_ProxyPusher.IsEmpty())
+    if (m_DetectorProxy.IsEnabled())
         return; // Already enabled
-    g_SeenEntities.clear();
-    g_ProxyPusher = CreateVariablePusher(g_Prop->m_ProxyFn, &DetectorProxy);
+
+    g_SeenSlots = {};
+    g_DetectorStats = {};
+    g_DetectorStats.m_EnabledTime = Plat_FloatTime();
+    g_DetectorStats.m_EnabledTick = Interfaces::GetEngineTool()->ClientTick();
+    g_DetectorStats.m_LatencySeconds = -1;
+    g_DetectorStats.m_LatencyTicks = -1;
+
+    m_DetectorProxy.Enable();
 }
 
 void SrcTVPlus::DisableDetector()
 {
-    g_ProxyPusher.Clear();
-    g_SeenEntities.clear();
-}
\ No newline at end of file
+    if (!m_DetectorProxy.IsEnabled())
+        return;
+
+    m_DetectorProxy.Disable();
+
+    // Only interesting if we never detected anything, otherwise these are just players we hadn't gotten to yet
+    if (g_DetectorStats.m_LatencyTicks < 0)
+    {
+        for (const auto& seen : g_SeenSlots)
+        {
+            if (seen.m_Count > 0)
+                g_DetectorStats.m_PartialSightings++;
+        }
+    }
+}
+
+void SrcTVPlus::PrintStatus() const
+{
+    Msg("SrcTV+ %s, detector %s\n", s_Detected ? "detected" : "not detected",
+        m_DetectorProxy.IsEnabled() ? "active" : "inactive");
+
+    if (g_DetectorStats.m_LatencyTicks >= 0)
+    {
+        Msg("    Detection latency: %1.3f seconds (%i ticks)\n", g_DetectorStats.m_LatencySeconds,
+            g_DetectorStats.m_LatencyTicks);
+    }
+    else if (m_DetectorProxy.IsEnabled())
+    {
+        Msg("    Detector running for: %1.3f seconds (%i ticks)\n",
+            float(Plat_FloatTime() - g_DetectorStats.m_EnabledTime),
+            Interfaces::GetEngineTool()->ClientTick() - g_DetectorStats.m_EnabledTick);
+    }
+
+    Msg("    Proxy calls: %i\n", g_DetectorStats.m_ProxyCalls);
+    Msg("    Ignored updates (local player): %i\n", g_DetectorStats.m_IgnoredUpdates);
+    Msg("    Stale slot resets: %i\n", g_DetectorStats.m_StaleSlotResets);
+    Msg("    Partial sightings (below threshold of %i): %i\n", DETECTION_THRESHOLD,
+        g_DetectorStats.m_PartialSightings);
+}
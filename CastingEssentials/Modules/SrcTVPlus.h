@@ -3,6 +3,10 @@
 
 #include "PluginBase/Entities.h"
 #include "PluginBase/Modules.h"
+#include "PluginBase/RecvProxyRouter.h"
+
+#include <convar.h>
+
 #include <map>
 
 class SrcTVPlusListener;
@@ -40,6 +44,8 @@ protected:
 
     // Module implementation
 public:
+    SrcTVPlus();
+
     static bool CheckDependencies();
     static constexpr __forceinline const char* GetModuleName() { return "SrcTV+ detection"; }
 
@@ -56,9 +62,9 @@ protected:
         DisableDetector();
     }
 
-    static void EnableDetector();
-    static void DisableDetector();
-    static void DetectorProxy(const CRecvProxyData* pData, void* pStruct, void* pOut);
+    void EnableDetector();
+    void DisableDetector();
+    void DetectorProxy(const CRecvProxyData* pData, void* pStruct, void* pOut, const RecvProxyRouter::Next& next);
 
 private:
     static bool s_Detected;
@@ -67,6 +73,11 @@ private:
 
     static void NotifyListeners();
     static void SetDetected(bool value, bool force_broadcast = false);
+
+    ConCommand ce_srctvplus_status;
+    void PrintStatus() const;
+
+    RecvProxySubscription m_DetectorProxy;
 };
 
 class SrcTVPlusListener
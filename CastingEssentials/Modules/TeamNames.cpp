@@ -1,7 +1,5 @@
 #include "TeamNames.h"
 
-#include <vprof.h>
-
 MODULE_REGISTER(TeamNames);
 
 // Hi we're TOTALLY not hijacking a friend class that's eventually only declared in a cpp file
@@ -19,8 +17,10 @@ public:
 };
 
 TeamNames::TeamNames()
-    : m_OverrideCvars{ConVar("ce_teamnames_blu", "", FCVAR_NONE, "Overrides mp_tournament_blueteamname."),
-                      ConVar("ce_teamnames_red", "", FCVAR_NONE, "Overrides mp_tournament_redteamname.")},
+    : m_OverrideCvars{ConVar("ce_teamnames_blu", "", FCVAR_NONE, "Overrides mp_tournament_blueteamname.",
+                             [](IConVar*, const char*, float) { GetModule()->ApplyOverride(TeamConvars::Blue); }),
+                      ConVar("ce_teamnames_red", "", FCVAR_NONE, "Overrides mp_tournament_redteamname.",
+                             [](IConVar*, const char*, float) { GetModule()->ApplyOverride(TeamConvars::Red); })},
 
       ce_teamnames_swap(
           "ce_teamnames_swap", []() { GetModule()->SwapTeamNames(); },
@@ -28,6 +28,28 @@ TeamNames::TeamNames()
 {
     m_OriginalCvars[(int)TeamConvars::Blue] = g_pCVar->FindVar("mp_tournament_blueteamname");
     m_OriginalCvars[(int)TeamConvars::Red] = g_pCVar->FindVar("mp_tournament_redteamname");
+
+    // The originals are replicated from the server, so chain onto their change callbacks rather
+    // than polling them every tick.
+    for (int t = 0; t < TeamConvars::Count; t++)
+    {
+        m_LastServerValues[t] = m_OriginalCvars[t]->GetString();
+        m_OriginalCallbacks[t] = CCvar::GetChangeCallback(*m_OriginalCvars[t]);
+        CCvar::SetChangeCallback(*m_OriginalCvars[t], &OriginalChanged);
+    }
+}
+
+TeamNames::~TeamNames()
+{
+    for (int t = 0; t < TeamConvars::Count; t++)
+    {
+        if (CCvar::GetChangeCallback(*m_OriginalCvars[t]) == &OriginalChanged)
+            CCvar::SetChangeCallback(*m_OriginalCvars[t], m_OriginalCallbacks[t]);
+
+        // Don't leave our override behind once we're gone
+        if (!IsStringEmpty(m_OverrideCvars[t].GetString()))
+            m_OriginalCvars[t]->SetValue(m_LastServerValues[t].c_str());
+    }
 }
 
 void TeamNames::SwapTeamNames()
@@ -35,23 +57,37 @@ void TeamNames::SwapTeamNames()
     SwapConVars(m_OverrideCvars[(int)TeamConvars::Red], m_OverrideCvars[(int)TeamConvars::Blue]);
 }
 
-void TeamNames::OnTick(bool inGame)
+void TeamNames::OriginalChanged(IConVar* var, const char* oldValue, float oldFloatValue)
 {
-    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    auto module = GetModule();
     for (TeamConvars::Enum t = (TeamConvars::Enum)0; t < TeamConvars::Count; (*((int*)&t))++)
     {
-        const bool originalChanged = !!m_LastServerValues[t].compare(m_OriginalCvars[t]->GetString()) &&
-                                     !!m_LastOverrideValues[t].compare(m_OriginalCvars[t]->GetString());
-        if (originalChanged)
-            m_LastServerValues[t] = m_OriginalCvars[t]->GetString();
+        if (var != module->m_OriginalCvars[t])
+            continue;
 
-        const bool newOverride = !!m_LastOverrideValues[t].compare(m_OverrideCvars[t].GetString());
-        if (newOverride)
-            m_LastOverrideValues[t] = m_OverrideCvars[t].GetString();
+        if (auto callback = module->m_OriginalCallbacks[t])
+            callback(var, oldValue, oldFloatValue);
 
-        if (IsStringEmpty(m_OverrideCvars[t].GetString()))
-            m_OriginalCvars[t]->SetValue(m_LastServerValues[t].c_str());
-        else
-            m_OriginalCvars[t]->SetValue(m_OverrideCvars[t].GetString());
+        // Ignore the change we're in the middle of making ourselves
+        if (module->m_Writing)
+            return;
+
+        module->m_LastServerValues[t] = module->m_OriginalCvars[t]->GetString();
+        module->ApplyOverride(t);
+        return;
     }
-}
\ No newline at end of file
+}
+
+void TeamNames::ApplyOverride(TeamConvars::Enum team)
+{
+    const char* overrideValue = m_OverrideCvars[team].GetString();
+    const char* value = IsStringEmpty(overrideValue) ? m_LastServerValues[team].c_str() : overrideValue;
+
+    // Setting the value fires the engine's change callbacks, so only do it when it actually differs
+    if (!strcmp(m_OriginalCvars[team]->GetString(), value))
+        return;
+
+    m_Writing = true;
+    m_OriginalCvars[team]->SetValue(value);
+    m_Writing = false;
+}
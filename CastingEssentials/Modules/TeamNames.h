@@ -7,6 +7,8 @@ class TeamNames final : public Module<TeamNames>
 {
 public:
     TeamNames();
+    ~TeamNames();
+
     static constexpr __forceinline const char* GetModuleName() { return "Team Names"; }
 
 private:
@@ -27,8 +29,11 @@ private:
     ConCommand ce_teamnames_swap;
     void SwapTeamNames();
 
-    std::string m_LastServerValues[(int)TeamConvars::Count];
-    std::string m_LastOverrideValues[TeamConvars::Count];
+    // Last value the server (or anyone else) set, so it can be put back when an override is cleared
+    std::string m_LastServerValues[TeamConvars::Count];
+    FnChangeCallback_t m_OriginalCallbacks[TeamConvars::Count];
+    bool m_Writing = false;
 
-    void OnTick(bool inGame) override;
+    static void OriginalChanged(IConVar* var, const char* oldValue, float oldFloatValue);
+    void ApplyOverride(TeamConvars::Enum team);
 };
\ No newline at end of file
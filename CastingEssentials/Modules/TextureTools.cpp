@@ -14,10 +14,7 @@ TextureTools::TextureTools()
           "before the first map load. Changing after that requires a game restart.",
           [](IConVar*, const char*, float) { GetModule()->ToggleFullResRTs(); }),
 
-      m_CreateRenderTargetsHook(std::bind(&TextureTools::InitClientRenderTargetsOverride, this, std::placeholders::_1,
-                                          std::placeholders::_2, std::placeholders::_3, std::placeholders::_4,
-                                          std::placeholders::_5),
-                                false)
+      m_CreateRenderTargetsHook(this, false)
 {
 }
 
@@ -17,12 +17,13 @@ public:
     static constexpr __forceinline const char* GetModuleName() { return "Texture Tools"; }
 
 private:
-    Hook<HookFunc::CBaseClientRenderTargets_InitClientRenderTargets> m_CreateRenderTargetsHook;
-
     void ToggleFullResRTs();
     void InitClientRenderTargetsOverride(CBaseClientRenderTargets* pThis, IMaterialSystem* pMaterialSystem,
                                          IMaterialSystemHardwareConfig* config, int waterRes, int cameraRes);
 
+    Hook<HookFunc::CBaseClientRenderTargets_InitClientRenderTargets, &TextureTools::InitClientRenderTargetsOverride>
+        m_CreateRenderTargetsHook;
+
     CTextureReference m_FullFrameDepth;
 
     ConVar ce_texturetools_full_res_rts;
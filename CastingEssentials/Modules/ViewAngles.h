@@ -1,13 +1,11 @@
 #pragma once
 #include "PluginBase/EntityOffset.h"
 #include "PluginBase/Modules.h"
+#include "PluginBase/RecvProxyRouter.h"
 
 #include <convar.h>
 #include <dt_recv.h>
 
-#include <map>
-#include <optional>
-
 class ConCommand;
 class IConVar;
 
@@ -19,15 +17,9 @@ public:
     static bool CheckDependencies();
     static constexpr __forceinline const char* GetModuleName() { return "High-Precision View Angles"; }
 
-protected:
-    void OnTick(bool inGame) override;
-    void LevelShutdown() override;
-
 private:
     static EntityOffset<float> s_EyeAngles0Offset;
     static EntityOffset<float> s_EyeAngles1Offset;
-    static EntityOffset<float> s_KartBoostOffset;
-    static EntityOffset<float> s_KartHealthOffset;
 
     static RecvProp* s_EyeAngles0Prop;
     static RecvProp* s_EyeAngles1Prop;
@@ -37,16 +29,13 @@ private:
     ConVar ce_viewangles_enabled;
     void ToggleEnabled(const ConVar* var);
 
-    std::optional<VariablePusher<RecvVarProxyFn>> m_EyeAngles0Proxy;
-    std::optional<VariablePusher<RecvVarProxyFn>> m_EyeAngles1Proxy;
-    std::optional<VariablePusher<RecvVarProxyFn>> m_KartBoostProxy;
-    std::optional<VariablePusher<RecvVarProxyFn>> m_KartHealthProxy;
-
-    std::map<void*, IClientNetworkable*> m_KartBoostMap;
-    std::map<void*, IClientNetworkable*> m_KartHealthMap;
+    RecvProxySubscription m_EyeAngles0Proxy;
+    RecvProxySubscription m_EyeAngles1Proxy;
+    RecvProxySubscription m_KartBoostProxy;
+    RecvProxySubscription m_KartHealthProxy;
 
-    static void EyeAngles0Proxy(const CRecvProxyData* pData, void* pStruct, void* pOut);
-    static void EyeAngles1Proxy(const CRecvProxyData* pData, void* pStruct, void* pOut);
-    static void KartBoostProxy(const CRecvProxyData* pData, void* pStruct, void* pOut);
-    static void KartHealthProxy(const CRecvProxyData* pData, void* pStruct, void* pOut);
+    using Next = RecvProxyRouter::Next;
+    static void EyeAnglesProxy(const CRecvProxyData* pData, void* pStruct, void* pOut, const Next& next);
+    static void KartBoostProxy(const CRecvProxyData* pData, void* pStruct, void* pOut, const Next& next);
+    static void KartHealthProxy(const CRecvProxyData* pData, void* pStruct, void* pOut, const Next& next);
 };
\ No newline at end of file
@@ -24,7 +24,14 @@ WeaponTools::WeaponTools()
       ce_weapon_skin_downsample(
           "ce_weapon_skin_downsample", "2", FCVAR_NONE, "Downsample the skins for other players by this many mips.",
           true, 0, true, 10,
-          [](IConVar* var, const char*, float) { GetModule()->SkinDownsampleChanged(static_cast<ConVar*>(var)); })
+          [](IConVar* var, const char*, float) { GetModule()->SkinDownsampleChanged(static_cast<ConVar*>(var)); }),
+      m_InspectStageProxy(Entities::FindRecvProp("CTFWeaponBase", "m_nInspectStage", false),
+                          [](const CRecvProxyData*, void*, void* out, const RecvProxyRouter::Next&)
+                          { *(int*)out = (int)InspectStage::None; }),
+      m_ViewModelSequenceProxy(Entities::FindRecvProp("CBaseViewModel", "m_nSequence", false),
+                               [this](const CRecvProxyData* data, void* pStruct, void* out,
+                                      const RecvProxyRouter::Next& next)
+                               { RecvProxy_SequenceNum_Override(data, pStruct, out, next); })
 
 // ce_weapon_inspect_force("ce_weapon_inspect_force", []() { GetModule()->ForceInspectWeapon(); }, "Start inspecting the
 // player's weapon.")
@@ -123,7 +130,8 @@ static bool ShouldDisableActivity(Activity inputAct)
     return false;
 }
 
-void WeaponTools::RecvProxy_SequenceNum_Override(const CRecvProxyData* pData, void* pStruct, void* pOut)
+void WeaponTools::RecvProxy_SequenceNum_Override(const CRecvProxyData* pData, void* pStruct, void* pOut,
+                                                 const RecvProxyRouter::Next& next)
 {
     CBaseViewModel* model = (CBaseViewModel*)pStruct;
     if (pData->m_Value.m_Int != model->GetSequence())
@@ -146,7 +154,7 @@ void WeaponTools::RecvProxy_SequenceNum_Override(const CRecvProxyData* pData, vo
             }
         }
 
-        m_ViewModelProxyFnOverride->GetOldValue()(&newData, pStruct, pOut);
+        next(&newData, pStruct, pOut);
     }
 }
 
@@ -181,37 +189,9 @@ void WeaponTools::SkinDownsampleChanged(const ConVar* var)
 
 void WeaponTools::InspectBlockToggled(const ConVar* cv)
 {
-    if (cv->GetBool())
-    {
-        // C_BaseViewModel::m_nSequence
-        {
-            auto prop = Entities::FindRecvProp("CBaseViewModel", "m_nSequence", false);
-            RecvVarProxyFn* existingFnVar = &prop->m_ProxyFn;
-            Assert(existingFnVar);
-
-            static auto patchFn = [](const CRecvProxyData* data, void* pStruct, void* out) {
-                GetModule()->RecvProxy_SequenceNum_Override(data, pStruct, out);
-            };
-
-            m_ViewModelProxyFnOverride.emplace(*existingFnVar, patchFn);
-        }
-
-        // C_TFWeapon::m_nInspectStage
-        {
-            auto prop = Entities::FindRecvProp("CTFWeaponBase", "m_nInspectStage", false);
-
-            static auto patchFn = [](const CRecvProxyData* data, void* pStruct, void* out) {
-                *(int*)out = (int)InspectStage::None;
-            };
-
-            m_InspectStageProxyFnOverride.emplace(prop->m_ProxyFn, patchFn);
-        }
-    }
-    else
-    {
-        m_ViewModelProxyFnOverride.reset();
-        m_InspectStageProxyFnOverride.reset();
-    }
+    // C_BaseViewModel::m_nSequence and C_TFWeapon::m_nInspectStage
+    m_ViewModelSequenceProxy.SetEnabled(cv->GetBool());
+    m_InspectStageProxy.SetEnabled(cv->GetBool());
 }
 
 void WeaponTools::UpdateVMIdleActivity(const CHandle<C_BaseViewModel>& vm, Activity newAct)
@@ -1,13 +1,13 @@
 #pragma once
 
 #include "PluginBase/Modules.h"
+#include "PluginBase/RecvProxyRouter.h"
 
 #include <convar.h>
 #include <dt_recv.h>
 #include <shared/ai_activity.h>
 #include <shared/ehandle.h>
 
-#include <optional>
 #include <unordered_map>
 
 class C_BaseViewModel;
@@ -52,9 +52,10 @@ private:
     ConVar ce_weapon_skin_downsample;
     // ConCommand ce_weapon_inspect_force;
 
-    std::optional<VariablePusher<RecvVarProxyFn>> m_InspectStageProxyFnOverride;
-    std::optional<VariablePusher<RecvVarProxyFn>> m_ViewModelProxyFnOverride;
-    void RecvProxy_SequenceNum_Override(const CRecvProxyData* data, void* pStruct, void* out);
+    RecvProxySubscription m_InspectStageProxy;
+    RecvProxySubscription m_ViewModelSequenceProxy;
+    void RecvProxy_SequenceNum_Override(const CRecvProxyData* data, void* pStruct, void* out,
+                                        const RecvProxyRouter::Next& next);
 
     void SkinDownsampleChanged(const ConVar* var);
 
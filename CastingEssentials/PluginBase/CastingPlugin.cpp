@@ -1,10 +1,18 @@
 #include "Plugin.h"
 
 #include "Entities.h"
+#include "FrameArena.h"
+#include "GameEventRouter.h"
 #include "HookManager.h"
 #include "Interfaces.h"
+#include "MemoryTracker.h"
 #include "Modules.h"
 #include "Player.h"
+#include "PlayerHistory.h"
+#include "RecvProxyRouter.h"
+#include "StartupTasks.h"
+#include "TFPlayerResource.h"
+#include "TickRecorder.h"
 
 #include <chrono>
 
@@ -36,15 +44,41 @@ bool CastingPlugin::Load(CreateInterfaceFn interfaceFactory, CreateInterfaceFn g
 
     Msg("Hello from %s!\n", PLUGIN_FULL_VERSION);
 
-    Interfaces::Load(interfaceFactory);
-    HookManager::Load();
-    Entities::Load();
-    Player::Load();
+    {
+        // CPU-only stages are launched as early as possible and joined where their results are
+        // first needed. Everything else stays on the main thread, in the same order as before.
+        StartupTasks startup;
 
-    Modules().Init();
-    Modules().LoadAll();
+        startup.RunOnMainThread("Interfaces", [&]() { Interfaces::Load(interfaceFactory); });
 
-    ConVar_Register();
+        HookManager::BeginSignatureScans(startup);
+        const auto recvTables = Entities::Load(startup);
+
+        startup.RunOnMainThread("Hook manager", []() { HookManager::Load(); });
+        startup.RunOnMainThread("Game event router", []() { GameEventRouter::Load(); });
+        startup.RunOnMainThread("RecvProxy router", []() { RecvProxyRouter::Load(); });
+        startup.RunOnMainThread("Memory tracker", []() { MemoryTracker::Load(); });
+        startup.RunOnMainThread("Frame arenas", []() { FrameArena::Load(); });
+
+        startup.Join(recvTables);
+
+        startup.RunOnMainThread("Players", []()
+                                {
+                                    Player::Load();
+                                    PlayerHistory::Load();
+                                    TickRecorder::Load();
+                                });
+
+        startup.RunOnMainThread("Modules", []()
+                                {
+                                    Modules().Init();
+                                    Modules().LoadAll();
+                                });
+
+        ConVar_Register();
+
+        startup.Finish();
+    }
 
     const auto endTime = std::chrono::high_resolution_clock::now();
     const auto delta = std::chrono::duration<float>(endTime - startTime);
@@ -65,7 +99,14 @@ void CastingPlugin::Unload()
     Player::Unload();
     ConVar_Unregister();
     Modules().UnloadAllModules();
+    TFPlayerResource::Unload();
+    FrameArena::Unload();
+    TickRecorder::Unload();
+    PlayerHistory::Unload();
+    GameEventRouter::Unload();
+    RecvProxyRouter::Unload();
     HookManager::Unload();
+    MemoryTracker::Unload();
     Interfaces::Unload();
 
     PluginMsg("Finished unloading!\n");
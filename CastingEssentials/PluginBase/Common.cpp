@@ -144,6 +144,17 @@ int GetConLine()
     return s_LastConLine++;
 }
 
+std::string GetMapName(const char* levelName)
+{
+    std::string_view mapName(levelName);
+    if (mapName.starts_with("maps/"))
+        mapName.remove_prefix(5);
+    if (mapName.ends_with(".bsp"))
+        mapName.remove_suffix(4);
+
+    return std::string(mapName);
+}
+
 std::string KeyValuesDumpAsString(KeyValues* kv, int indentLevel)
 {
     class DumpContext : public IKeyValuesDumpContextAsText
@@ -167,6 +167,9 @@ extern bool ParseAngle(QAngle& a, const char* str);
 extern Vector GetViewOrigin();
 extern int GetConLine();
 
+// "maps/cp_process_final.bsp" -> "cp_process_final"
+extern std::string GetMapName(const char* levelName);
+
 extern std::string KeyValuesDumpAsString(KeyValues* kv, int indentLevel = 0);
 
 Vector ApproachVector(const Vector& from, const Vector& to, float speed);
@@ -1,6 +1,7 @@
 #include "Entities.h"
 #include "Exceptions.h"
 #include "Interfaces.h"
+#include "PluginBase/StartupTasks.h"
 #include "PluginBase/TFDefinitions.h"
 
 #include <cdll_int.h>
@@ -117,7 +118,7 @@ Entities::PropOffsetPair Entities::RetrieveClassPropOffset(const ClientClass* cc
     return RetrieveClassPropOffset(cc->m_pRecvTable, propertyString);
 }
 
-void Entities::Load()
+std::shared_future<void> Entities::Load(StartupTasks& startup)
 {
 #ifdef DEBUG
     for (auto cc = Interfaces::GetClientDLL()->GetAllClasses(); cc; cc = cc->m_pNext)
@@ -127,7 +128,9 @@ void Entities::Load()
               [](const ClientClass* a, const ClientClass* b) { return strcmp(a->GetName(), b->GetName()) < 0; });
 #endif
 
-    BuildContainingRecvTablesMap();
+    // Asking the client for its class list is the only part that touches the engine
+    const ClientClass* const allClasses = Interfaces::GetClientDLL()->GetAllClasses();
+    return startup.Launch("RecvTable flattening", [allClasses]() { BuildContainingRecvTablesMap(allClasses); });
 }
 
 Entities::PropOffsetPair Entities::RetrieveClassPropOffset(const RecvTable* table,
@@ -271,13 +274,13 @@ void Entities::AddChildTables(const RecvTable* parent, std::vector<const RecvTab
     stack.pop_back();
 }
 
-void Entities::BuildContainingRecvTablesMap()
+void Entities::BuildContainingRecvTablesMap(const ClientClass* allClasses)
 {
     Assert(s_ContainingRecvTables.empty());
     // std::set<const RecvTable*> allTables;
 
     std::vector<const RecvTable*> stack;
-    for (auto cc = Interfaces::GetClientDLL()->GetAllClasses(); cc; cc = cc->m_pNext)
+    for (auto cc = allClasses; cc; cc = cc->m_pNext)
     {
         stack.clear();
 
@@ -3,6 +3,7 @@
 #include "PluginBase/EntityOffset.h"
 
 #include <algorithm>
+#include <future>
 #include <map>
 #include <set>
 #include <stack>
@@ -14,6 +15,7 @@ class IClientNetworkable;
 class RecvTable;
 class RecvProp;
 class ClientClass;
+class StartupTasks;
 enum class TFTeam;
 
 class Entities final
@@ -21,7 +23,9 @@ class Entities final
     using PropOffsetPair = std::pair<int, const std::set<const RecvTable*>*>;
 
 public:
-    static void Load();
+    // Flattening the RecvTable graph is pure CPU work, so it runs on the startup workers. Join the
+    // returned task before looking up any prop offsets.
+    static std::shared_future<void> Load(StartupTasks& startup);
 
     static PropOffsetPair RetrieveClassPropOffset(const RecvTable* table, const std::string_view& propertyString);
     static PropOffsetPair RetrieveClassPropOffset(const ClientClass* cc, const std::string_view& propertyString);
@@ -88,7 +92,7 @@ private:
     static void* GetEntityProp(IClientNetworkable* entity, const char* propertyString, bool throwifMissing = true);
 
     static std::map<const RecvTable*, std::set<const RecvTable*>> s_ContainingRecvTables;
-    static void BuildContainingRecvTablesMap();
+    static void BuildContainingRecvTablesMap(const ClientClass* allClasses);
     static void AddChildTables(const RecvTable* parent, std::vector<const RecvTable*>& stack);
 
     static std::map<std::string_view, const RecvTable*> s_AllRecvTables;
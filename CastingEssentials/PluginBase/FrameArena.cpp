@@ -0,0 +1,169 @@
+#include "FrameArena.h"
+
+#include <convar.h>
+#include <tier0/dbg.h>
+#include <tier0/threadtools.h>
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+#undef max
+#undef min
+
+static size_t AlignUp(size_t value, size_t alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
+FrameArena::FrameArena(const char* name, size_t initialCapacity)
+    : m_Name(name), m_Block(new std::byte[initialCapacity]), m_Capacity(initialCapacity)
+{
+}
+
+struct FrameArena::Globals
+{
+    Globals();
+
+    static void PrintStats();
+
+    FrameArena m_TickArena;
+
+    ConCommand ce_arena_stats;
+};
+
+std::unique_ptr<FrameArena::Globals> FrameArena::s_Globals;
+
+bool FrameArena::Load()
+{
+    s_Globals = std::make_unique<Globals>();
+    return true;
+}
+bool FrameArena::Unload()
+{
+    s_Globals.reset();
+    return true;
+}
+
+FrameArena::Globals::Globals()
+    : m_TickArena("tick", 64 * 1024),
+      ce_arena_stats("ce_arena_stats", PrintStats, "Prints usage of the per-tick scratch allocator.")
+{
+}
+
+FrameArena& FrameArena::GetTickArena()
+{
+    Assert(s_Globals);
+    return s_Globals->m_TickArena;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    Assert(ThreadInMainThread());
+
+    // Offsets are aligned relative to the block, which new[] aligns for any fundamental type
+    const size_t offset = AlignUp(m_Used, alignment);
+    if (offset + size > m_Capacity || !m_Overflow.empty())
+        return AllocateOverflow(size, alignment);
+
+    m_Used = offset + size;
+    m_LastAllocation = m_Block.get() + offset;
+    return m_LastAllocation;
+}
+
+void* FrameArena::AllocateOverflow(size_t size, size_t alignment)
+{
+    if (!m_Overflow.empty())
+    {
+        auto& chunk = m_Overflow.back();
+        const size_t offset = AlignUp(chunk.m_Used, alignment);
+        if (offset + size <= chunk.m_Size)
+        {
+            m_OverflowUsed += offset + size - chunk.m_Used;
+            chunk.m_Used = offset + size;
+            m_LastAllocation = chunk.m_Data.get() + offset;
+            return m_LastAllocation;
+        }
+    }
+
+    auto& chunk = m_Overflow.emplace_back();
+    chunk.m_Size = std::max(size + alignment, m_Capacity);
+    chunk.m_Data.reset(new std::byte[chunk.m_Size]);
+    chunk.m_Used = size;
+
+    m_HeapAllocations++;
+    m_OverflowUsed += size;
+    m_LastAllocation = chunk.m_Data.get();
+    return m_LastAllocation;
+}
+
+void FrameArena::Deallocate(void* ptr, size_t size)
+{
+    // Only the most recent allocation can be handed back. A growing container allocates its new
+    // buffer before freeing the old one, so this only helps temporaries freed in reverse order.
+    if (ptr != m_LastAllocation || !ptr)
+        return;
+
+    if (!m_Overflow.empty())
+    {
+        auto& chunk = m_Overflow.back();
+        chunk.m_Used -= size;
+        m_OverflowUsed -= size;
+    }
+    else
+    {
+        m_Used -= size;
+    }
+
+    m_LastAllocation = nullptr;
+}
+
+void FrameArena::Reset()
+{
+    const size_t used = GetUsed();
+    m_PeakUsed = std::max(m_PeakUsed, used);
+
+    m_LastFrameHeapAllocations = m_HeapAllocations;
+    m_TotalHeapAllocations += m_HeapAllocations;
+    m_HeapAllocations = 0;
+
+    // Ran out last frame, so grow to fit it in one block from now on
+    if (!m_Overflow.empty())
+    {
+        m_Overflow.clear();
+        m_Capacity = AlignUp(used + used / 2, 4096);
+        m_Block.reset(new std::byte[m_Capacity]);
+    }
+
+    m_Used = 0;
+    m_OverflowUsed = 0;
+    m_LastAllocation = nullptr;
+}
+
+ArenaString arenaprintf(FrameArena& arena, const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+
+    va_list args2;
+    va_copy(args2, args);
+
+    ArenaString retVal(arena);
+
+    const auto length = vsnprintf(nullptr, 0, fmt, args);
+    Assert(length >= 0);
+    if (length > 0)
+    {
+        retVal.resize(length);
+        vsnprintf(retVal.data(), length + 1, fmt, args2);
+    }
+
+    va_end(args2);
+    va_end(args);
+    return retVal;
+}
+
+void FrameArena::Globals::PrintStats()
+{
+    const FrameArena& arena = GetTickArena();
+    Msg("%-8s %8zu bytes used, %8zu peak, %8zu capacity, %u heap allocations last frame (%llu total)\n",
+        arena.GetName(), arena.GetUsed(), arena.GetPeakUsed(), arena.GetCapacity(),
+        arena.GetLastFrameHeapAllocations(), arena.GetTotalHeapAllocations());
+}
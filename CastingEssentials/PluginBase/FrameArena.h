@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Bump-pointer allocator for scratch data that only lives until the end of the current tick.
+//
+// GetTickArena() is reset by the module manager before modules tick. Allocating is a pointer bump
+// and freeing is a no-op, except for the most recent allocation, which is handed back so short-lived
+// temporaries don't use up the arena. Anything allocated from an arena is invalid after the next
+// reset, so arena containers must never be stored in members.
+//
+// If a frame needs more than the arena holds, the rest is taken from the heap in chunks and the
+// arena grows to the peak size on the next reset, so steady-state heap traffic is zero. Main
+// thread only.
+class FrameArena final
+{
+public:
+    FrameArena(const char* name, size_t initialCapacity);
+
+    static bool Load();
+    static bool Unload();
+
+    static FrameArena& GetTickArena();
+
+    void* Allocate(size_t size, size_t alignment);
+    void Deallocate(void* ptr, size_t size);
+    void Reset();
+
+    const char* GetName() const { return m_Name; }
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetUsed() const { return m_Used + m_OverflowUsed; }
+    size_t GetPeakUsed() const { return m_PeakUsed; }
+    uint32_t GetHeapAllocations() const { return m_HeapAllocations; }
+    uint32_t GetLastFrameHeapAllocations() const { return m_LastFrameHeapAllocations; }
+    uint64_t GetTotalHeapAllocations() const { return m_TotalHeapAllocations; }
+
+private:
+    // The tick arena, and the command that reports on it
+    struct Globals;
+    static std::unique_ptr<Globals> s_Globals;
+
+    void* AllocateOverflow(size_t size, size_t alignment);
+
+    const char* m_Name;
+
+    std::unique_ptr<std::byte[]> m_Block;
+    size_t m_Capacity;
+    size_t m_Used = 0;
+    void* m_LastAllocation = nullptr;
+
+    struct OverflowChunk
+    {
+        std::unique_ptr<std::byte[]> m_Data;
+        size_t m_Size;
+        size_t m_Used;
+    };
+    std::vector<OverflowChunk> m_Overflow;
+    size_t m_OverflowUsed = 0;
+
+    size_t m_PeakUsed = 0;
+    uint32_t m_HeapAllocations = 0;
+    uint32_t m_LastFrameHeapAllocations = 0;
+    uint64_t m_TotalHeapAllocations = 0;
+};
+
+// Standard allocator adaptor, so containers can live in an arena
+template<typename T> class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator(FrameArena& arena) : m_Arena(&arena) {}
+    template<typename U> ArenaAllocator(const ArenaAllocator<U>& other) : m_Arena(other.GetArena()) {}
+
+    T* allocate(size_t count) { return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T* ptr, size_t count) { m_Arena->Deallocate(ptr, count * sizeof(T)); }
+
+    FrameArena* GetArena() const { return m_Arena; }
+
+    template<typename U> bool operator==(const ArenaAllocator<U>& other) const { return m_Arena == other.GetArena(); }
+    template<typename U> bool operator!=(const ArenaAllocator<U>& other) const { return m_Arena != other.GetArena(); }
+
+private:
+    FrameArena* m_Arena;
+};
+
+template<typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+// strprintf, but into an arena
+ArenaString arenaprintf(FrameArena& arena, const char* fmt, ...);
@@ -0,0 +1,244 @@
+#include "GameEventRouter.h"
+#include "Interfaces.h"
+
+#include <igameevents.h>
+#include <vprof.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+static std::unique_ptr<GameEventRouter> s_GameEventRouter;
+GameEventRouter* GetGameEventRouter()
+{
+    Assert(s_GameEventRouter);
+    return s_GameEventRouter.get();
+}
+
+bool GameEventRouter::Load()
+{
+    s_GameEventRouter.reset(new GameEventRouter());
+    return true;
+}
+bool GameEventRouter::Unload()
+{
+    s_GameEventRouter.reset();
+    return true;
+}
+
+GameEventRouter::GameEventRouter()
+    : m_FireEventClientSideHook(this),
+      ce_gameevents_stats(
+          "ce_gameevents_stats", [](const CCommand& args) { GetGameEventRouter()->PrintStats(args); },
+          "Prints how many times each game event has been fired and dispatched to subscribers. Pass \"reset\" to "
+          "clear the counters.")
+{
+}
+
+GameEventRouter::EventID GameEventRouter::GetEventID(const char* eventName)
+{
+    Assert(eventName);
+    if (!eventName)
+        eventName = "";
+
+    if (auto found = m_EventIDs.find(eventName); found != m_EventIDs.end())
+        return found->second;
+
+    Assert(m_EventTypes.size() < std::numeric_limits<EventID>::max());
+    const auto id = EventID(m_EventTypes.size());
+
+    auto& type = m_EventTypes.emplace_back();
+    type.m_Name = eventName;
+    m_EventIDs.emplace(type.m_Name, id);
+
+    return id;
+}
+
+GameEventRouter::EventID GameEventRouter::GetEventID(const IGameEvent* event) { return GetEventID(event->GetName()); }
+
+int GameEventRouter::Subscribe(EventID id, const Callback& callback, const void* tag)
+{
+    // Subscriber lists are iterated in place while dispatching
+    Assert(!m_Dispatching);
+    Assert(id < m_EventTypes.size());
+
+    const auto subscriptionID = ++m_LastSubscriptionID;
+    m_EventTypes[id].m_Subscribers.push_back({subscriptionID, tag, callback});
+
+    if (m_SubscriberCount++ == 0 && !m_FireObserver)
+        m_FireEventClientSideHook.Enable();
+
+    return subscriptionID;
+}
+
+bool GameEventRouter::Unsubscribe(int subscriptionID)
+{
+    Assert(!m_Dispatching);
+
+    // Rare enough that there's no point in keeping a reverse lookup
+    for (auto& type : m_EventTypes)
+    {
+        auto found = std::find_if(type.m_Subscribers.begin(), type.m_Subscribers.end(),
+                                  [subscriptionID](const Subscriber& sub) { return sub.m_ID == subscriptionID; });
+        if (found == type.m_Subscribers.end())
+            continue;
+
+        type.m_Subscribers.erase(found);
+
+        if (--m_SubscriberCount == 0 && !m_FireObserver)
+            m_FireEventClientSideHook.Disable();
+
+        return true;
+    }
+
+    Assert(!"Attempted to remove an unknown game event subscription");
+    return false;
+}
+
+void GameEventRouter::SetFireObserver(FireObserver&& observer)
+{
+    const bool wasHooked = m_SubscriberCount > 0 || m_FireObserver;
+    m_FireObserver = std::move(observer);
+
+    const bool hooked = m_SubscriberCount > 0 || m_FireObserver;
+    if (hooked && !wasHooked)
+        m_FireEventClientSideHook.Enable();
+    else if (!hooked && wasHooked)
+        m_FireEventClientSideHook.Disable();
+}
+
+bool GameEventRouter::FireInjectedEvent(IGameEvent* event, const void* tag)
+{
+    Assert(event);
+    Assert(tag);
+    if (!event)
+        return false;
+
+    // FireEventClientSide dispatches immediately and frees the event before returning, so the
+    // pointer is only tracked for the duration of the call.
+    m_InjectedEvents.emplace(event, tag);
+    const bool retVal = Interfaces::GetGameEventManager()->FireEventClientSide(event);
+    m_InjectedEvents.erase(event);
+
+    return retVal;
+}
+
+bool GameEventRouter::IsInjectedEvent(const IGameEvent* event, const void* tag) const
+{
+    if (m_InjectedEvents.empty())
+        return false;
+
+    auto found = m_InjectedEvents.find(event);
+    return found != m_InjectedEvents.end() && found->second == tag;
+}
+
+bool GameEventRouter::FireEventClientSideOverride(IGameEventManager2* pThis, IGameEvent* event)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    Assert(event);
+    if (!event)
+        return false;
+
+    const auto id = GetEventID(event);
+    auto& type = m_EventTypes[id];
+    type.m_FireCount++;
+
+    if (m_FireObserver)
+        m_FireObserver(id, event);
+
+    if (type.m_Subscribers.empty())
+        return true;
+
+    const void* injectedTag = nullptr;
+    if (!m_InjectedEvents.empty())
+    {
+        if (auto found = m_InjectedEvents.find(event); found != m_InjectedEvents.end())
+            injectedTag = found->second;
+    }
+
+    m_Dispatching++;
+    for (const auto& sub : type.m_Subscribers)
+    {
+        if (injectedTag && sub.m_Tag == injectedTag)
+            continue;
+
+        sub.m_Callback(event);
+        type.m_DispatchCount++;
+    }
+    m_Dispatching--;
+
+    return true;
+}
+
+void GameEventRouter::PrintStats(const CCommand& args)
+{
+    if (args.ArgC() > 1 && !stricmp(args.Arg(1), "reset"))
+    {
+        for (auto& type : m_EventTypes)
+            type.m_FireCount = type.m_DispatchCount = 0;
+
+        Msg("Reset game event counters.\n");
+        return;
+    }
+
+    std::vector<const EventType*> sorted;
+    sorted.reserve(m_EventTypes.size());
+    for (const auto& type : m_EventTypes)
+        sorted.push_back(&type);
+
+    std::sort(sorted.begin(), sorted.end(),
+              [](const EventType* a, const EventType* b) { return a->m_FireCount > b->m_FireCount; });
+
+    Msg("%-40s %10s %10s %6s\n", "Event", "Fired", "Dispatched", "Subs");
+    for (const EventType* type : sorted)
+    {
+        Msg("%-40s %10u %10u %6i\n", type->m_Name.c_str(), type->m_FireCount, type->m_DispatchCount,
+            (int)type->m_Subscribers.size());
+    }
+
+    Msg("%i event types, %i subscribers\n", (int)m_EventTypes.size(), m_SubscriberCount);
+}
+
+GameEventSubscription::GameEventSubscription(const char* eventName, GameEventRouter::Callback&& callback,
+                                             const void* tag)
+    : m_EventID(GetGameEventRouter()->GetEventID(eventName)), m_Tag(tag), m_Callback(std::move(callback)),
+      m_MemoryTag(MemoryTracker::GetCurrentTag())
+{
+}
+
+bool GameEventSubscription::Enable()
+{
+    if (IsEnabled())
+        return false;
+
+    // Attribute the callback's allocations to the module that subscribed
+    if (m_MemoryTag != MemoryTracker::UNTAGGED)
+    {
+        m_SubscriptionID = GetGameEventRouter()->Subscribe(
+            m_EventID,
+            [this](IGameEvent* event)
+            {
+                MemoryScope scope(m_MemoryTag);
+                m_Callback(event);
+            },
+            m_Tag);
+    }
+    else
+    {
+        m_SubscriptionID = GetGameEventRouter()->Subscribe(m_EventID, m_Callback, m_Tag);
+    }
+    return true;
+}
+
+bool GameEventSubscription::Disable()
+{
+    if (!IsEnabled())
+        return true;
+
+    if (!GetGameEventRouter()->Unsubscribe(m_SubscriptionID))
+        return false;
+
+    m_SubscriptionID = 0;
+    return true;
+}
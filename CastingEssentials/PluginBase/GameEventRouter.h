@@ -0,0 +1,112 @@
+#pragma once
+#include "PluginBase/Hook.h"
+#include "PluginBase/MemoryTracker.h"
+
+#include <convar.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class IGameEvent;
+class IGameEventManager2;
+
+// Central dispatcher for client-side game events.
+//
+// Event names are interned to small integer ids, so routing an event costs one hash of its
+// name and subscribers never string-compare. Events that a module fires itself can be tagged
+// through FireInjectedEvent(), and subscribers registered with the same tag won't see them.
+class GameEventRouter final
+{
+public:
+    using EventID = uint16_t;
+    using Callback = std::function<void(IGameEvent* event)>;
+
+    GameEventRouter();
+
+    static bool Load();
+    static bool Unload();
+
+    EventID GetEventID(const char* eventName);
+    EventID GetEventID(const IGameEvent* event);
+    const char* GetEventName(EventID id) const { return m_EventTypes[id].m_Name.c_str(); }
+
+    int Subscribe(EventID id, const Callback& callback, const void* tag = nullptr);
+    bool Unsubscribe(int subscriptionID);
+
+    // Fires an event through the engine, tagged for the duration of its dispatch. Takes ownership
+    // of the event, just like IGameEventManager2::FireEventClientSide.
+    bool FireInjectedEvent(IGameEvent* event, const void* tag);
+    bool IsInjectedEvent(const IGameEvent* event, const void* tag) const;
+
+    // Sees every event fired through the engine, before any subscribers
+    using FireObserver = std::function<void(EventID id, IGameEvent* event)>;
+    void SetFireObserver(FireObserver&& observer);
+
+private:
+    struct Subscriber
+    {
+        int m_ID;
+        const void* m_Tag;
+        Callback m_Callback;
+    };
+
+    struct EventType
+    {
+        std::string m_Name;
+        std::vector<Subscriber> m_Subscribers;
+
+        uint32_t m_FireCount = 0;
+        uint32_t m_DispatchCount = 0;
+    };
+
+    // Deque so the names stay put for the string_view keys in m_EventIDs
+    std::deque<EventType> m_EventTypes;
+    std::unordered_map<std::string_view, EventID> m_EventIDs;
+
+    std::unordered_map<const IGameEvent*, const void*> m_InjectedEvents;
+
+    FireObserver m_FireObserver;
+
+    int m_LastSubscriptionID = 0;
+    int m_SubscriberCount = 0;
+    int m_Dispatching = 0; // Depth, since a subscriber can fire another event
+
+    bool FireEventClientSideOverride(IGameEventManager2* pThis, IGameEvent* event);
+    Hook<HookFunc::IGameEventManager2_FireEventClientSide, &GameEventRouter::FireEventClientSideOverride>
+        m_FireEventClientSideHook;
+
+    void PrintStats(const CCommand& args);
+    ConCommand ce_gameevents_stats;
+};
+
+extern GameEventRouter* GetGameEventRouter();
+
+// RAII subscription to a single event type, toggled the same way as Hook<>
+class GameEventSubscription final
+{
+public:
+    GameEventSubscription(const char* eventName, GameEventRouter::Callback&& callback, const void* tag = nullptr);
+    ~GameEventSubscription() { Disable(); }
+
+    GameEventSubscription(const GameEventSubscription& other) = delete;
+    GameEventSubscription& operator=(const GameEventSubscription& other) = delete;
+
+    bool SetEnabled(bool enabled) { return enabled ? Enable() : Disable(); }
+    bool Enable();
+    bool Disable();
+    bool IsEnabled() const { return m_SubscriptionID > 0; }
+
+    GameEventRouter::EventID GetEventID() const { return m_EventID; }
+
+private:
+    GameEventRouter::EventID m_EventID;
+    const void* m_Tag;
+    GameEventRouter::Callback m_Callback;
+    MemoryTracker::Tag m_MemoryTag;
+    int m_SubscriptionID = 0;
+};
@@ -1,13 +1,73 @@
 #pragma once
 #include "PluginBase/HookManager.h"
+#include "PluginBase/MemoryTracker.h"
 
-template<HookFunc fn>
+#include <functional>
+#include <type_traits>
+
+namespace Hooking::Internal
+{
+template<class MemberFn>
+struct MemberFnOwner
+{
+    using Type = void;
+};
+template<class Type_, class RetVal, class... Args>
+struct MemberFnOwner<RetVal (Type_::*)(Args...)>
+{
+    using Type = Type_;
+};
+template<class Type_, class RetVal, class... Args>
+struct MemberFnOwner<RetVal (Type_::*)(Args...) const>
+{
+    using Type = const Type_;
+};
+
+// Builds the callback for Hook<fn, &Class::Method>. The method is a template argument, so the call
+// inlines straight into std::function's invoker instead of going through std::bind's stored member
+// pointer, and the captures always fit in std::function's small buffer.
+template<class Functional>
+struct HookMemberBinder;
+template<class RetVal, class... Args>
+struct HookMemberBinder<std::function<RetVal(Args...)>>
+{
+    template<auto method, class Owner>
+    static std::function<RetVal(Args...)> Bind(Owner* instance, MemoryTracker::Tag memoryTag)
+    {
+        if (memoryTag == MemoryTracker::UNTAGGED)
+            return [instance](Args... args) -> RetVal { return (instance->*method)(std::forward<Args>(args)...); };
+
+        return [instance, memoryTag](Args... args) -> RetVal
+        {
+            MemoryScope scope(memoryTag);
+            return (instance->*method)(std::forward<Args>(args)...);
+        };
+    }
+};
+}
+
+// Either wraps an arbitrary callback:
+//     Hook<HookFunc::X> m_Hook{[](...) { ... }};
+// or calls a member function directly, capturing only the instance pointer:
+//     Hook<HookFunc::X, &MyModule::XOverride> m_Hook{this};
+template<HookFunc fn, auto method = nullptr>
 class Hook final
 {
     using Functional = typename HookDefinitions::HookFuncType<fn>::Hook::Functional;
+    using Owner = typename Hooking::Internal::MemberFnOwner<decltype(method)>::Type;
+    static constexpr bool IS_MEMBER_BOUND = !std::is_null_pointer_v<decltype(method)>;
 
 public:
-    Hook(Functional&& fn, bool enable = false) : m_Fn(std::move(fn)), m_HookID(-1)
+    Hook(Functional&& fn, bool enable = false)
+        requires(!IS_MEMBER_BOUND)
+        : m_Fn(std::move(fn)), m_HookID(-1)
+    {
+        if (enable)
+            Enable();
+    }
+    Hook(Owner* instance, bool enable = false)
+        requires(IS_MEMBER_BOUND)
+        : m_Instance(instance), m_HookID(-1)
     {
         if (enable)
             Enable();
@@ -19,8 +79,8 @@ public:
     }
 
     // No copying allowed
-    Hook(const Hook<fn>& other) = delete;
-    Hook<fn>& operator=(const Hook<fn>& other) = delete;
+    Hook(const Hook& other) = delete;
+    Hook& operator=(const Hook& other) = delete;
 
     bool SetEnabled(bool enabled)
     {
@@ -34,7 +94,26 @@ public:
         if (IsEnabled())
             return false;
 
-        m_HookID = GetHooks()->AddHook<fn>(m_Fn);
+        if constexpr (IS_MEMBER_BOUND)
+        {
+            m_HookID = GetHooks()->AddHook<fn>(
+                Hooking::Internal::HookMemberBinder<Functional>::template Bind<method>(m_Instance, m_MemoryTag));
+        }
+        // Attribute the callback's allocations to whichever module created the hook
+        else if (m_MemoryTag != MemoryTracker::UNTAGGED)
+        {
+            m_HookID = GetHooks()->AddHook<fn>(Functional(
+                [this](auto&&... args) -> decltype(auto)
+                {
+                    MemoryScope scope(m_MemoryTag);
+                    return m_Fn(std::forward<decltype(args)>(args)...);
+                }));
+        }
+        else
+        {
+            m_HookID = GetHooks()->AddHook<fn>(m_Fn);
+        }
+
         return true;
     }
     bool Disable()
@@ -66,5 +145,7 @@ public:
 
 private:
     Functional m_Fn;
+    Owner* m_Instance = nullptr;
     int m_HookID;
+    MemoryTracker::Tag m_MemoryTag = MemoryTracker::GetCurrentTag();
 };
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "HookManager.h"
 #include "Controls/StubPanel.h"
+#include "Hooking/HookTransaction.h"
 #include "Misc/HLTVCameraHack.h"
+#include "PluginBase/Common.h"
 #include "PluginBase/Exceptions.h"
+#include "PluginBase/Hook.h"
 #include "PluginBase/Interfaces.h"
+#include "PluginBase/StartupTasks.h"
 
 #include <PolyHook.hpp>
 
@@ -17,6 +21,9 @@
 #include <iprediction.h>
 #include <toolframework/iclientenginetools.h>
 
+#include <algorithm>
+#include <chrono>
+
 static std::unique_ptr<HookManager> s_HookManager;
 HookManager* GetHooks()
 {
@@ -25,6 +32,8 @@ HookManager* GetHooks()
 }
 
 void* HookManager::s_RawFunctions[(int)HookFunc::Count];
+std::vector<HookManager::PendingScan> HookManager::s_PendingScans;
+std::vector<std::shared_future<void>> HookManager::s_ScanTasks;
 
 bool HookManager::Load()
 {
@@ -312,17 +321,20 @@ void HookManager::InitRawFunctionsList()
 
     FindFunc<HookFunc::C_BaseAnimating_GetSequenceActivity>(
         "\x48\x89\x5C\x24\x08\x57\x48\x83\xEC\x20\x8B\xDA\x48\x8B\xF9\x83\xFA\xFF\x74", "xxxxxxxxxxxxxxxxxxx");
-
-    FindFunc_CNewParticleEffect_SetDormant();
 }
 
 template<HookFunc fn>
 void HookManager::FindFunc(const char* signature, const char* mask, int offset, const char* module)
 {
-    std::byte* result = (std::byte*)SignatureScan(module, signature, mask);
+    s_PendingScans.push_back({fn, signature, mask, offset, module});
+}
+
+void HookManager::RunScan(const PendingScan& scan)
+{
+    std::byte* result = (std::byte*)SignatureScan(scan.m_Module, scan.m_Signature, scan.m_Mask);
     if (result)
     {
-        result += offset;
+        result += scan.m_Offset;
     }
     else
     {
@@ -330,11 +342,67 @@ void HookManager::FindFunc(const char* signature, const char* mask, int offset,
         result = nullptr;
     }
 
-    s_RawFunctions[(int)fn] = (void*)result;
+    s_RawFunctions[(int)scan.m_Func] = (void*)result;
+}
+
+void HookManager::BeginSignatureScans(StartupTasks& startup)
+{
+    Assert(s_PendingScans.empty() && s_ScanTasks.empty());
+    InitRawFunctionsList();
+
+    // One task per module image, with the client's long list split up so it doesn't hold up
+    // everything else. Each scan writes its own slot in s_RawFunctions, so they don't need locking.
+    std::stable_sort(s_PendingScans.begin(), s_PendingScans.end(),
+                     [](const PendingScan& a, const PendingScan& b) { return stricmp(a.m_Module, b.m_Module) < 0; });
+
+    static constexpr size_t SCANS_PER_TASK = 8;
+    for (size_t first = 0; first < s_PendingScans.size();)
+    {
+        const char* const module = s_PendingScans[first].m_Module;
+
+        size_t last = first + 1;
+        while (last < s_PendingScans.size() && last - first < SCANS_PER_TASK &&
+               !stricmp(s_PendingScans[last].m_Module, module))
+        {
+            last++;
+        }
+
+        s_ScanTasks.push_back(startup.Launch(strprintf("Signature scan: %s (%zu)", module, last - first),
+                                             [first, last]()
+                                             {
+                                                 for (size_t i = first; i < last; i++)
+                                                     RunScan(s_PendingScans[i]);
+                                             }));
+
+        first = last;
+    }
+}
+
+void HookManager::FinishSignatureScans()
+{
+    if (s_ScanTasks.empty())
+    {
+        InitRawFunctionsList();
+        for (const auto& scan : s_PendingScans)
+            RunScan(scan);
+    }
+    else
+    {
+        for (const auto& task : s_ScanTasks)
+            StartupTasks::GetCurrent()->Join(task);
+    }
+
+    s_ScanTasks.clear();
+    s_PendingScans.clear();
+
+    // Found through the results of another scan
+    FindFunc_CNewParticleEffect_SetDormant();
 }
 
 void HookManager::IngameStateChanged(bool inGame)
 {
+    Hooking::HookTransaction transaction(inGame ? "Ingame hooks" : "Ingame unhooks");
+
     if (inGame)
     {
         GetHook<HookFunc::IGameEventManager2_FireEventClientSide>()->AttachHook(
@@ -362,8 +430,16 @@ void HookManager::InitGlobalHook()
 }
 
 HookManager::HookManager()
+    : ce_hooks_benchmark("ce_hooks_benchmark", &HookManager::RunBenchmark,
+                         "Measures the per-call overhead of the different ways a hook callback can be bound. "
+                         "Optionally takes the number of calls to time."),
+      ce_hooks_transaction_debug(
+          "ce_hooks_transaction_debug", "0", FCVAR_NONE,
+          "Prints how many vtable writes and detours each batch of hook changes made, and how long it took.",
+          [](IConVar* var, const char*, float)
+          { Hooking::HookTransaction::SetReportCommits(static_cast<ConVar*>(var)->GetBool()); })
 {
-    InitRawFunctionsList();
+    FinishSignatureScans();
 
     Assert(!s_HookManager);
     m_Panel.reset(new Panel());
@@ -434,3 +510,119 @@ HookManager::HookManager()
 
     InitGlobalHook<HookFunc::CStorePanel_RequestPricesheet>();
 }
+
+namespace
+{
+class HookBenchmarkTarget final
+{
+public:
+    __declspec(noinline) int Callback(int a, int b)
+    {
+        m_Total += a ^ b;
+        return m_Total;
+    }
+
+private:
+    int m_Total = 0;
+};
+
+// Stand-ins for engine classes, so each kind of group hook can be timed without touching the game
+class HookBenchmarkInstance
+{
+public:
+    virtual int Callback(int a, int b) { return a ^ b; }
+};
+class HookBenchmarkClass
+{
+public:
+    virtual int Callback(int a, int b) { return a ^ b; }
+};
+
+enum class HookBenchmarkFunc
+{
+    VTableSwap,
+    VFuncSwap,
+};
+}
+
+void HookManager::RunBenchmark(const CCommand& args)
+{
+    using Functional = std::function<int(int, int)>;
+    using Clock = std::chrono::high_resolution_clock;
+
+    int iterations = 10'000'000;
+    if (args.ArgC() > 1 && (!TryParseInteger(args.Arg(1), iterations) || iterations < 1))
+    {
+        PluginWarning("Usage: %s [iterations]\n", args.Arg(0));
+        return;
+    }
+
+    HookBenchmarkTarget target;
+    const auto tag = MemoryTracker::RegisterTag("Hook benchmark");
+
+    // What Hook<> used to do for a module's member function, with and without a memory tag
+    const Functional bound = std::bind(&HookBenchmarkTarget::Callback, &target, std::placeholders::_1,
+                                       std::placeholders::_2);
+    const Functional boundTagged = [&bound, tag](int a, int b)
+    {
+        MemoryScope scope(tag);
+        return bound(a, b);
+    };
+
+    const Functional member = Hooking::Internal::HookMemberBinder<Functional>::Bind<&HookBenchmarkTarget::Callback>(
+        &target, MemoryTracker::UNTAGGED);
+    const Functional memberTagged =
+        Hooking::Internal::HookMemberBinder<Functional>::Bind<&HookBenchmarkTarget::Callback>(&target, tag);
+
+    // Everything is called through a reference or a virtual function, so nothing gets devirtualized
+    const auto time = [iterations](const char* name, const auto& fn)
+    {
+        int result = 0;
+        const auto start = Clock::now();
+        for (int i = 0; i < iterations; i++)
+            result += fn(i, result);
+
+        const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        [[maybe_unused]] volatile int sink = result;
+
+        Msg("%-32s %8.2f ns/call\n", name, elapsed / iterations);
+    };
+
+    Msg("Timing %i calls per binding...\n", iterations);
+    time("std::bind", bound);
+    time("std::bind + memory tag", boundTagged);
+    time("Hook<fn, &Class::Method>", member);
+    time("Hook<fn, &Class::Method> + tag", memberTagged);
+
+    // Full dispatch through each kind of group hook with a single callback attached, compared to
+    // calling the same virtual function unhooked
+    HookBenchmarkInstance instance;
+    HookBenchmarkClass classInstance;
+    HookBenchmarkInstance* volatile instancePtr = &instance;
+    HookBenchmarkClass* volatile classPtr = &classInstance;
+
+    const auto callInstance = [&](int a, int b) { return instancePtr->Callback(a, b); };
+    const auto callClass = [&](int a, int b) { return classPtr->Callback(a, b); };
+
+    Msg("Timing %i calls per hook type...\n", iterations);
+    time("Unhooked virtual call", callInstance);
+
+    {
+        Hooking::GroupVirtualHook<HookBenchmarkFunc, HookBenchmarkFunc::VTableSwap, false, HookBenchmarkInstance, int,
+                                  int, int>
+            hook(&instance, &HookBenchmarkInstance::Callback);
+
+        const auto hookID = hook.AddHook([](int a, int) { return a; });
+        time("Virtual (vtable swap)", callInstance);
+        hook.RemoveHook(hookID, __FUNCSIG__);
+    }
+    {
+        Hooking::GroupGlobalVirtualHook<HookBenchmarkFunc, HookBenchmarkFunc::VFuncSwap, false, HookBenchmarkClass, int,
+                                        int, int>
+            hook(&classInstance, &HookBenchmarkClass::Callback);
+
+        const auto hookID = hook.AddHook([](HookBenchmarkClass*, int a, int) { return a; });
+        time("Global virtual (vfunc swap)", callClass);
+        hook.RemoveHook(hookID, __FUNCSIG__);
+    }
+}
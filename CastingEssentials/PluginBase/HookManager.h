@@ -1,11 +1,17 @@
 #pragma once
 #include "PluginBase/HookDefinitions.h"
 
+#include <convar.h>
+
+#include <future>
 #include <memory>
+#include <vector>
+
+class StartupTasks;
 
 class HookManager final : HookDefinitions
 {
-    template<HookFunc fn>
+    template<HookFunc fn, auto method>
     friend class Hook;
 
 public:
@@ -14,6 +20,10 @@ public:
     static bool Load();
     static bool Unload();
 
+    // Starts the signature scans on the startup workers, so they can run while the rest of the
+    // plugin loads. Load() waits for them. Without this, Load() scans on the main thread.
+    static void BeginSignatureScans(StartupTasks& startup);
+
     template<HookFunc fn>
     __forceinline typename HookFuncType<fn>::Hook::OriginalFnType GetFunc()
     {
@@ -86,13 +96,30 @@ private:
 
     static void* s_RawFunctions[(int)HookFunc::Count];
     static void InitRawFunctionsList();
+    static void FinishSignatureScans();
     template<HookFunc fn>
     static void FindFunc(const char* signature, const char* mask, int offset = 0, const char* module = "client");
     static void FindFunc_CNewParticleEffect_SetDormant();
 
+    struct PendingScan
+    {
+        HookFunc m_Func;
+        const char* m_Signature;
+        const char* m_Mask;
+        int m_Offset;
+        const char* m_Module;
+    };
+    static void RunScan(const PendingScan& scan);
+    static std::vector<PendingScan> s_PendingScans;
+    static std::vector<std::shared_future<void>> s_ScanTasks;
+
     void IngameStateChanged(bool inGame);
     class Panel;
     std::unique_ptr<Panel> m_Panel;
+
+    static void RunBenchmark(const CCommand& args);
+    ConCommand ce_hooks_benchmark;
+    ConVar ce_hooks_transaction_debug;
 };
 
 extern std::byte* SignatureScan(const char* moduleName, const char* signature, const char* mask, int offset = 0);
@@ -0,0 +1,544 @@
+#include "MemoryTracker.h"
+#include "PluginBase/Common.h"
+
+#include <convar.h>
+#include <tier0/memalloc.h>
+#include <tier0/platform.h>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#undef max
+#undef min
+
+using Tag = MemoryTracker::Tag;
+
+thread_local Tag MemoryTracker::s_CurrentTag = MemoryTracker::UNTAGGED;
+
+namespace
+{
+    struct TagStats
+    {
+        char m_Name[64];
+
+        int64_t m_LiveBytes;
+        int64_t m_PeakBytes;
+        int64_t m_LiveBlocks;
+        uint64_t m_Allocations;
+        uint64_t m_Frees;
+
+        // Sampled once a second by Update()
+        uint64_t m_LastSampleAllocations;
+        float m_AllocationsPerSecond;
+
+        int64_t m_LevelStartBytes;
+        int64_t m_LevelStartBlocks;
+    };
+
+    std::array<TagStats, MemoryTracker::MAX_TAGS> s_Tags;
+    Tag s_TagCount = 1; // 0 is UNTAGGED
+    double s_LastSampleTime;
+
+    // The map of live blocks can't allocate through the allocator it's tracking
+    IMemAlloc* s_RealAlloc = nullptr;
+
+    template<typename T>
+    class RawAllocator
+    {
+    public:
+        using value_type = T;
+
+        RawAllocator() = default;
+        template<typename U> RawAllocator(const RawAllocator<U>&) {}
+
+        T* allocate(size_t count) { return static_cast<T*>(s_RealAlloc->Alloc(count * sizeof(T))); }
+        void deallocate(T* ptr, size_t) { s_RealAlloc->Free(ptr); }
+
+        template<typename U> bool operator==(const RawAllocator<U>&) const { return true; }
+        template<typename U> bool operator!=(const RawAllocator<U>&) const { return false; }
+    };
+
+    struct Block
+    {
+        MemoryTracker::Tag m_Tag;
+        uint32_t m_Size;
+    };
+
+    // Only exists while tracking is installed. Even an empty map allocates, and there's no real
+    // allocator to do that with until then.
+    std::mutex s_BlocksMutex;
+    std::optional<std::unordered_map<const void*, Block, std::hash<const void*>, std::equal_to<const void*>,
+                                     RawAllocator<std::pair<const void* const, Block>>>>
+        s_Blocks;
+
+    void OnAllocate(const void* ptr, size_t size)
+    {
+        if (!ptr)
+            return;
+
+        const auto tag = MemoryTracker::GetCurrentTag();
+
+        std::lock_guard lock(s_BlocksMutex);
+        if (!s_Blocks)
+            return;
+
+        (*s_Blocks)[ptr] = {tag, uint32_t(size)};
+
+        auto& stats = s_Tags[tag];
+        stats.m_LiveBytes += size;
+        stats.m_PeakBytes = std::max(stats.m_PeakBytes, stats.m_LiveBytes);
+        stats.m_LiveBlocks++;
+        stats.m_Allocations++;
+    }
+
+    void OnFree(const void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        std::lock_guard lock(s_BlocksMutex);
+        if (!s_Blocks)
+            return;
+
+        // Blocks from before tracking was enabled aren't in here
+        auto found = s_Blocks->find(ptr);
+        if (found == s_Blocks->end())
+            return;
+
+        auto& stats = s_Tags[found->second.m_Tag];
+        stats.m_LiveBytes -= found->second.m_Size;
+        stats.m_LiveBlocks--;
+        stats.m_Frees++;
+
+        s_Blocks->erase(found);
+    }
+
+    void OnReallocate(const void* oldPtr, const void* newPtr, size_t newSize)
+    {
+        // A failed realloc leaves the old block where it was, still ours to track. Only a
+        // zero-sized one frees it without returning anything.
+        if (!newPtr && newSize)
+            return;
+
+        OnFree(oldPtr);
+        OnAllocate(newPtr, newSize);
+    }
+
+    // Forwards everything to the real allocator, noting allocations and frees on the way
+    class TrackingMemAlloc final : public IMemAlloc
+    {
+    public:
+        void* Alloc(size_t nSize) override
+        {
+            void* ptr = s_RealAlloc->Alloc(nSize);
+            OnAllocate(ptr, nSize);
+            return ptr;
+        }
+        void* Realloc(void* pMem, size_t nSize) override
+        {
+            void* ptr = s_RealAlloc->Realloc(pMem, nSize);
+            OnReallocate(pMem, ptr, nSize);
+            return ptr;
+        }
+        void Free(void* pMem) override
+        {
+            OnFree(pMem);
+            s_RealAlloc->Free(pMem);
+        }
+        void* Expand_NoLongerSupported(void* pMem, size_t nSize) override
+        {
+            return s_RealAlloc->Expand_NoLongerSupported(pMem, nSize);
+        }
+
+        void* Alloc(size_t nSize, const char* pFileName, int nLine) override
+        {
+            void* ptr = s_RealAlloc->Alloc(nSize, pFileName, nLine);
+            OnAllocate(ptr, nSize);
+            return ptr;
+        }
+        void* Realloc(void* pMem, size_t nSize, const char* pFileName, int nLine) override
+        {
+            void* ptr = s_RealAlloc->Realloc(pMem, nSize, pFileName, nLine);
+            OnReallocate(pMem, ptr, nSize);
+            return ptr;
+        }
+        void Free(void* pMem, const char* pFileName, int nLine) override
+        {
+            OnFree(pMem);
+            s_RealAlloc->Free(pMem, pFileName, nLine);
+        }
+        void* Expand_NoLongerSupported(void* pMem, size_t nSize, const char* pFileName, int nLine) override
+        {
+            return s_RealAlloc->Expand_NoLongerSupported(pMem, nSize, pFileName, nLine);
+        }
+
+        size_t GetSize(void* pMem) override { return s_RealAlloc->GetSize(pMem); }
+        void PushAllocDbgInfo(const char* pFileName, int nLine) override
+        {
+            s_RealAlloc->PushAllocDbgInfo(pFileName, nLine);
+        }
+        void PopAllocDbgInfo() override { s_RealAlloc->PopAllocDbgInfo(); }
+        long CrtSetBreakAlloc(long lNewBreakAlloc) override { return s_RealAlloc->CrtSetBreakAlloc(lNewBreakAlloc); }
+        int CrtSetReportMode(int nReportType, int nReportMode) override
+        {
+            return s_RealAlloc->CrtSetReportMode(nReportType, nReportMode);
+        }
+        int CrtIsValidHeapPointer(const void* pMem) override { return s_RealAlloc->CrtIsValidHeapPointer(pMem); }
+        int CrtIsValidPointer(const void* pMem, unsigned int size, int access) override
+        {
+            return s_RealAlloc->CrtIsValidPointer(pMem, size, access);
+        }
+        int CrtCheckMemory() override { return s_RealAlloc->CrtCheckMemory(); }
+        int CrtSetDbgFlag(int nNewFlag) override { return s_RealAlloc->CrtSetDbgFlag(nNewFlag); }
+        void CrtMemCheckpoint(_CrtMemState* pState) override { s_RealAlloc->CrtMemCheckpoint(pState); }
+        void DumpStats() override { s_RealAlloc->DumpStats(); }
+        void DumpStatsFileBase(char const* pchFileBase) override { s_RealAlloc->DumpStatsFileBase(pchFileBase); }
+        void* CrtSetReportFile(int nRptType, void* hFile) override
+        {
+            return s_RealAlloc->CrtSetReportFile(nRptType, hFile);
+        }
+        void* CrtSetReportHook(void* pfnNewHook) override { return s_RealAlloc->CrtSetReportHook(pfnNewHook); }
+        int CrtDbgReport(int nRptType, const char* szFile, int nLine, const char* szModule,
+                         const char* pMsg) override
+        {
+            return s_RealAlloc->CrtDbgReport(nRptType, szFile, nLine, szModule, pMsg);
+        }
+        int heapchk() override { return s_RealAlloc->heapchk(); }
+        bool IsDebugHeap() override { return s_RealAlloc->IsDebugHeap(); }
+        void GetActualDbgInfo(const char*& pFileName, int& nLine) override
+        {
+            s_RealAlloc->GetActualDbgInfo(pFileName, nLine);
+        }
+        void RegisterAllocation(const char* pFileName, int nLine, int nLogicalSize, int nActualSize,
+                                unsigned nTime) override
+        {
+            s_RealAlloc->RegisterAllocation(pFileName, nLine, nLogicalSize, nActualSize, nTime);
+        }
+        void RegisterDeallocation(const char* pFileName, int nLine, int nLogicalSize, int nActualSize,
+                                  unsigned nTime) override
+        {
+            s_RealAlloc->RegisterDeallocation(pFileName, nLine, nLogicalSize, nActualSize, nTime);
+        }
+        int GetVersion() override { return s_RealAlloc->GetVersion(); }
+        void CompactHeap() override { s_RealAlloc->CompactHeap(); }
+        MemAllocFailHandler_t SetAllocFailHandler(MemAllocFailHandler_t pfnMemAllocFailHandler) override
+        {
+            return s_RealAlloc->SetAllocFailHandler(pfnMemAllocFailHandler);
+        }
+        void DumpBlockStats(void* p) override { s_RealAlloc->DumpBlockStats(p); }
+#if defined(_MEMTEST)
+        void SetStatsExtraInfo(const char* pMapName, const char* pComment) override
+        {
+            s_RealAlloc->SetStatsExtraInfo(pMapName, pComment);
+        }
+#endif
+        size_t MemoryAllocFailed() override { return s_RealAlloc->MemoryAllocFailed(); }
+        uint32 GetDebugInfoSize() override { return s_RealAlloc->GetDebugInfoSize(); }
+        void SaveDebugInfo(void* pvDebugInfo) override { s_RealAlloc->SaveDebugInfo(pvDebugInfo); }
+        void RestoreDebugInfo(const void* pvDebugInfo) override { s_RealAlloc->RestoreDebugInfo(pvDebugInfo); }
+        void InitDebugInfo(void* pvDebugInfo, const char* pchRootFileName, int nLine) override
+        {
+            s_RealAlloc->InitDebugInfo(pvDebugInfo, pchRootFileName, nLine);
+        }
+        void GlobalMemoryStatus(size_t* pUsedMemory, size_t* pFreeMemory) override
+        {
+            s_RealAlloc->GlobalMemoryStatus(pUsedMemory, pFreeMemory);
+        }
+    };
+
+    TrackingMemAlloc s_TrackingAlloc;
+    IMemAlloc* s_TrackingAllocPtr = &s_TrackingAlloc;
+
+    // Our import table slot for tier0's g_pMemAlloc, and what it originally pointed at
+    IMemAlloc*** s_MemAllocImport = nullptr;
+    IMemAlloc** s_OriginalMemAllocImport = nullptr;
+
+    IMemAlloc*** FindMemAllocImport()
+    {
+        HMODULE self;
+        if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                                reinterpret_cast<LPCSTR>(&FindMemAllocImport), &self))
+        {
+            return nullptr;
+        }
+
+        const auto base = reinterpret_cast<std::byte*>(self);
+        const auto dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+        const auto ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+        const auto& importDir = ntHeaders->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT];
+
+        // &g_pMemAlloc is read from the very slot we're looking for
+        const auto target = reinterpret_cast<uintptr_t>(&g_pMemAlloc);
+
+        for (auto desc = reinterpret_cast<const IMAGE_IMPORT_DESCRIPTOR*>(base + importDir.VirtualAddress);
+             desc->Name; desc++)
+        {
+            if (_stricmp(reinterpret_cast<const char*>(base + desc->Name), "tier0.dll"))
+                continue;
+
+            for (auto thunk = reinterpret_cast<IMAGE_THUNK_DATA*>(base + desc->FirstThunk); thunk->u1.Function;
+                 thunk++)
+            {
+                if (thunk->u1.Function == target)
+                    return reinterpret_cast<IMemAlloc***>(&thunk->u1.Function);
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool WriteImport(IMemAlloc*** slot, IMemAlloc** value)
+    {
+        DWORD oldProtect;
+        if (!VirtualProtect(slot, sizeof(*slot), PAGE_READWRITE, &oldProtect))
+            return false;
+
+        *slot = value;
+        VirtualProtect(slot, sizeof(*slot), oldProtect, &oldProtect);
+        return true;
+    }
+
+    bool InstallTracking()
+    {
+        if (s_MemAllocImport)
+            return true;
+
+        const auto slot = FindMemAllocImport();
+        if (!slot)
+        {
+            PluginWarning("Unable to find the g_pMemAlloc import, memory tracking is unavailable\n");
+            return false;
+        }
+
+        s_RealAlloc = g_pMemAlloc;
+        s_OriginalMemAllocImport = *slot;
+        s_LastSampleTime = Plat_FloatTime();
+
+        {
+            std::lock_guard lock(s_BlocksMutex);
+            s_Blocks.emplace();
+        }
+
+        if (!WriteImport(slot, &s_TrackingAllocPtr))
+        {
+            std::lock_guard lock(s_BlocksMutex);
+            s_Blocks.reset();
+            return false;
+        }
+
+        s_MemAllocImport = slot;
+        return true;
+    }
+
+    void UninstallTracking()
+    {
+        if (!s_MemAllocImport)
+            return;
+
+        // Anything allocated through the tracker was allocated by the real allocator, so it can
+        // be freed there directly from now on
+        WriteImport(s_MemAllocImport, s_OriginalMemAllocImport);
+        s_MemAllocImport = nullptr;
+
+        std::lock_guard lock(s_BlocksMutex);
+        s_Blocks.reset();
+
+        for (Tag tag = 0; tag < s_TagCount; tag++)
+        {
+            auto& stats = s_Tags[tag];
+            stats.m_LiveBytes = stats.m_PeakBytes = stats.m_LiveBlocks = 0;
+            stats.m_LevelStartBytes = stats.m_LevelStartBlocks = 0;
+        }
+    }
+
+    void PrintReport(const CCommand& args);
+    void PrintLeakReport();
+}
+
+static std::unique_ptr<MemoryTracker> s_MemoryTracker;
+
+bool MemoryTracker::Load()
+{
+    s_MemoryTracker.reset(new MemoryTracker());
+    return true;
+}
+bool MemoryTracker::Unload()
+{
+    s_MemoryTracker.reset();
+    return true;
+}
+
+MemoryTracker::MemoryTracker()
+    : ce_mem_tracking("ce_mem_tracking", "0", FCVAR_NONE,
+                      "Attributes the plugin's heap allocations to modules. See ce_mem_report.",
+                      [](IConVar* var, const char*, float)
+                      {
+                          if (!static_cast<ConVar*>(var)->GetBool())
+                              UninstallTracking();
+                          else if (!InstallTracking())
+                              static_cast<ConVar*>(var)->SetValue(0);
+                      }),
+      ce_mem_leak_report("ce_mem_leak_report", "0", FCVAR_NONE,
+                         "With ce_mem_tracking enabled, reports modules holding more memory at level shutdown than "
+                         "at level start."),
+      ce_mem_report("ce_mem_report", PrintReport,
+                    "Prints live bytes, peak bytes and allocation rate per module. Requires ce_mem_tracking 1. Pass "
+                    "\"reset\" to clear the peaks and counters.")
+{
+}
+
+MemoryTracker::~MemoryTracker() { UninstallTracking(); }
+
+Tag MemoryTracker::RegisterTag(const char* name)
+{
+    for (Tag tag = 1; tag < s_TagCount; tag++)
+    {
+        if (!strcmp(s_Tags[tag].m_Name, name))
+            return tag;
+    }
+
+    Assert(s_TagCount < MAX_TAGS);
+    if (s_TagCount >= MAX_TAGS)
+        return UNTAGGED;
+
+    const Tag tag = s_TagCount++;
+    strncpy_s(s_Tags[tag].m_Name, name, _TRUNCATE);
+    return tag;
+}
+
+Tag MemoryTracker::SetCurrentTag(Tag tag)
+{
+    const Tag previous = s_CurrentTag;
+    s_CurrentTag = tag;
+    return previous;
+}
+
+void MemoryTracker::Update()
+{
+    if (!s_MemAllocImport)
+        return;
+
+    const double now = Plat_FloatTime();
+    const double elapsed = now - s_LastSampleTime;
+    if (elapsed < 1)
+        return;
+
+    std::lock_guard lock(s_BlocksMutex);
+    for (Tag tag = 0; tag < s_TagCount; tag++)
+    {
+        auto& stats = s_Tags[tag];
+        stats.m_AllocationsPerSecond = float((stats.m_Allocations - stats.m_LastSampleAllocations) / elapsed);
+        stats.m_LastSampleAllocations = stats.m_Allocations;
+    }
+
+    s_LastSampleTime = now;
+}
+
+void MemoryTracker::LevelInit()
+{
+    std::lock_guard lock(s_BlocksMutex);
+    for (Tag tag = 0; tag < s_TagCount; tag++)
+    {
+        s_Tags[tag].m_LevelStartBytes = s_Tags[tag].m_LiveBytes;
+        s_Tags[tag].m_LevelStartBlocks = s_Tags[tag].m_LiveBlocks;
+    }
+}
+
+void MemoryTracker::LevelShutdown()
+{
+    if (s_MemAllocImport && s_MemoryTracker && s_MemoryTracker->ce_mem_leak_report.GetBool())
+        PrintLeakReport();
+}
+
+namespace
+{
+    const char* GetTagName(Tag tag) { return tag == MemoryTracker::UNTAGGED ? "(untagged)" : s_Tags[tag].m_Name; }
+
+    void PrintReport(const CCommand& args)
+    {
+        if (!s_MemAllocImport)
+        {
+            Warning("%s: ce_mem_tracking is disabled\n", args[0]);
+            return;
+        }
+
+        // Printing can allocate, which needs the lock, so nothing is printed while it's held
+        if (args.ArgC() > 1 && !stricmp(args[1], "reset"))
+        {
+            {
+                std::lock_guard lock(s_BlocksMutex);
+                for (Tag tag = 0; tag < s_TagCount; tag++)
+                {
+                    auto& stats = s_Tags[tag];
+                    stats.m_PeakBytes = stats.m_LiveBytes;
+                    stats.m_Allocations = stats.m_Frees = stats.m_LastSampleAllocations = 0;
+                    stats.m_AllocationsPerSecond = 0;
+                }
+            }
+
+            Msg("Reset memory counters.\n");
+            return;
+        }
+
+        std::array<TagStats, MemoryTracker::MAX_TAGS> tags;
+        {
+            std::lock_guard lock(s_BlocksMutex);
+            tags = s_Tags;
+        }
+
+        std::array<Tag, MemoryTracker::MAX_TAGS> order;
+        for (Tag tag = 0; tag < s_TagCount; tag++)
+            order[tag] = tag;
+
+        std::sort(order.begin(), order.begin() + s_TagCount,
+                  [&](Tag a, Tag b) { return tags[a].m_LiveBytes > tags[b].m_LiveBytes; });
+
+        int64_t totalLive = 0;
+        Msg("%-28s %12s %12s %10s %12s %10s\n", "Module", "Live bytes", "Peak bytes", "Blocks", "Allocations",
+            "Allocs/sec");
+        for (Tag i = 0; i < s_TagCount; i++)
+        {
+            const auto& stats = tags[order[i]];
+            if (!stats.m_Allocations && !stats.m_LiveBlocks)
+                continue;
+
+            Msg("%-28s %12lli %12lli %10lli %12llu %10.1f\n", GetTagName(order[i]), stats.m_LiveBytes,
+                stats.m_PeakBytes, stats.m_LiveBlocks, stats.m_Allocations, stats.m_AllocationsPerSecond);
+            totalLive += stats.m_LiveBytes;
+        }
+
+        Msg("%lli bytes live since tracking was enabled\n", totalLive);
+    }
+
+    void PrintLeakReport()
+    {
+        std::array<TagStats, MemoryTracker::MAX_TAGS> tags;
+        {
+            std::lock_guard lock(s_BlocksMutex);
+            tags = s_Tags;
+        }
+
+        bool any = false;
+        for (Tag tag = 0; tag < s_TagCount; tag++)
+        {
+            const auto& stats = tags[tag];
+            const int64_t bytes = stats.m_LiveBytes - stats.m_LevelStartBytes;
+            const int64_t blocks = stats.m_LiveBlocks - stats.m_LevelStartBlocks;
+            if (bytes <= 0 && blocks <= 0)
+                continue;
+
+            if (!any)
+                PluginWarning("Memory still held at level shutdown that wasn't at level start:\n");
+
+            Warning("    %-28s %+lli bytes in %+lli blocks\n", GetTagName(tag), bytes, blocks);
+            any = true;
+        }
+    }
+}
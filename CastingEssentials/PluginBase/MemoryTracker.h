@@ -0,0 +1,63 @@
+#pragma once
+
+#include <convar.h>
+
+#include <cstdint>
+
+// Attributes this plugin's heap traffic to whichever module caused it.
+//
+// Every allocation the plugin makes goes through memoverride.cpp, which calls g_pMemAlloc. While
+// ce_mem_tracking is enabled, our own import of g_pMemAlloc is pointed at a forwarding allocator
+// that records each block against the current tag, so the rest of the game never sees it. The
+// module manager sets the tag around module construction, OnTick, LevelInit and LevelShutdown,
+// and Hook<> and GameEventSubscription remember the tag they were created under and set it
+// around their callbacks.
+//
+// The current tag is per thread, since some hooks are called from engine worker threads. Threads
+// that never set one count as untagged.
+class MemoryTracker final
+{
+public:
+    using Tag = uint16_t;
+    static constexpr Tag UNTAGGED = 0;
+    static constexpr Tag MAX_TAGS = 128;
+
+    ~MemoryTracker();
+
+    static bool Load();
+    static bool Unload(); // Also turns tracking off
+
+    // Returns the existing tag if the name has already been registered
+    static Tag RegisterTag(const char* name);
+
+    static Tag GetCurrentTag() { return s_CurrentTag; }
+    static Tag SetCurrentTag(Tag tag);
+
+    // Called once per tick by the module manager
+    static void Update();
+
+    static void LevelInit();
+    static void LevelShutdown();
+
+private:
+    MemoryTracker();
+
+    static thread_local Tag s_CurrentTag;
+
+    ConVar ce_mem_tracking;
+    ConVar ce_mem_leak_report;
+    ConCommand ce_mem_report;
+};
+
+class MemoryScope final
+{
+public:
+    explicit MemoryScope(MemoryTracker::Tag tag) : m_Previous(MemoryTracker::SetCurrentTag(tag)) {}
+    ~MemoryScope() { MemoryTracker::SetCurrentTag(m_Previous); }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemoryTracker::Tag m_Previous;
+};
@@ -1,10 +1,18 @@
 #include "Modules.h"
 #include "Controls/StubPanel.h"
+#include "Hooking/HookTransaction.h"
+#include "PluginBase/FrameArena.h"
 #include "PluginBase/Interfaces.h"
+#include "PluginBase/MemoryTracker.h"
+#include "PluginBase/PlayerHistory.h"
+#include "PluginBase/TickRecorder.h"
+#include "PluginBase/WorldSnapshot.h"
 
 #include <cdll_int.h>
 #include <vprof.h>
 
+#include <algorithm>
+
 static ModuleManager s_ModuleManager;
 ModuleManager& Modules() { return s_ModuleManager; }
 
@@ -27,11 +35,16 @@ void ModuleManager::Init() { m_Panel.reset(new Panel()); }
 
 void ModuleManager::UnloadAllModules()
 {
+    DestroyDeactivatedModules();
+
     for (auto iterator = modules.rbegin(); iterator != modules.rend(); iterator++)
     {
         auto mod = iterator->m_Module->ReplaceSingleton(nullptr); // Grab the singleton instance
         const std::string moduleName(mod->GetModuleName());
-        mod = nullptr;
+        {
+            MemoryScope scope(iterator->m_MemoryTag);
+            mod = nullptr;
+        }
         PluginColorMsg(Color(0, 255, 0, 255), "Module %s unloaded!\n", moduleName.c_str());
     }
 
@@ -41,12 +54,18 @@ void ModuleManager::UnloadAllModules()
 
 void ModuleManager::LoadAll()
 {
+    // Every module's hooks go in together once they've all been constructed
+    Hooking::HookTransaction transaction("Module load");
+
     auto md = g_ModuleList;
     while (md)
     {
         try
         {
-            Load(*md);
+            if (md->lazy)
+                PluginMsg("Module %s is dormant until enabled.\n", md->name.c_str());
+            else
+                Load(*md);
         }
         catch (const std::exception&)
         {
@@ -55,6 +74,76 @@ void ModuleManager::LoadAll()
     }
 }
 
+ModuleDesc& ModuleManager::FindDesc(const std::type_info& ti)
+{
+    for (auto md = g_ModuleList; md; md = md->next)
+    {
+        if (md->ti == ti)
+            return *md;
+    }
+
+    throw module_load_failed(ti.name());
+}
+
+void ModuleManager::SetActive(ModuleDesc& desc, bool active)
+{
+    Assert(desc.lazy);
+
+    if (active)
+    {
+        if (desc.state == ModuleState::MODULE_LOADED)
+            return;
+
+        try
+        {
+            Hooking::HookTransaction transaction(desc.name.c_str());
+            Load(desc);
+        }
+        catch (const std::exception&)
+        {
+            return;
+        }
+
+        // Anything activated mid-level missed LevelInit
+        const auto& data = modules.back();
+        if (IBaseModule::s_InGame)
+        {
+            MemoryScope scope(data.m_MemoryTag);
+            data.m_Module->LevelInit();
+        }
+    }
+    else
+    {
+        if (desc.state != ModuleState::MODULE_LOADED)
+            return;
+
+        auto found = std::find_if(modules.begin(), modules.end(),
+                                  [&](const ModuleData& data) { return data.m_Desc == &desc && data.m_Module; });
+        if (found == modules.end())
+            return; // Already dropped after a failed tick
+
+        // Callers see it as gone straight away, but the instance lives until the next tick
+        m_Deactivated.emplace_back(found->m_Module->ReplaceSingleton(nullptr), found->m_MemoryTag);
+        found->m_Module = nullptr;
+        desc.state = ModuleState::MODULE_UNLOADED;
+
+        PluginColorMsg(Color(0, 255, 0, 255), "Module %s deactivated.\n", desc.name.c_str());
+    }
+}
+
+void ModuleManager::DestroyDeactivatedModules()
+{
+    for (auto& [mod, tag] : m_Deactivated)
+    {
+        MemoryScope scope(tag);
+        mod.reset();
+    }
+
+    m_Deactivated.clear();
+    modules.erase(std::remove_if(modules.begin(), modules.end(), [](const ModuleData& data) { return !data.m_Module; }),
+                  modules.end());
+}
+
 void ModuleManager::Load(ModuleDesc& desc)
 {
     switch (desc.state)
@@ -70,9 +159,15 @@ void ModuleManager::Load(ModuleDesc& desc)
     desc.state = ModuleState::MODULE_LOADING;
     try
     {
-        auto mod = desc.factory();
+        // Dependencies loaded from inside the factory register their own tags
+        const auto tag = MemoryTracker::RegisterTag(desc.name.c_str());
+        std::unique_ptr<IBaseModule> mod;
+        {
+            MemoryScope scope(tag);
+            mod = desc.factory();
+        }
         Assert(mod);
-        modules.push_back({mod.get()});
+        modules.push_back({mod.get(), tag, &desc});
         mod->ReplaceSingleton(std::move(mod));
         desc.state = ModuleState::MODULE_LOADED;
         PluginColorMsg(Color(0, 255, 0, 255), "Module %s loaded successfully!\n", desc.name.c_str());
@@ -103,15 +198,37 @@ void ModuleManager::Panel::LevelInitAllModules()
 {
     IBaseModule::s_InGame = true;
 
-    for (const auto& data : Modules().modules)
+    MemoryTracker::LevelInit();
+
+    // Indexed, since a module's LevelInit can enable a lazy module. Those get their LevelInit when
+    // they're activated.
+    auto& modules = Modules().modules;
+    for (size_t i = 0, count = modules.size(); i < count; i++)
+    {
+        const auto data = modules[i];
+        if (!data.m_Module)
+            continue;
+
+        MemoryScope scope(data.m_MemoryTag);
         data.m_Module->LevelInit();
+    }
 }
 void ModuleManager::Panel::LevelShutdownAllModules()
 {
     IBaseModule::s_InGame = false;
 
-    for (const auto& data : Modules().modules)
+    auto& modules = Modules().modules;
+    for (size_t i = 0, count = modules.size(); i < count; i++)
+    {
+        const auto data = modules[i];
+        if (!data.m_Module)
+            continue;
+
+        MemoryScope scope(data.m_MemoryTag);
         data.m_Module->LevelShutdown();
+    }
+
+    MemoryTracker::LevelShutdown();
 }
 
 void ModuleManager::Panel::OnTick()
@@ -145,19 +262,34 @@ void ModuleManager::Panel::OnTick()
 
 void ModuleManager::TickAllModules(bool inGame)
 {
-    auto ite = modules.begin();
-    while (ite != modules.end())
+    FrameArena::GetTickArena().Reset();
+
+    // Build the shared snapshot before any module looks at it, so its deltas cover exactly one tick.
+    // The player history and any running tick recording capture it at the same time.
+    GetPlayerHistory()->Record(WorldSnapshot::Get(), inGame);
+    GetTickRecorder()->Record(WorldSnapshot::Get(), inGame);
+
+    MemoryTracker::Update();
+
+    DestroyDeactivatedModules();
+
+    // Indexed, since modules can be activated and deactivated from inside OnTick
+    for (size_t i = 0; i < modules.size(); i++)
     {
+        const auto data = modules[i];
+        if (!data.m_Module)
+            continue;
+
         try
         {
-            ite->m_Module->OnTick(inGame);
-            ++ite;
+            MemoryScope scope(data.m_MemoryTag);
+            data.m_Module->OnTick(inGame);
         }
         catch (std::exception e)
         {
             PluginColorMsg(Color(255, 0, 0, 255), "Module %s tick failed, disabling: %s\n",
-                           ite->m_Module->GetModuleName(), e.what());
-            ite = modules.erase(ite);
+                           data.m_Module->GetModuleName(), e.what());
+            modules[i].m_Module = nullptr;
         }
     }
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "Exceptions.h"
+#include "MemoryTracker.h"
 
 class IBaseModule
 {
@@ -46,6 +47,9 @@ public:
         return static_cast<T*>(s_Module.get());
     }
 
+    // For lazy modules, whose convars outlive them: nullptr while dormant
+    static __forceinline T* TryGetModule() { return static_cast<T*>(s_Module.get()); }
+
 private:
     friend class ModuleManager;
 
@@ -80,10 +84,12 @@ struct ModuleDesc
     std::function<std::unique_ptr<IBaseModule>()> factory;
     const std::string name;
     ModuleState state = ModuleState::MODULE_UNLOADED;
+    const bool lazy;
     ModuleDesc* next;
 
-    ModuleDesc(const std::type_info& ti, const char* name, std::function<std::unique_ptr<IBaseModule>()> factory)
-        : ti(ti), name(name), factory(factory)
+    ModuleDesc(const std::type_info& ti, const char* name, std::function<std::unique_ptr<IBaseModule>()> factory,
+               bool lazy = false)
+        : ti(ti), factory(factory), name(name), lazy(lazy)
     {
         this->next = g_ModuleList;
         g_ModuleList = this;
@@ -97,6 +103,20 @@ struct ModuleDesc
         return std::make_unique<T>();                                                                                  \
     });
 
+// Lazy modules stay dormant until they're enabled. While dormant only their convars exist, so those
+// are static members, and their enable convars call ModuleManager::UpdateLazyModule(). Dependency
+// checks, construction and hooks all wait for the first enable, and the module is destroyed again
+// when it's disabled. Nothing may Depend<> on a lazy module.
+#define MODULE_REGISTER_LAZY(T)                                                                                        \
+    ModuleDesc module_desc_##T(                                                                                        \
+        typeid(T), T::GetModuleName(),                                                                                 \
+        []() -> std::unique_ptr<IBaseModule> {                                                                         \
+            if (!T::CheckDependencies())                                                                               \
+                throw module_load_failed(T::GetModuleName());                                                          \
+            return std::make_unique<T>();                                                                              \
+        },                                                                                                             \
+        true);
+
 class ModuleManager final
 {
 public:
@@ -111,10 +131,19 @@ public:
     void Depend();
     void LoadAll();
 
+    // Activates a lazy module if it should be active, lets the live module react to whatever
+    // changed, then deactivates it if it's no longer needed
+    template<typename ModuleType, typename Fn>
+    void UpdateLazyModule(bool active, const Fn& onChanged);
+
     std::size_t size() { return modules.size(); }
 
 private:
     void Load(ModuleDesc& desc);
+    ModuleDesc& FindDesc(const std::type_info& ti);
+
+    void SetActive(ModuleDesc& desc, bool active);
+    void DestroyDeactivatedModules();
 
     class Panel;
     std::unique_ptr<Panel> m_Panel;
@@ -123,10 +152,16 @@ private:
 
     struct ModuleData
     {
-        IBaseModule* m_Module;
+        IBaseModule* m_Module; // nullptr once deactivated, until the next tick
+        MemoryTracker::Tag m_MemoryTag;
+        ModuleDesc* m_Desc;
     };
 
     std::vector<ModuleData> modules;
+
+    // Deactivated lazy modules are kept alive until the start of the next tick, in case they were
+    // disabled from inside one of their own callbacks
+    std::vector<std::pair<std::unique_ptr<IBaseModule>, MemoryTracker::Tag>> m_Deactivated;
 };
 
 template<typename ModuleType>
@@ -144,26 +179,33 @@ inline constexpr const char* ModuleManager::GetModuleName() const
 template<typename ModuleType>
 inline void ModuleManager::Depend()
 {
-    // Find the module we need in the global list
-    const auto& ti = typeid(ModuleType);
-    auto md = g_ModuleList;
-    while (md)
+    auto& desc = FindDesc(typeid(ModuleType));
+    Assert(!desc.lazy);
+
+    try
+    {
+        Load(desc);
+    }
+    catch (const std::exception&)
     {
-        if (md->ti == ti)
-        {
-            try
-            {
-                Load(*md);
-            }
-            catch (const std::exception&)
-            {
-                throw module_dependency_failed(md->name.c_str());
-            }
-            return;
-        }
-        md = md->next;
+        throw module_dependency_failed(desc.name.c_str());
     }
-    throw module_load_failed(ti.name());
+}
+
+template<typename ModuleType, typename Fn>
+inline void ModuleManager::UpdateLazyModule(bool active, const Fn& onChanged)
+{
+    auto& desc = FindDesc(typeid(ModuleType));
+    Assert(desc.lazy);
+
+    if (active)
+        SetActive(desc, true);
+
+    if (auto mod = ModuleType::TryGetModule())
+        onChanged(mod);
+
+    if (!active)
+        SetActive(desc, false);
 }
 
 extern ModuleManager& Modules();
\ No newline at end of file
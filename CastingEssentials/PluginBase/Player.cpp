@@ -274,7 +274,7 @@ int Player::GetMaxHealth() const
     return 1; // So we avoid dividing by zero somewhere
 }
 
-int Player::GetMaxOverheal() const { return (int(GetMaxHealth() * 1.5f) / 5) * 5; }
+int Player::GetMaxOverheal() const { return GetMaxOverheal(GetMaxHealth()); }
 
 bool Player::IsValid() const
 {
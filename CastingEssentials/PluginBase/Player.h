@@ -49,6 +49,7 @@ public:
     int GetHealth() const;
     int GetMaxHealth() const;
     int GetMaxOverheal() const;
+    static int GetMaxOverheal(int maxHealth) { return (int(maxHealth * 1.5f) / 5) * 5; }
     const char* GetName() const;
     static const char* GetName(int entIndex);
     ObserverMode GetObserverMode() const;
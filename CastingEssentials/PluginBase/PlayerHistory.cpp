@@ -0,0 +1,409 @@
+#include "PlayerHistory.h"
+
+#include "Common.h"
+#include "Entities.h"
+#include "Interfaces.h"
+#include "WorldSnapshot.h"
+
+#include <client_class.h>
+#include <convar.h>
+#include <icliententitylist.h>
+#include <mathlib/mathlib.h>
+#include <toolframework/ienginetool.h>
+#include <vprof.h>
+#include <worldsize.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+
+#undef max
+#undef min
+
+static_assert(MAX_PLAYERS < 0x80, "entindex shares a byte with the alive flag");
+
+static std::unique_ptr<PlayerHistory> s_PlayerHistory;
+PlayerHistory* GetPlayerHistory()
+{
+    Assert(s_PlayerHistory);
+    return s_PlayerHistory.get();
+}
+
+struct PlayerHistory::Commands
+{
+    Commands();
+
+    ConCommand ce_playerhistory_stats;
+    ConCommand ce_playerhistory_benchmark;
+};
+
+bool PlayerHistory::Load()
+{
+    s_PlayerHistory.reset(new PlayerHistory());
+    s_PlayerHistory->m_Commands = std::make_unique<Commands>();
+    return true;
+}
+bool PlayerHistory::Unload()
+{
+    s_PlayerHistory.reset();
+    return true;
+}
+
+static constexpr float ANGLE_TO_PACKED = 32768.0f / 180.0f;
+static constexpr float PACKED_TO_ANGLE = 180.0f / 32768.0f;
+
+static int16_t PackAngle(float angle) { return int16_t(int(AngleNormalize(angle) * ANGLE_TO_PACKED)); }
+
+// Shortest way around, so interpolating from 179 to -179 doesn't spin through 0
+static float LerpAngle(float from, float to, float t) { return from + AngleNormalize(to - from) * t; }
+
+PlayerHistory::PlayerHistory()
+{
+    const Vector maxCoord(MAX_COORD_FLOAT, MAX_COORD_FLOAT, MAX_COORD_FLOAT);
+    Reset(-maxCoord, maxCoord);
+}
+PlayerHistory::~PlayerHistory() = default;
+
+void PlayerHistory::Reset(const Vector& worldMins, const Vector& worldMaxs)
+{
+    m_WorldMins = worldMins;
+    for (int i = 0; i < 3; i++)
+    {
+        const float range = std::max(worldMaxs[i] - worldMins[i], 1.0f);
+        m_QuantizeScale[i] = 65535 / range;
+        m_DequantizeScale[i] = range / 65535;
+    }
+
+    m_FrameCount = m_OldestFrame = m_SampleCount = 0;
+}
+
+void PlayerHistory::Record(const WorldSnapshot& snapshot, bool inGame)
+{
+    if (!inGame)
+    {
+        if (!IsEmpty())
+        {
+            const Vector maxCoord(MAX_COORD_FLOAT, MAX_COORD_FLOAT, MAX_COORD_FLOAT);
+            Reset(-maxCoord, maxCoord);
+        }
+
+        return;
+    }
+
+    const auto engineTool = Interfaces::GetEngineTool();
+    const int tick = engineTool->ClientTick();
+    if (!IsEmpty() && tick == GetNewestTick())
+        return;
+
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    const auto startTime = std::chrono::high_resolution_clock::now();
+
+    // New map, or a demo seeked backwards. Quantize relative to this map's bounds if we can find
+    // them, otherwise the whole coordinate range (still 0.5 unit precision).
+    if (IsEmpty() || tick < GetNewestTick())
+    {
+        Vector mins(-MAX_COORD_FLOAT, -MAX_COORD_FLOAT, -MAX_COORD_FLOAT);
+        Vector maxs(MAX_COORD_FLOAT, MAX_COORD_FLOAT, MAX_COORD_FLOAT);
+
+        if (auto world = Interfaces::GetClientEntityList()->GetClientNetworkable(0))
+        {
+            const auto cc = world->GetClientClass();
+            const auto minsProp = Entities::RetrieveClassPropOffset(cc, "m_WorldMins");
+            const auto maxsProp = Entities::RetrieveClassPropOffset(cc, "m_WorldMaxs");
+            if (minsProp.first >= 0 && maxsProp.first >= 0)
+            {
+                const auto base = static_cast<const std::byte*>(world->GetDataTableBasePtr());
+                mins = *reinterpret_cast<const Vector*>(base + minsProp.first);
+                maxs = *reinterpret_cast<const Vector*>(base + maxsProp.first);
+            }
+        }
+
+        Reset(mins, maxs);
+    }
+
+    BeginFrame(tick, engineTool->ClientTime());
+    AddSamples(snapshot);
+
+    m_RecordedFrames++;
+    m_RecordSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+}
+
+void PlayerHistory::AddSamples(const WorldSnapshot& snapshot)
+{
+    const auto& valid = snapshot.GetValidSlots();
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        if (!valid[i])
+            continue;
+
+        const int entindex = i + 1;
+        AddSample(entindex, snapshot.GetAbsOrigin(entindex), snapshot.GetEyeAngles(entindex),
+                  snapshot.GetObserverTarget(entindex), snapshot.IsAlive(entindex));
+    }
+}
+
+void PlayerHistory::BeginFrame(int tick, float time)
+{
+    // Completely empty frames still get an entry so lookups by tick don't skip over them
+    if (m_FrameCount - m_OldestFrame >= FRAME_CAPACITY)
+        m_OldestFrame++;
+
+    auto& frame = m_Frames[m_FrameCount++ % FRAME_CAPACITY];
+    frame.m_Tick = tick;
+    frame.m_Time = time;
+    frame.m_FirstSample = m_SampleCount;
+    frame.m_SampleCount = 0;
+}
+
+void PlayerHistory::AddSample(int entindex, const Vector& origin, const QAngle& eyeAngles, int observerTarget,
+                              bool alive)
+{
+    Assert(m_FrameCount != m_OldestFrame);
+    Assert(entindex > 0 && entindex < ALIVE_BIT);
+
+    auto& frame = m_Frames[(m_FrameCount - 1) % FRAME_CAPACITY];
+    if (frame.m_SampleCount >= SAMPLE_CAPACITY)
+        return;
+
+    auto& packed = m_Samples[m_SampleCount++ % SAMPLE_CAPACITY];
+    frame.m_SampleCount++;
+
+    for (int i = 0; i < 3; i++)
+    {
+        const float quantized = (origin[i] - m_WorldMins[i]) * m_QuantizeScale[i] + 0.5f;
+        packed.m_Origin[i] = uint16_t(std::clamp(quantized, 0.0f, 65535.0f));
+    }
+
+    packed.m_Angles[0] = PackAngle(eyeAngles[PITCH]);
+    packed.m_Angles[1] = PackAngle(eyeAngles[YAW]);
+    packed.m_Player = uint8_t(entindex) | (alive ? ALIVE_BIT : 0);
+    packed.m_ObserverTarget = observerTarget > 0 && observerTarget <= 255 ? uint8_t(observerTarget) : 0;
+
+    DropOverwrittenFrames();
+}
+
+void PlayerHistory::DropOverwrittenFrames()
+{
+    while (m_OldestFrame != m_FrameCount &&
+           m_SampleCount - GetFrame(m_OldestFrame).m_FirstSample > SAMPLE_CAPACITY)
+    {
+        m_OldestFrame++;
+    }
+}
+
+int PlayerHistory::GetOldestTick() const { return IsEmpty() ? -1 : GetFrame(m_OldestFrame).m_Tick; }
+int PlayerHistory::GetNewestTick() const { return IsEmpty() ? -1 : GetFrame(m_FrameCount - 1).m_Tick; }
+float PlayerHistory::GetOldestTime() const { return IsEmpty() ? 0 : GetFrame(m_OldestFrame).m_Time; }
+float PlayerHistory::GetNewestTime() const { return IsEmpty() ? 0 : GetFrame(m_FrameCount - 1).m_Time; }
+
+uint32_t PlayerHistory::FindFrame(float time) const
+{
+    // Last frame with m_Time <= time. Frames are in increasing time order, since Record() starts
+    // over whenever time goes backwards.
+    uint32_t low = m_OldestFrame;
+    uint32_t count = m_FrameCount - m_OldestFrame;
+    while (count > 0)
+    {
+        const uint32_t half = count / 2;
+        if (GetFrame(low + half).m_Time <= time)
+        {
+            low += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+
+    return low == m_OldestFrame ? m_OldestFrame : low - 1;
+}
+
+const PlayerHistory::PackedSample* PlayerHistory::FindSample(const Frame& frame, int entindex) const
+{
+    // Samples are written in entindex order, and there are only ever a few dozen per frame
+    for (uint32_t i = 0; i < frame.m_SampleCount; i++)
+    {
+        const auto& packed = m_Samples[(frame.m_FirstSample + i) % SAMPLE_CAPACITY];
+        const int player = packed.m_Player & ~ALIVE_BIT;
+        if (player == entindex)
+            return &packed;
+        if (player > entindex)
+            break;
+    }
+
+    return nullptr;
+}
+
+void PlayerHistory::Unpack(const PackedSample& packed, Sample& out) const
+{
+    for (int i = 0; i < 3; i++)
+        out.m_Origin[i] = m_WorldMins[i] + packed.m_Origin[i] * m_DequantizeScale[i];
+
+    out.m_EyeAngles.Init(packed.m_Angles[0] * PACKED_TO_ANGLE, packed.m_Angles[1] * PACKED_TO_ANGLE, 0);
+    out.m_ObserverTarget = packed.m_ObserverTarget;
+    out.m_Alive = (packed.m_Player & ALIVE_BIT) != 0;
+}
+
+bool PlayerHistory::GetSample(int entindex, int tick, Sample& out) const
+{
+    if (IsEmpty() || tick < GetOldestTick())
+        return false;
+
+    // Same search as FindFrame, but on ticks
+    uint32_t low = m_OldestFrame;
+    uint32_t count = m_FrameCount - m_OldestFrame;
+    while (count > 0)
+    {
+        const uint32_t half = count / 2;
+        if (GetFrame(low + half).m_Tick <= tick)
+        {
+            low += half + 1;
+            count -= half + 1;
+        }
+        else
+        {
+            count = half;
+        }
+    }
+
+    const auto packed = FindSample(GetFrame(low - 1), entindex);
+    if (!packed)
+        return false;
+
+    Unpack(*packed, out);
+    return true;
+}
+
+bool PlayerHistory::GetSampleAtTime(int entindex, float time, Sample& out) const
+{
+    if (IsEmpty())
+        return false;
+
+    const uint32_t frameIndex = FindFrame(time);
+    const auto& frame = GetFrame(frameIndex);
+    const auto packed = FindSample(frame, entindex);
+    if (!packed)
+        return false;
+
+    Unpack(*packed, out);
+
+    if (frameIndex + 1 == m_FrameCount || time <= frame.m_Time)
+        return true;
+
+    const auto& nextFrame = GetFrame(frameIndex + 1);
+    const auto nextPacked = FindSample(nextFrame, entindex);
+    if (!nextPacked)
+        return true;
+
+    Sample next;
+    Unpack(*nextPacked, next);
+
+    const float t = std::clamp((time - frame.m_Time) / std::max(nextFrame.m_Time - frame.m_Time, 0.0001f), 0.0f, 1.0f);
+    out.m_Origin = Lerp(t, out.m_Origin, next.m_Origin);
+    out.m_EyeAngles[PITCH] = Lerp(t, out.m_EyeAngles[PITCH], next.m_EyeAngles[PITCH]);
+    out.m_EyeAngles[YAW] = LerpAngle(out.m_EyeAngles[YAW], next.m_EyeAngles[YAW], t);
+    return true;
+}
+
+bool PlayerHistory::GetVelocity(int entindex, float window, Vector& out) const
+{
+    if (IsEmpty() || window <= 0)
+        return false;
+
+    const float newestTime = GetNewestTime();
+    const float oldestTime = std::max(newestTime - window, GetOldestTime());
+    if (newestTime <= oldestTime)
+        return false;
+
+    Sample newest, oldest;
+    if (!GetSampleAtTime(entindex, newestTime, newest) || !GetSampleAtTime(entindex, oldestTime, oldest))
+        return false;
+
+    out = (newest.m_Origin - oldest.m_Origin) / (newestTime - oldestTime);
+    return true;
+}
+
+PlayerHistory::Commands::Commands()
+    : ce_playerhistory_stats(
+          "ce_playerhistory_stats", []() { GetPlayerHistory()->PrintStats(); },
+          "Prints how much player position history is being kept, and what it costs."),
+      ce_playerhistory_benchmark(
+          "ce_playerhistory_benchmark", RunBenchmark,
+          "Fills a scratch history with synthetic players (default 32 at 66 ticks/sec for 60 seconds) and reports "
+          "insertion and lookup cost. Usage: ce_playerhistory_benchmark [players] [tickrate] [seconds]")
+{
+}
+
+void PlayerHistory::PrintStats() const
+{
+    const uint32_t frames = m_FrameCount - m_OldestFrame;
+    const uint32_t samples = IsEmpty() ? 0 : m_SampleCount - GetFrame(m_OldestFrame).m_FirstSample;
+
+    Msg("Player history: %u/%u frames, %u/%u samples, %1.2f seconds (ticks %i to %i)\n", frames,
+        (uint32_t)FRAME_CAPACITY, samples, (uint32_t)SAMPLE_CAPACITY, GetNewestTime() - GetOldestTime(),
+        GetOldestTick(), GetNewestTick());
+    Msg("    %i bytes (%i per sample), %1.2f us average per recorded tick\n", (int)sizeof(PlayerHistory),
+        (int)sizeof(PackedSample), m_RecordedFrames ? m_RecordSeconds * 1e6 / m_RecordedFrames : 0.0);
+}
+
+void PlayerHistory::RunBenchmark(const CCommand& args)
+{
+    int players = 32;
+    int tickrate = 66;
+    int seconds = 60;
+    if ((args.ArgC() > 1 && !TryParseInteger(args[1], players)) ||
+        (args.ArgC() > 2 && !TryParseInteger(args[2], tickrate)) ||
+        (args.ArgC() > 3 && !TryParseInteger(args[3], seconds)))
+    {
+        Warning("Usage: %s [players] [tickrate] [seconds]\n", args[0]);
+        return;
+    }
+
+    players = std::clamp(players, 1, MAX_PLAYERS);
+    tickrate = std::clamp(tickrate, 1, 1000);
+    seconds = std::clamp(seconds, 1, 3600);
+
+    // Scratch instance, so the benchmark doesn't wipe the real history
+    auto history = std::make_unique<PlayerHistory>();
+    history->Reset(Vector(-8192, -8192, -2048), Vector(8192, 8192, 2048));
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> coord(-4096, 4096);
+    std::uniform_real_distribution<float> angle(-180, 180);
+
+    const int ticks = tickrate * seconds;
+    const float interval = 1.0f / tickrate;
+
+    using clock = std::chrono::high_resolution_clock;
+    const auto insertStart = clock::now();
+    for (int tick = 0; tick < ticks; tick++)
+    {
+        history->BeginFrame(tick, tick * interval);
+        for (int player = 1; player <= players; player++)
+        {
+            history->AddSample(player, Vector(coord(random), coord(random), coord(random)),
+                               QAngle(angle(random) / 2, angle(random), 0), (player % players) + 1, true);
+        }
+    }
+    const auto insertSeconds = std::chrono::duration<double>(clock::now() - insertStart).count();
+
+    constexpr int LOOKUPS = 100000;
+    std::uniform_real_distribution<float> lookupTime(history->GetOldestTime(), history->GetNewestTime());
+    std::uniform_int_distribution<int> lookupPlayer(1, players);
+
+    int found = 0;
+    PlayerHistory::Sample sample;
+    const auto lookupStart = clock::now();
+    for (int i = 0; i < LOOKUPS; i++)
+        found += history->GetSampleAtTime(lookupPlayer(random), lookupTime(random), sample);
+    const auto lookupSeconds = std::chrono::duration<double>(clock::now() - lookupStart).count();
+
+    Msg("%i players at %i ticks/sec for %i seconds:\n", players, tickrate, seconds);
+    Msg("    %i bytes total, %1.2f seconds retained\n", (int)sizeof(PlayerHistory),
+        history->GetNewestTime() - history->GetOldestTime());
+    Msg("    insert: %1.3f us per tick, %1.1f ns per sample\n", insertSeconds * 1e6 / ticks,
+        insertSeconds * 1e9 / (double(ticks) * players));
+    Msg("    interpolated lookup: %1.1f ns (%i/%i found)\n", lookupSeconds * 1e9 / LOOKUPS, found, LOOKUPS);
+}
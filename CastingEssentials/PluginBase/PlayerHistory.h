@@ -0,0 +1,113 @@
+#pragma once
+
+#include <mathlib/vector.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+class CCommand;
+class WorldSnapshot;
+
+// Fixed-size history of where every player was over the last several seconds.
+//
+// Once per client tick the module manager copies origin, eye angles, observer target and alive
+// state out of the WorldSnapshot into a ring of quantized samples: origins as 16-bit fixed
+// point relative to the map bounds, angles as 16-bit fractions of a turn. Samples for one tick
+// are stored contiguously, and a second ring of frames maps ticks to their samples. Nothing is
+// allocated after construction; when the sample ring wraps, the oldest frames drop out.
+//
+// GetPlayerHistory() is the one fed by the module manager, but scratch instances work the same.
+class PlayerHistory final
+{
+public:
+    static constexpr size_t FRAME_CAPACITY = 1024;
+    static constexpr size_t SAMPLE_CAPACITY = 24576; // ~11.5 seconds of 32 players at 66 ticks/sec
+
+    struct Sample
+    {
+        Vector m_Origin;
+        QAngle m_EyeAngles;
+        int m_ObserverTarget; // entindex, 0 if none
+        bool m_Alive;
+    };
+
+    PlayerHistory();
+    ~PlayerHistory();
+
+    static bool Load();
+    static bool Unload();
+
+    // Records the snapshot for the current client tick, if it hasn't been recorded already.
+    void Record(const WorldSnapshot& snapshot, bool inGame);
+
+    void Reset(const Vector& worldMins, const Vector& worldMaxs);
+    void BeginFrame(int tick, float time);
+    void AddSample(int entindex, const Vector& origin, const QAngle& eyeAngles, int observerTarget, bool alive);
+    void AddSamples(const WorldSnapshot& snapshot); // Every valid player in the snapshot
+
+    bool IsEmpty() const { return m_FrameCount == m_OldestFrame; }
+    int GetOldestTick() const;
+    int GetNewestTick() const;
+    float GetOldestTime() const;
+    float GetNewestTime() const;
+
+    // The most recent sample at or before the given tick.
+    bool GetSample(int entindex, int tick, Sample& out) const;
+
+    // Linearly interpolated between the two frames surrounding time. Observer target and alive
+    // state come from the earlier frame.
+    bool GetSampleAtTime(int entindex, float time, Sample& out) const;
+
+    // Average velocity over the last window seconds.
+    bool GetVelocity(int entindex, float window, Vector& out) const;
+
+private:
+    struct PackedSample
+    {
+        uint16_t m_Origin[3];
+        int16_t m_Angles[2]; // pitch, yaw; roll is always 0 for players
+        uint8_t m_Player;    // entindex, ALIVE_BIT set if alive
+        uint8_t m_ObserverTarget;
+    };
+    static_assert(sizeof(PackedSample) == 12);
+    static constexpr uint8_t ALIVE_BIT = 0x80;
+
+    struct Frame
+    {
+        int m_Tick;
+        float m_Time;
+        uint32_t m_FirstSample; // Index into the (unwrapped) sample stream
+        uint16_t m_SampleCount;
+    };
+
+    const Frame& GetFrame(uint32_t frame) const { return m_Frames[frame % FRAME_CAPACITY]; }
+    uint32_t FindFrame(float time) const;
+    const PackedSample* FindSample(const Frame& frame, int entindex) const;
+    void Unpack(const PackedSample& packed, Sample& out) const;
+    void DropOverwrittenFrames();
+
+    Vector m_WorldMins;
+    Vector m_QuantizeScale;
+    Vector m_DequantizeScale;
+
+    // Monotonic counters, wrapped into the rings with % *_CAPACITY
+    uint32_t m_FrameCount = 0;
+    uint32_t m_OldestFrame = 0;
+    uint32_t m_SampleCount = 0;
+
+    std::array<Frame, FRAME_CAPACITY> m_Frames;
+    std::array<PackedSample, SAMPLE_CAPACITY> m_Samples;
+
+    uint64_t m_RecordedFrames = 0;
+    double m_RecordSeconds = 0;
+
+    void PrintStats() const;
+    static void RunBenchmark(const CCommand& args);
+
+    // Only the instance created by Load() has these, so scratch instances don't register them again
+    struct Commands;
+    std::unique_ptr<Commands> m_Commands;
+};
+
+extern PlayerHistory* GetPlayerHistory();
@@ -0,0 +1,291 @@
+#include "RecvProxyRouter.h"
+#include "PluginBase/Common.h"
+
+#include <vprof.h>
+
+#include <algorithm>
+#include <bit>
+
+static std::unique_ptr<RecvProxyRouter> s_RecvProxyRouter;
+RecvProxyRouter* GetRecvProxyRouter()
+{
+    Assert(s_RecvProxyRouter);
+    return s_RecvProxyRouter.get();
+}
+
+bool RecvProxyRouter::Load()
+{
+    s_RecvProxyRouter.reset(new RecvProxyRouter());
+    return true;
+}
+bool RecvProxyRouter::Unload()
+{
+    s_RecvProxyRouter.reset();
+    return true;
+}
+
+// RecvVarProxyFn has no room for user data, so each intercepted prop gets its own trampoline that
+// knows which slot of m_Props it belongs to.
+template<size_t index>
+void RecvProxyRouter::Trampoline(const CRecvProxyData* pData, void* pStruct, void* pOut)
+{
+    auto router = s_RecvProxyRouter.get();
+    router->Dispatch(router->m_Props[index], pData, pStruct, pOut);
+}
+
+template<size_t... indices>
+constexpr auto RecvProxyRouter::MakeTrampolines(std::index_sequence<indices...>)
+{
+    return std::array<RecvVarProxyFn, MAX_PROPS>{&Trampoline<indices>...};
+}
+
+const std::array<RecvVarProxyFn, RecvProxyRouter::MAX_PROPS> RecvProxyRouter::s_Trampolines =
+    MakeTrampolines(std::make_index_sequence<MAX_PROPS>{});
+
+RecvProxyRouter::RecvProxyRouter()
+    : ce_recvproxy_stats(
+          "ce_recvproxy_stats", [](const CCommand& args) { GetRecvProxyRouter()->PrintStats(args); },
+          "Prints every intercepted RecvProp along with how many updates it has received and routed to "
+          "subscribers. Pass \"reset\" to clear the counters.")
+{
+}
+
+RecvProxyRouter::~RecvProxyRouter()
+{
+    // Everything should have unsubscribed by now, but never leave a trampoline pointing at us
+    for (size_t i = 0; i < m_Props.size(); i++)
+    {
+        if (m_Props[i].m_ActiveMask)
+        {
+            Assert(!"RecvProxy subscription outlived the router");
+            Uninstall(i);
+        }
+    }
+}
+
+int RecvProxyRouter::Subscribe(RecvProp* prop, const Callback& callback, const SlotRange& slots)
+{
+    // Callbacks are called in place while dispatching
+    Assert(!m_Dispatching);
+    Assert(prop);
+    if (!prop)
+        return 0;
+
+    size_t index = m_Props.size();
+    for (size_t i = 0; i < m_Props.size(); i++)
+    {
+        if (m_Props[i].m_Prop == prop)
+        {
+            index = i;
+            break;
+        }
+        else if (!m_Props[i].m_Prop && index == m_Props.size())
+        {
+            index = i;
+        }
+    }
+
+    if (index == m_Props.size())
+    {
+        PluginWarning("Unable to intercept RecvProp %s: too many intercepted props\n", prop->GetName());
+        return 0;
+    }
+
+    auto& intercepted = m_Props[index];
+    intercepted.m_Prop = prop;
+
+    if (intercepted.m_ActiveMask == ~uint32_t(0))
+    {
+        PluginWarning("Unable to intercept RecvProp %s: too many subscribers\n", prop->GetName());
+        return 0;
+    }
+
+    const auto bit = std::countr_one(intercepted.m_ActiveMask);
+    const auto mask = uint32_t(1) << bit;
+
+    intercepted.m_Callbacks[bit] = callback;
+
+    if (slots.IsAll())
+    {
+        intercepted.m_AllSlotsMask |= mask;
+    }
+    else
+    {
+        if (!intercepted.m_SlotMasks)
+            intercepted.m_SlotMasks = std::make_unique<std::array<uint32_t, MAX_EDICTS>>();
+
+        const auto first = std::max(slots.m_First, 0);
+        const auto last = std::min(slots.m_Last, MAX_EDICTS - 1);
+        for (int slot = first; slot <= last; slot++)
+            (*intercepted.m_SlotMasks)[slot] |= mask;
+    }
+
+    if (!intercepted.m_ActiveMask)
+        Install(index);
+
+    intercepted.m_ActiveMask |= mask;
+
+    return int(index * MAX_SUBSCRIBERS_PER_PROP + bit) + 1;
+}
+
+bool RecvProxyRouter::Unsubscribe(int subscriptionID)
+{
+    const auto index = size_t(subscriptionID - 1) / MAX_SUBSCRIBERS_PER_PROP;
+    const auto bit = size_t(subscriptionID - 1) % MAX_SUBSCRIBERS_PER_PROP;
+    const auto mask = uint32_t(1) << bit;
+
+    if (subscriptionID < 1 || index >= m_Props.size() || !(m_Props[index].m_ActiveMask & mask))
+    {
+        Assert(!"Attempted to remove an unknown RecvProxy subscription");
+        return false;
+    }
+
+    auto& intercepted = m_Props[index];
+    intercepted.m_ActiveMask &= ~mask;
+    intercepted.m_AllSlotsMask &= ~mask;
+
+    if (intercepted.m_SlotMasks)
+    {
+        for (auto& slotMask : *intercepted.m_SlotMasks)
+            slotMask &= ~mask;
+    }
+
+    // Subscribers are allowed to unsubscribe from inside their own callback, so the callback
+    // itself has to survive until the next Subscribe() reuses the slot.
+    if (!m_Dispatching)
+        intercepted.m_Callbacks[bit] = nullptr;
+
+    if (!intercepted.m_ActiveMask)
+        Uninstall(index);
+
+    return true;
+}
+
+void RecvProxyRouter::Install(size_t index)
+{
+    auto& intercepted = m_Props[index];
+    Assert(intercepted.m_Prop->m_ProxyFn != s_Trampolines[index]);
+
+    intercepted.m_Original = intercepted.m_Prop->m_ProxyFn;
+    intercepted.m_Prop->m_ProxyFn = s_Trampolines[index];
+}
+
+void RecvProxyRouter::Uninstall(size_t index)
+{
+    auto& intercepted = m_Props[index];
+
+    if (intercepted.m_Prop->m_ProxyFn == s_Trampolines[index])
+        intercepted.m_Prop->m_ProxyFn = intercepted.m_Original;
+    else
+        PluginWarning("RecvProp %s was overridden behind our back, not restoring it\n", intercepted.m_Prop->GetName());
+
+    intercepted.m_SlotMasks.reset();
+}
+
+void RecvProxyRouter::Dispatch(InterceptedProp& prop, const CRecvProxyData* pData, void* pStruct, void* pOut)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    prop.m_UpdateCount++;
+
+    uint32_t mask = prop.m_AllSlotsMask;
+    if (prop.m_SlotMasks && pData->m_ObjectID >= 0 && pData->m_ObjectID < MAX_EDICTS)
+        mask |= (*prop.m_SlotMasks)[pData->m_ObjectID];
+
+    if (!mask)
+    {
+        prop.m_Original(pData, pStruct, pOut);
+        return;
+    }
+
+    prop.m_RoutedCount++;
+
+    m_Dispatching++;
+    Next(prop, mask)(pData, pStruct, pOut);
+    m_Dispatching--;
+}
+
+void RecvProxyRouter::Next::operator()(const CRecvProxyData* pData, void* pStruct, void* pOut) const
+{
+    // Skip anyone who unsubscribed earlier in this same update
+    const uint32_t remaining = m_Remaining & m_Prop.m_ActiveMask;
+    if (!remaining)
+    {
+        // Still valid even if the last subscriber just left, Uninstall() leaves it alone
+        m_Prop.m_Original(pData, pStruct, pOut);
+        return;
+    }
+
+    const auto bit = std::countr_zero(remaining);
+    m_Prop.m_Callbacks[bit](pData, pStruct, pOut, Next(m_Prop, remaining & (remaining - 1)));
+}
+
+void RecvProxyRouter::PrintStats(const CCommand& args)
+{
+    if (args.ArgC() > 1 && !stricmp(args.Arg(1), "reset"))
+    {
+        for (auto& prop : m_Props)
+            prop.m_UpdateCount = prop.m_RoutedCount = 0;
+
+        Msg("Reset RecvProxy counters.\n");
+        return;
+    }
+
+    Msg("%-40s %10s %10s %6s %6s\n", "RecvProp", "Updates", "Routed", "Subs", "Ranged");
+
+    int interceptedCount = 0;
+    for (const auto& prop : m_Props)
+    {
+        if (!prop.m_ActiveMask)
+            continue;
+
+        Msg("%-40s %10u %10u %6i %6s\n", prop.m_Prop->GetName(), prop.m_UpdateCount, prop.m_RoutedCount,
+            std::popcount(prop.m_ActiveMask), prop.m_SlotMasks ? "yes" : "no");
+        interceptedCount++;
+    }
+
+    Msg("%i of %zu RecvProps intercepted\n", interceptedCount, m_Props.size());
+}
+
+RecvProxySubscription::RecvProxySubscription(RecvProp* prop, RecvProxyRouter::Callback&& callback,
+                                             const RecvProxyRouter::SlotRange& slots)
+    : m_Prop(prop), m_Slots(slots), m_Callback(std::move(callback)), m_MemoryTag(MemoryTracker::GetCurrentTag())
+{
+}
+
+bool RecvProxySubscription::Enable()
+{
+    if (IsEnabled())
+        return false;
+
+    // Attribute the callback's allocations to the module that subscribed
+    if (m_MemoryTag != MemoryTracker::UNTAGGED)
+    {
+        m_SubscriptionID = GetRecvProxyRouter()->Subscribe(
+            m_Prop,
+            [this](const CRecvProxyData* pData, void* pStruct, void* pOut, const RecvProxyRouter::Next& next)
+            {
+                MemoryScope scope(m_MemoryTag);
+                m_Callback(pData, pStruct, pOut, next);
+            },
+            m_Slots);
+    }
+    else
+    {
+        m_SubscriptionID = GetRecvProxyRouter()->Subscribe(m_Prop, m_Callback, m_Slots);
+    }
+
+    return IsEnabled();
+}
+
+bool RecvProxySubscription::Disable()
+{
+    if (!IsEnabled())
+        return true;
+
+    if (!GetRecvProxyRouter()->Unsubscribe(m_SubscriptionID))
+        return false;
+
+    m_SubscriptionID = 0;
+    return true;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "PluginBase/MemoryTracker.h"
+
+#include <const.h>
+#include <convar.h>
+#include <dt_recv.h>
+#include <shareddefs.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+// Shared interception of RecvProp proxies.
+//
+// A RecvProp only has room for a single proxy function, so modules that each swap in their own
+// have to be torn down in exactly the reverse order or they restore the wrong one. The router
+// installs one trampoline per intercepted prop and chains every subscriber in front of the game's
+// original proxy. Subscribers can be limited to a range of entity slots; the slot masks are plain
+// arrays indexed by CRecvProxyData::m_ObjectID, so routing an update never searches anything.
+class RecvProxyRouter final
+{
+    struct InterceptedProp;
+
+public:
+    // Passes an update on to the rest of the chain, ending with the game's own proxy. Subscribers
+    // that don't call it replace the game's behaviour for that update.
+    class Next final
+    {
+    public:
+        void operator()(const CRecvProxyData* pData, void* pStruct, void* pOut) const;
+
+    private:
+        friend class RecvProxyRouter;
+        constexpr Next(InterceptedProp& prop, uint32_t remaining) : m_Prop(prop), m_Remaining(remaining) {}
+
+        InterceptedProp& m_Prop;
+        uint32_t m_Remaining;
+    };
+
+    using Callback = std::function<void(const CRecvProxyData* pData, void* pStruct, void* pOut, const Next& next)>;
+
+    // Inclusive range of entity slots a subscriber wants to see
+    struct SlotRange
+    {
+        int m_First;
+        int m_Last;
+
+        static constexpr SlotRange All() { return {0, MAX_EDICTS - 1}; }
+        static constexpr SlotRange Players() { return {1, MAX_PLAYERS}; }
+
+        constexpr bool IsAll() const { return m_First <= 0 && m_Last >= MAX_EDICTS - 1; }
+    };
+
+    static constexpr size_t MAX_PROPS = 32;
+    static constexpr size_t MAX_SUBSCRIBERS_PER_PROP = 32;
+
+    RecvProxyRouter();
+    ~RecvProxyRouter();
+
+    static bool Load();
+    static bool Unload();
+
+    int Subscribe(RecvProp* prop, const Callback& callback, const SlotRange& slots = SlotRange::All());
+    bool Unsubscribe(int subscriptionID);
+
+private:
+    struct InterceptedProp
+    {
+        RecvProp* m_Prop = nullptr;
+        RecvVarProxyFn m_Original = nullptr;
+
+        std::array<Callback, MAX_SUBSCRIBERS_PER_PROP> m_Callbacks;
+        uint32_t m_ActiveMask = 0;   // Subscribers currently in the chain
+        uint32_t m_AllSlotsMask = 0; // Subscribers that want every entity
+
+        // Only allocated once a subscriber asks for a slot range
+        std::unique_ptr<std::array<uint32_t, MAX_EDICTS>> m_SlotMasks;
+
+        uint32_t m_UpdateCount = 0;
+        uint32_t m_RoutedCount = 0;
+    };
+
+    template<size_t index> static void Trampoline(const CRecvProxyData* pData, void* pStruct, void* pOut);
+    template<size_t... indices> static constexpr auto MakeTrampolines(std::index_sequence<indices...>);
+    static const std::array<RecvVarProxyFn, MAX_PROPS> s_Trampolines;
+
+    void Dispatch(InterceptedProp& prop, const CRecvProxyData* pData, void* pStruct, void* pOut);
+
+    void Install(size_t index);
+    void Uninstall(size_t index);
+
+    std::array<InterceptedProp, MAX_PROPS> m_Props;
+    int m_Dispatching = 0;
+
+    void PrintStats(const CCommand& args);
+    ConCommand ce_recvproxy_stats;
+};
+
+extern RecvProxyRouter* GetRecvProxyRouter();
+
+// RAII subscription to a single RecvProp, toggled the same way as Hook<>
+class RecvProxySubscription final
+{
+public:
+    RecvProxySubscription(RecvProp* prop, RecvProxyRouter::Callback&& callback,
+                          const RecvProxyRouter::SlotRange& slots = RecvProxyRouter::SlotRange::All());
+    ~RecvProxySubscription() { Disable(); }
+
+    RecvProxySubscription(const RecvProxySubscription& other) = delete;
+    RecvProxySubscription& operator=(const RecvProxySubscription& other) = delete;
+
+    bool SetEnabled(bool enabled) { return enabled ? Enable() : Disable(); }
+    bool Enable();
+    bool Disable();
+    bool IsEnabled() const { return m_SubscriptionID > 0; }
+
+    RecvProp* GetProp() const { return m_Prop; }
+
+private:
+    RecvProp* m_Prop;
+    RecvProxyRouter::SlotRange m_Slots;
+    RecvProxyRouter::Callback m_Callback;
+    MemoryTracker::Tag m_MemoryTag;
+    int m_SubscriptionID = 0;
+};
@@ -0,0 +1,150 @@
+#include "StartupTasks.h"
+#include "PluginBase/Common.h"
+
+#include <tier0/dbg.h>
+#include <tier0/threadtools.h>
+
+#include <algorithm>
+
+#undef max
+#undef min
+
+StartupTasks* StartupTasks::s_Current = nullptr;
+
+StartupTasks::StartupTasks() : m_StartTime(Clock::now())
+{
+    Assert(!s_Current);
+    s_Current = this;
+
+    // Leave a core for the main thread, and don't bother going wide: there are only a handful of stages
+    const int workerCount = std::clamp(int(std::thread::hardware_concurrency()) - 1, 1, 4);
+    for (int i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&StartupTasks::WorkerThread, this);
+}
+
+StartupTasks::~StartupTasks()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_ShuttingDown = true;
+    }
+    m_WorkAvailable.notify_all();
+
+    for (auto& worker : m_Workers)
+        worker.join();
+
+    s_Current = nullptr;
+}
+
+void StartupTasks::WorkerThread()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock lock(m_Mutex);
+            m_WorkAvailable.wait(lock, [&] { return m_ShuttingDown || !m_Queue.empty(); });
+
+            // Drain the queue even when shutting down, or Finish() would wait forever
+            if (m_Queue.empty())
+                return;
+
+            task = std::move(m_Queue.front());
+            m_Queue.pop_front();
+        }
+
+        task();
+    }
+}
+
+std::shared_future<void> StartupTasks::Launch(std::string stage, std::function<void()>&& work,
+                                              std::function<void()>&& onMainThread)
+{
+    Assert(ThreadInMainThread());
+
+    std::packaged_task<void()> task(
+        [this, stage, work = std::move(work)]()
+        {
+            const auto start = Clock::now();
+            work();
+            RecordTiming(stage, start, Clock::now(), false);
+        });
+
+    std::shared_future<void> future = task.get_future().share();
+    m_Launched.push_back({std::move(stage), future, std::move(onMainThread)});
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Queue.push_back(std::move(task));
+    }
+    m_WorkAvailable.notify_one();
+
+    return future;
+}
+
+void StartupTasks::RunOnMainThread(const char* stage, const std::function<void()>& work)
+{
+    Assert(ThreadInMainThread());
+
+    const auto start = Clock::now();
+    work();
+    RecordTiming(stage, start, Clock::now(), true);
+}
+
+void StartupTasks::Join(const std::shared_future<void>& task)
+{
+    const auto start = Clock::now();
+    task.wait();
+    m_MainThreadWaiting += Clock::now() - start;
+
+    task.get();
+}
+
+void StartupTasks::Finish()
+{
+    for (auto& launched : m_Launched)
+    {
+        try
+        {
+            Join(launched.m_Future);
+
+            if (launched.m_OnMainThread)
+                launched.m_OnMainThread();
+        }
+        catch (const std::exception& e)
+        {
+            PluginWarning("Startup stage \"%s\" failed: %s\n", launched.m_Stage.c_str(), e.what());
+        }
+    }
+
+    m_Launched.clear();
+    PrintTimings();
+}
+
+void StartupTasks::RecordTiming(const std::string& stage, Clock::time_point start, Clock::time_point end,
+                                bool mainThread)
+{
+    using Ms = std::chrono::duration<float, std::milli>;
+
+    std::lock_guard lock(m_Mutex);
+    m_Timings.push_back({stage, Ms(start - m_StartTime).count(), Ms(end - start).count(), mainThread});
+}
+
+void StartupTasks::PrintTimings() const
+{
+    using Ms = std::chrono::duration<float, std::milli>;
+
+    auto timings = m_Timings;
+    std::sort(timings.begin(), timings.end(),
+              [](const Timing& a, const Timing& b) { return a.m_StartMs < b.m_StartMs; });
+
+    PluginMsg("Startup timings (%zu workers):\n", m_Workers.size());
+    for (const auto& timing : timings)
+    {
+        Msg("    %-40s %-6s +%7.1f ms %7.1f ms\n", timing.m_Stage.c_str(), timing.m_MainThread ? "main" : "worker",
+            timing.m_StartMs, timing.m_DurationMs);
+    }
+
+    Msg("    Main thread spent %1.1f ms waiting on workers, %1.1f ms total\n", Ms(m_MainThreadWaiting).count(),
+        Ms(Clock::now() - m_StartTime).count());
+}
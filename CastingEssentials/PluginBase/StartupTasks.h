@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Runs the CPU-only parts of plugin load (signature scanning, RecvTable flattening, item schema
+// parsing) on a small worker pool while the main thread gets on with everything that has to talk
+// to the engine.
+//
+// Work given to Launch() may read files and print, but must not otherwise call into the engine or
+// touch ConVars. Anything like that goes in the onMainThread continuation, which runs during
+// Finish(). Each stage is timed, and Finish() prints the timings so load time regressions are easy
+// to spot.
+class StartupTasks final
+{
+public:
+    StartupTasks();
+    ~StartupTasks();
+
+    StartupTasks(const StartupTasks&) = delete;
+    StartupTasks& operator=(const StartupTasks&) = delete;
+
+    // The pool for the load currently in progress, or nullptr outside of plugin load
+    static StartupTasks* GetCurrent() { return s_Current; }
+
+    std::shared_future<void> Launch(std::string stage, std::function<void()>&& work,
+                                    std::function<void()>&& onMainThread = nullptr);
+
+    // Times a stage that has to run on the main thread
+    void RunOnMainThread(const char* stage, const std::function<void()>& work);
+
+    // Blocks until a launched stage finishes, rethrowing anything it threw
+    void Join(const std::shared_future<void>& task);
+
+    // Waits for every launched stage, runs their continuations and prints the timings
+    void Finish();
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    void WorkerThread();
+    void RecordTiming(const std::string& stage, Clock::time_point start, Clock::time_point end, bool mainThread);
+    void PrintTimings() const;
+
+    static StartupTasks* s_Current;
+
+    const Clock::time_point m_StartTime;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::deque<std::packaged_task<void()>> m_Queue;
+    std::vector<std::thread> m_Workers;
+    bool m_ShuttingDown = false;
+
+    struct Launched
+    {
+        std::string m_Stage;
+        std::shared_future<void> m_Future;
+        std::function<void()> m_OnMainThread;
+    };
+    std::vector<Launched> m_Launched;
+
+    struct Timing
+    {
+        std::string m_Stage;
+        float m_StartMs;
+        float m_DurationMs;
+        bool m_MainThread;
+    };
+    std::vector<Timing> m_Timings;
+    Clock::duration m_MainThreadWaiting{};
+};
@@ -1,6 +1,7 @@
 #include "TFPlayerResource.h"
 
 #include "Entities.h"
+#include "HookManager.h"
 #include "Interfaces.h"
 
 #include <client/c_baseentity.h>
@@ -9,6 +10,9 @@
 #include <icliententitylist.h>
 #include <toolframework/ienginetool.h>
 
+#include <algorithm>
+#include <limits>
+
 std::shared_ptr<TFPlayerResource> TFPlayerResource::m_PlayerResource;
 
 std::shared_ptr<TFPlayerResource> TFPlayerResource::GetPlayerResource()
@@ -39,29 +43,99 @@ std::shared_ptr<TFPlayerResource> TFPlayerResource::GetPlayerResource()
     return nullptr;
 }
 
+void TFPlayerResource::Unload() { m_PlayerResource.reset(); }
+
+// Returns the offset of element 0 of a networked array, after making sure the elements we're going to touch are
+// actually laid out contiguously
+template<typename T>
+static ptrdiff_t GetArrayOffset(const ClientClass* cc, const char* propName, int lastIndex)
+{
+    char buf[32];
+    const auto first = Entities::RetrieveClassPropOffset(cc, Entities::PropIndex(buf, propName, 0)).first;
+    const auto last = Entities::RetrieveClassPropOffset(cc, Entities::PropIndex(buf, propName, lastIndex)).first;
+    if (first < 0 || last < 0 || (last - first) != ptrdiff_t(lastIndex * sizeof(T)))
+        throw invalid_class_prop(propName);
+
+    return first;
+}
+
 TFPlayerResource::TFPlayerResource()
 {
     auto cc = Entities::GetClientClass("CTFPlayerResource");
 
-    char buf[32];
-    for (int i = 0; i < MAX_PLAYERS; i++)
+    m_TypeChecker = Entities::GetTypeChecker(cc);
+    m_AliveOffset = GetArrayOffset<bool>(cc, "m_bAlive", MAX_PLAYERS);
+    m_DamageOffset = GetArrayOffset<int>(cc, "m_iDamage", MAX_PLAYERS);
+    m_MaxHealthOffset = GetArrayOffset<int>(cc, "m_iMaxHealth", MAX_PLAYERS);
+    m_StreakOffset = GetArrayOffset<int>(cc, "m_iStreaks", (MAX_PLAYERS + 1) * STREAK_WEAPONS - 1);
+
+    m_PostEntityPacketReceivedHook =
+        GetHooks()->AddHook<HookFunc::IPrediction_PostEntityPacketReceived>([this]() { m_StatsDirty = true; });
+}
+
+TFPlayerResource::~TFPlayerResource()
+{
+    if (m_PostEntityPacketReceivedHook)
     {
-        m_AliveOffsets[i] = Entities::GetEntityProp<bool>(cc, Entities::PropIndex(buf, "m_bAlive", i + 1));
-        m_DamageOffsets[i] = Entities::GetEntityProp<int>(cc, Entities::PropIndex(buf, "m_iDamage", i + 1));
-        m_MaxHealthOffsets[i] = Entities::GetEntityProp<int>(cc, Entities::PropIndex(buf, "m_iMaxHealth", i + 1));
+        GetHooks()->RemoveHook<HookFunc::IPrediction_PostEntityPacketReceived>(m_PostEntityPacketReceivedHook,
+                                                                              __FUNCSIG__);
+    }
+}
+
+template<typename T>
+T* TFPlayerResource::GetArray(ptrdiff_t offset) const
+{
+    auto entity = m_PlayerResourceEntity.Get();
+    if (!entity || !m_TypeChecker.Match(entity->GetClientClass()))
+        return nullptr;
+
+    return reinterpret_cast<T*>(reinterpret_cast<std::byte*>(entity->GetDataTableBasePtr()) + offset);
+}
+
+void TFPlayerResource::RefreshStats()
+{
+    m_StatsDirty = false;
+    m_LastRefreshTick = Interfaces::GetEngineTool()->ClientTick();
 
-        for (int w = 0; w < STREAK_WEAPONS; w++)
-            m_StreakOffsets[i][w] =
-                Entities::GetEntityProp<int>(cc, Entities::PropIndex(buf, "m_iStreaks", (i + 1) * STREAK_WEAPONS + w));
+    const auto alive = GetArray<bool>(m_AliveOffset);
+    if (!alive)
+    {
+        m_Stats = {};
+        return;
+    }
+
+    // Element 0 of every array is the world, players start at 1
+    const auto damage = GetArray<int>(m_DamageOffset);
+    const auto maxHealth = GetArray<int>(m_MaxHealthOffset);
+    const auto streaks = GetArray<int>(m_StreakOffset);
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        auto& stats = m_Stats[i];
+        stats.m_Alive = alive[i + 1];
+        stats.m_Damage = damage[i + 1];
+        stats.m_MaxHealth = maxHealth[i + 1];
+        std::copy_n(&streaks[(i + 1) * STREAK_WEAPONS], STREAK_WEAPONS, stats.m_Killstreaks);
     }
 }
 
-bool TFPlayerResource::IsAlive(int playerEntIndex)
+const TFPlayerResource::PlayerStats* TFPlayerResource::GetStats(int playerEntIndex)
 {
     if (!CheckEntIndex(playerEntIndex, __FUNCTION__))
-        return false;
+        return nullptr;
+
+    if (m_StatsDirty ||
+        (!m_PostEntityPacketReceivedHook && Interfaces::GetEngineTool()->ClientTick() != m_LastRefreshTick))
+    {
+        RefreshStats();
+    }
+
+    return &m_Stats[playerEntIndex - 1];
+}
 
-    return m_AliveOffsets[playerEntIndex - 1].GetValue(m_PlayerResourceEntity.Get());
+bool TFPlayerResource::IsAlive(int playerEntIndex)
+{
+    auto stats = GetStats(playerEntIndex);
+    return stats ? stats->m_Alive : false;
 }
 
 int* TFPlayerResource::GetKillstreak(int playerEntIndex, uint_fast8_t weapon)
@@ -72,23 +146,36 @@ int* TFPlayerResource::GetKillstreak(int playerEntIndex, uint_fast8_t weapon)
     if (weapon >= STREAK_WEAPONS)
         return nullptr;
 
-    return &m_StreakOffsets[playerEntIndex - 1][weapon].GetValue(m_PlayerResourceEntity.Get());
+    auto streaks = GetArray<int>(m_StreakOffset);
+    if (!streaks)
+        return nullptr;
+
+    return &streaks[playerEntIndex * STREAK_WEAPONS + weapon];
 }
 
-int TFPlayerResource::GetDamage(int playerEntIndex)
+void TFPlayerResource::SetKillstreak(int playerEntIndex, uint_fast8_t weapon, int value)
 {
-    if (!CheckEntIndex(playerEntIndex, __FUNCTION__))
-        return std::numeric_limits<int>::min();
+    auto streak = GetKillstreak(playerEntIndex, weapon);
+    if (!streak)
+        return;
+
+    *streak = value;
 
-    return m_DamageOffsets[playerEntIndex - 1].GetValue(m_PlayerResourceEntity.Get());
+    // Keep the cached copy in sync so we don't have to wait for the next packet to see our own write
+    if (!m_StatsDirty)
+        m_Stats[playerEntIndex - 1].m_Killstreaks[weapon] = value;
 }
 
-int TFPlayerResource::GetMaxHealth(int playerEntIndex)
+int TFPlayerResource::GetDamage(int playerEntIndex)
 {
-    if (!CheckEntIndex(playerEntIndex, __FUNCTION__))
-        return std::numeric_limits<int>::min();
+    auto stats = GetStats(playerEntIndex);
+    return stats ? stats->m_Damage : std::numeric_limits<int>::min();
+}
 
-    return m_MaxHealthOffsets[playerEntIndex - 1].GetValue(m_PlayerResourceEntity.Get());
+int TFPlayerResource::GetMaxHealth(int playerEntIndex)
+{
+    auto stats = GetStats(playerEntIndex);
+    return stats ? stats->m_MaxHealth : std::numeric_limits<int>::min();
 }
 
 bool TFPlayerResource::CheckEntIndex(int playerEntIndex, const char* functionName)
@@ -100,4 +187,4 @@ bool TFPlayerResource::CheckEntIndex(int playerEntIndex, const char* functionNam
     }
 
     return true;
-}
\ No newline at end of file
+}
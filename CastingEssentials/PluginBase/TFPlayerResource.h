@@ -18,24 +18,54 @@ class TFPlayerResource final
     TFPlayerResource();
 
 public:
-    ~TFPlayerResource() = default;
+    ~TFPlayerResource();
     static std::shared_ptr<TFPlayerResource> GetPlayerResource();
 
+    // Drops the cached instance, which has to happen while the hook manager is still around
+    static void Unload();
+
+    static constexpr auto STREAK_WEAPONS = 4;
+
+    // Everything we care about from the player resource for a single player. The whole block is
+    // refreshed at most once per network update (the first time it's asked for after a packet),
+    // rather than every caller going through a type checked EntityOffset every tick.
+    struct PlayerStats
+    {
+        int m_Killstreaks[STREAK_WEAPONS];
+        int m_Damage;
+        int m_MaxHealth;
+        bool m_Alive;
+    };
+
+    const PlayerStats* GetStats(int playerEntIndex);
+
     int GetMaxHealth(int playerEntIndex);
     bool IsAlive(int playerEntIndex);
     int* GetKillstreak(int playerEntIndex, uint_fast8_t weapon);
+    void SetKillstreak(int playerEntIndex, uint_fast8_t weapon, int value);
     int GetDamage(int playerEntIndex);
 
-    static constexpr auto STREAK_WEAPONS = 4;
-
 private:
     bool CheckEntIndex(int playerEntIndex, const char* functionName);
 
     CHandle<C_BaseEntity> m_PlayerResourceEntity;
     static std::shared_ptr<TFPlayerResource> m_PlayerResource;
 
-    std::array<EntityOffset<bool>, MAX_PLAYERS> m_AliveOffsets;
-    EntityOffset<int> m_StreakOffsets[MAX_PLAYERS][STREAK_WEAPONS];
-    std::array<EntityOffset<int>, MAX_PLAYERS> m_DamageOffsets;
-    std::array<EntityOffset<int>, MAX_PLAYERS> m_MaxHealthOffsets;
-};
\ No newline at end of file
+    void RefreshStats();
+    bool m_StatsDirty = true;
+    std::array<PlayerStats, MAX_PLAYERS> m_Stats;
+
+    int m_PostEntityPacketReceivedHook = 0;
+    int m_LastRefreshTick = -1; // Without the hook, stats are refreshed once per tick instead
+
+    // All of these are arrays on the player resource, so we only need the offset of the first element. The stride is
+    // the size of the element type.
+    EntityTypeChecker m_TypeChecker;
+    ptrdiff_t m_AliveOffset;
+    ptrdiff_t m_StreakOffset;
+    ptrdiff_t m_DamageOffset;
+    ptrdiff_t m_MaxHealthOffset;
+
+    template<typename T>
+    T* GetArray(ptrdiff_t offset) const;
+};
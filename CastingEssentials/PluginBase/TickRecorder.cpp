@@ -0,0 +1,404 @@
+#include "TickRecorder.h"
+#include "GameEventRouter.h"
+#include "Interfaces.h"
+#include "PlayerHistory.h"
+#include "WorldSnapshot.h"
+#include "Misc/TriggerOccupancy.h"
+#include "Modules/AutoCameras.h"
+#include "Modules/CameraState.h"
+
+#include <cdll_int.h>
+#include <client/c_baseentity.h>
+#include <filesystem.h>
+#include <igameevents.h>
+#include <toolframework/ienginetool.h>
+#include <vprof.h>
+#include <worldsize.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+#undef min
+#undef max
+
+static constexpr int MAX_RECORDING_BYTES = 256 * 1024 * 1024;
+
+static std::unique_ptr<TickRecorder> s_TickRecorder;
+TickRecorder* GetTickRecorder()
+{
+    Assert(s_TickRecorder);
+    return s_TickRecorder.get();
+}
+
+bool TickRecorder::Load()
+{
+    s_TickRecorder.reset(new TickRecorder());
+    return true;
+}
+bool TickRecorder::Unload()
+{
+    s_TickRecorder.reset();
+    return true;
+}
+
+TickRecorder::TickRecorder()
+    : ce_replay_record(
+          "ce_replay_record", [](const CCommand& args) { GetTickRecorder()->StartRecording(args); },
+          "Starts recording what modules read from the game every tick, until ce_replay_stop or the map changes. "
+          "Usage: ce_replay_record <name>"),
+      ce_replay_stop(
+          "ce_replay_stop", [](const CCommand& args) { GetTickRecorder()->StopRecording(); },
+          "Stops the recording started by ce_replay_record and saves it."),
+      ce_replay_benchmark(
+          "ce_replay_benchmark", RunBenchmark,
+          "Replays a recording from ce_replay_record through the world snapshot, player history and autocamera "
+          "trigger code as fast as possible, and reports what each tick cost. Usage: ce_replay_benchmark <name> "
+          "[passes]")
+{
+    m_Tick.m_Players.Reset();
+}
+
+TickRecorder::~TickRecorder()
+{
+    if (IsRecording())
+        StopRecording();
+}
+
+std::string TickRecorder::GetFilename(const char* name)
+{
+    if (!name[0] || strpbrk(name, "/\\:."))
+    {
+        PluginWarning("Invalid recording name \"%s\", only letters, numbers, - and _ are allowed\n", name);
+        return std::string();
+    }
+
+    return strprintf("addons/castingessentials/replays/%s.cetr", name);
+}
+
+void TickRecorder::StartRecording(const CCommand& args)
+{
+    if (args.ArgC() != 2)
+    {
+        Warning("Usage: %s <name>\n", args[0]);
+        return;
+    }
+
+    const auto engineClient = Interfaces::GetEngineClient();
+    if (!engineClient->IsInGame())
+    {
+        PluginWarning("Can't start recording before a map is loaded\n");
+        return;
+    }
+
+    auto filename = GetFilename(args[1]);
+    if (filename.empty())
+        return;
+
+    if (IsRecording())
+        StopRecording();
+
+    m_Filename = std::move(filename);
+    m_LevelName = engineClient->GetLevelName();
+    m_Writer = std::make_unique<TickRecording::Writer>(GetMapName(m_LevelName.c_str()).c_str());
+    m_LastTick = -1;
+    m_PendingEvents.clear();
+
+    GetGameEventRouter()->SetFireObserver(
+        [this](GameEventRouter::EventID id, IGameEvent* event)
+        {
+            m_Writer->AddEventName(id, event->GetName());
+
+            auto& recorded = m_PendingEvents.emplace_back();
+            recorded.m_ID = id;
+            recorded.m_KeyMask = 0;
+            for (size_t key = 0; key < TickRecording::EVENT_KEY_COUNT; key++)
+            {
+                const char* const keyName = TickRecording::EVENT_KEYS[key];
+                if (event->IsEmpty(keyName))
+                {
+                    recorded.m_Values[key] = 0;
+                    continue;
+                }
+
+                recorded.m_KeyMask |= 1 << key;
+                recorded.m_Values[key] = event->GetInt(keyName);
+            }
+        });
+
+    PluginMsg("Recording ticks to %s\n", m_Filename.c_str());
+}
+
+void TickRecorder::StopRecording()
+{
+    if (!IsRecording())
+    {
+        PluginWarning("Not recording\n");
+        return;
+    }
+
+    GetGameEventRouter()->SetFireObserver(nullptr);
+
+    auto& buffer = m_Writer->GetBuffer();
+    const auto fs = Interfaces::GetFileSystem();
+    fs->CreateDirHierarchy("addons/castingessentials/replays", "MOD");
+    if (fs->WriteFile(m_Filename.c_str(), "MOD", buffer))
+    {
+        PluginMsg("Saved %u ticks (%1.1f KiB) to %s\n", m_Writer->GetTickCount(), buffer.TellPut() / 1024.0f,
+                  m_Filename.c_str());
+    }
+    else
+    {
+        PluginWarning("Failed to save tick recording to %s!\n", m_Filename.c_str());
+    }
+
+    m_Writer.reset();
+    m_PendingEvents.clear();
+}
+
+void TickRecorder::Record(const WorldSnapshot& snapshot, bool inGame)
+{
+    if (!m_Writer)
+        return;
+
+    // A recording only ever covers one map
+    if (!inGame || stricmp(Interfaces::GetEngineClient()->GetLevelName(), m_LevelName.c_str()))
+    {
+        PluginMsg("Left %s, stopping tick recording\n", m_LevelName.c_str());
+        StopRecording();
+        return;
+    }
+
+    const auto engineTool = Interfaces::GetEngineTool();
+    const int tick = engineTool->ClientTick();
+    if (tick == m_LastTick)
+        return;
+
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+    m_LastTick = tick;
+
+    auto& recorded = m_Tick;
+    recorded.m_Tick = tick;
+    recorded.m_Time = engineTool->ClientTime();
+    recorded.m_InGame = inGame;
+
+    if (auto cameraState = CameraState::TryGetModule())
+    {
+        cameraState->GetLastFramePluginView(recorded.m_ViewOrigin, recorded.m_ViewAngles, &recorded.m_ViewFOV);
+    }
+    else
+    {
+        recorded.m_ViewOrigin.Init();
+        recorded.m_ViewAngles.Init();
+        recorded.m_ViewFOV = 0;
+    }
+
+    recorded.m_ObserverMode = CameraState::GetLocalObserverMode();
+    const auto observerTarget = CameraState::GetLocalObserverTarget();
+    recorded.m_ObserverTarget = observerTarget ? observerTarget->entindex() : 0;
+
+    recorded.m_Players = snapshot.GetState();
+
+    // Events fired since the last recorded tick belong to this one
+    recorded.m_Events.swap(m_PendingEvents);
+    m_PendingEvents.clear();
+
+    m_Writer->AddTick(recorded);
+
+    if (m_Writer->GetBuffer().TellPut() > MAX_RECORDING_BYTES)
+    {
+        PluginWarning("Tick recording reached %i MiB, stopping\n", MAX_RECORDING_BYTES / (1024 * 1024));
+        StopRecording();
+    }
+}
+
+// FNV-1a, so separate passes over the same recording can be compared
+static uint64_t HashInt(uint64_t hash, int value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        hash ^= (uint32_t(value) >> (i * 8)) & 0xFF;
+        hash *= 0x100000001b3;
+    }
+
+    return hash;
+}
+
+void TickRecorder::RunBenchmark(const CCommand& args)
+{
+    int passes = 1;
+    if (args.ArgC() < 2 || (args.ArgC() > 2 && !TryParseInteger(args[2], passes)))
+    {
+        Warning("Usage: %s <name> [passes]\n", args[0]);
+        return;
+    }
+
+    passes = std::clamp(passes, 1, 100);
+
+    const auto filename = GetFilename(args[1]);
+    if (filename.empty())
+        return;
+
+    CUtlBuffer buffer;
+    if (!Interfaces::GetFileSystem()->ReadFile(filename.c_str(), "MOD", buffer))
+    {
+        PluginWarning("Unable to read %s\n", filename.c_str());
+        return;
+    }
+
+    TickRecording::Reader reader;
+    if (!reader.Open(buffer))
+    {
+        PluginWarning("Unable to replay %s: unrecognized file format\n", filename.c_str());
+        return;
+    }
+
+    // Autocamera triggers are per map, so they only get exercised when replaying on the same one
+    const TriggerOccupancy* liveTriggers = nullptr;
+    const auto engineClient = Interfaces::GetEngineClient();
+    if (engineClient->IsInGame() && GetMapName(engineClient->GetLevelName()) == reader.GetMapName())
+    {
+        if (auto autoCameras = AutoCameras::TryGetModule())
+            liveTriggers = &autoCameras->GetTriggerOccupancy();
+    }
+
+    // Scratch instances, so the replay doesn't disturb the real ones
+    auto tick = std::make_unique<TickRecording::Tick>();
+    auto history = std::make_unique<PlayerHistory>();
+    TriggerOccupancy triggers;
+
+    using clock = std::chrono::high_resolution_clock;
+    double decodeSeconds = 0;
+    double snapshotSeconds = 0;
+    double historySeconds = 0;
+    double triggerSeconds = 0;
+    std::vector<float> tickMicroseconds;
+
+    std::vector<uint32_t> eventCounts;
+    int observerTargetChanges = 0;
+    int tickCount = 0;
+    std::vector<uint64_t> checksums;
+
+    const Vector maxCoord(MAX_COORD_FLOAT, MAX_COORD_FLOAT, MAX_COORD_FLOAT);
+    for (int pass = 0; pass < passes; pass++)
+    {
+        WorldSnapshot::ReplayScope replay;
+        reader.Rewind(*tick);
+        history->Reset(-maxCoord, maxCoord);
+
+        // Start out with nobody inside any of the triggers
+        if (liveTriggers)
+        {
+            triggers = *liveTriggers;
+            triggers.Update(WorldSnapshot::Get());
+        }
+
+        uint64_t checksum = 0xcbf29ce484222325;
+        int lastObserverTarget = 0;
+        int frame = 0;
+        while (true)
+        {
+            const auto decodeStart = clock::now();
+            if (!reader.ReadTick(*tick))
+                break;
+
+            const auto snapshotStart = clock::now();
+            WorldSnapshot::Replay(frame++, tick->m_Players);
+            const auto& world = WorldSnapshot::Get();
+
+            const auto historyStart = clock::now();
+            if (tick->m_InGame)
+            {
+                if (!history->IsEmpty() && tick->m_Tick < history->GetNewestTick())
+                    history->Reset(-maxCoord, maxCoord);
+
+                history->BeginFrame(tick->m_Tick, tick->m_Time);
+                history->AddSamples(world);
+            }
+
+            const auto triggerStart = clock::now();
+            if (liveTriggers)
+                triggers.Update(world);
+
+            const auto end = clock::now();
+
+            decodeSeconds += std::chrono::duration<double>(snapshotStart - decodeStart).count();
+            snapshotSeconds += std::chrono::duration<double>(historyStart - snapshotStart).count();
+            historySeconds += std::chrono::duration<double>(triggerStart - historyStart).count();
+            triggerSeconds += std::chrono::duration<double>(end - triggerStart).count();
+            tickMicroseconds.push_back(std::chrono::duration<float, std::micro>(end - snapshotStart).count());
+
+            for (const auto& delta : world.GetDeltas())
+            {
+                checksum = HashInt(checksum, int(delta.m_Type));
+                checksum = HashInt(checksum, delta.m_PlayerIndex);
+                checksum = HashInt(checksum, delta.m_OldValue);
+                checksum = HashInt(checksum, delta.m_NewValue);
+            }
+            for (const auto& event : triggers.GetEvents())
+            {
+                checksum = HashInt(checksum, int(event.m_Type));
+                checksum = HashInt(checksum, event.m_Trigger);
+                checksum = HashInt(checksum, event.m_PlayerIndex);
+            }
+
+            if (pass == 0)
+            {
+                for (const auto& event : tick->m_Events)
+                {
+                    if (event.m_ID >= eventCounts.size())
+                        eventCounts.resize(event.m_ID + 1);
+
+                    eventCounts[event.m_ID]++;
+                }
+
+                if (tick->m_ObserverTarget != lastObserverTarget)
+                {
+                    observerTargetChanges++;
+                    lastObserverTarget = tick->m_ObserverTarget;
+                }
+            }
+        }
+
+        if (reader.IsCorrupt())
+            PluginWarning("%s is corrupt after tick %i, replayed as far as possible\n", filename.c_str(), frame);
+
+        tickCount = frame;
+        checksums.push_back(checksum);
+    }
+
+    if (tickMicroseconds.empty())
+    {
+        PluginWarning("%s doesn't contain any ticks\n", filename.c_str());
+        return;
+    }
+
+    std::sort(tickMicroseconds.begin(), tickMicroseconds.end());
+    const auto percentile = [&](float p) { return tickMicroseconds[size_t(p * (tickMicroseconds.size() - 1))]; };
+    const auto totalTicks = double(tickMicroseconds.size());
+
+    Msg("Replayed %i ticks of %s, %i pass(es):\n", tickCount, reader.GetMapName().c_str(), passes);
+    Msg("    decode: %1.2f us per tick\n", decodeSeconds * 1e6 / totalTicks);
+    Msg("    snapshot: %1.2f us, player history: %1.2f us, triggers: %1.2f us per tick%s\n",
+        snapshotSeconds * 1e6 / totalTicks, historySeconds * 1e6 / totalTicks, triggerSeconds * 1e6 / totalTicks,
+        liveTriggers ? "" : " (no autocamera triggers loaded for this map)");
+    Msg("    per tick: median %1.2f us, 99th percentile %1.2f us, worst %1.2f us\n", percentile(0.5f),
+        percentile(0.99f), tickMicroseconds.back());
+
+    const auto totalEvents = std::accumulate(eventCounts.begin(), eventCounts.end(), 0u);
+    Msg("    %u game events, %i observer target changes\n", totalEvents, observerTargetChanges);
+
+    std::vector<size_t> eventOrder(eventCounts.size());
+    std::iota(eventOrder.begin(), eventOrder.end(), 0);
+    std::sort(eventOrder.begin(), eventOrder.end(),
+              [&](size_t a, size_t b) { return eventCounts[a] > eventCounts[b]; });
+    for (size_t i = 0; i < std::min<size_t>(eventOrder.size(), 5) && eventCounts[eventOrder[i]]; i++)
+        Msg("        %6u %s\n", eventCounts[eventOrder[i]], reader.GetEventNames()[eventOrder[i]].c_str());
+
+    if (std::adjacent_find(checksums.begin(), checksums.end(), std::not_equal_to<>()) != checksums.end())
+        PluginWarning("Replay passes disagreed with each other!\n");
+    else
+        Msg("    checksum %016llx\n", (unsigned long long)checksums.front());
+}
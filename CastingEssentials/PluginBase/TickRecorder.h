@@ -0,0 +1,53 @@
+#pragma once
+#include "PluginBase/TickRecording.h"
+
+#include <convar.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class WorldSnapshot;
+
+// Captures the inputs modules read from the game into a TickRecording, once per client tick,
+// and replays recordings through the snapshot-driven code at full speed.
+//
+// Most of a module's OnTick() reads live entities and talks to the engine, so the replay only
+// drives the layer underneath: WorldSnapshot and its deltas, player history and autocamera
+// trigger occupancy. That is still enough to profile those paths repeatably against real match
+// data, and to check that two runs over the same recording agree.
+class TickRecorder final
+{
+public:
+    TickRecorder();
+    ~TickRecorder();
+
+    static bool Load();
+    static bool Unload();
+
+    // Adds the current tick to the recording, if one is running and the tick hasn't been added yet
+    void Record(const WorldSnapshot& snapshot, bool inGame);
+
+    bool IsRecording() const { return !!m_Writer; }
+
+private:
+    void StartRecording(const CCommand& args);
+    void StopRecording();
+
+    static std::string GetFilename(const char* name);
+    static void RunBenchmark(const CCommand& args);
+
+    std::unique_ptr<TickRecording::Writer> m_Writer;
+    std::string m_Filename;
+    std::string m_LevelName;
+    int m_LastTick = -1;
+
+    std::vector<TickRecording::Event> m_PendingEvents;
+    TickRecording::Tick m_Tick;
+
+    ConCommand ce_replay_record;
+    ConCommand ce_replay_stop;
+    ConCommand ce_replay_benchmark;
+};
+
+extern TickRecorder* GetTickRecorder();
@@ -0,0 +1,354 @@
+#include "TickRecording.h"
+#include "TFDefinitions.h"
+
+#include <const.h>
+
+using namespace TickRecording;
+
+static constexpr uint32_t TICKRECORDING_FILE_MAGIC = 0x52544543; // "CETR"
+static constexpr uint32_t TICKRECORDING_FILE_VERSION = 2;
+
+static_assert(MAX_EDICTS <= 0x10000, "Observer targets are stored as uint16");
+
+static constexpr size_t MAX_NAME_LENGTH = 256; // Event and map names
+
+enum class Chunk : uint8_t
+{
+    EventName = 1,
+    Tick = 2,
+};
+
+// Which fields of a player changed since the last tick. Written in this order.
+enum PlayerField : uint16_t
+{
+    FIELD_VALID = 1 << 0,
+    FIELD_ALIVE = 1 << 1,
+    FIELD_TEAM = 1 << 2,
+    FIELD_CLASS = 1 << 3,
+    FIELD_HEALTH = 1 << 4,
+    FIELD_MAX_HEALTH = 1 << 5,
+    FIELD_CONDITIONS = 1 << 6,
+    FIELD_UBER_CHARGE = 1 << 7,
+    FIELD_ORIGIN = 1 << 8,
+    FIELD_EYE_POSITION = 1 << 9,
+    FIELD_BOUNDS = 1 << 10,
+    FIELD_EYE_ANGLES = 1 << 11,
+    FIELD_OBSERVER_MODE = 1 << 12,
+    FIELD_OBSERVER_TARGET = 1 << 13,
+    FIELD_ACTIVE_WEAPON = 1 << 14,
+};
+
+static void PutVector(CUtlBuffer& buffer, const Vector& vec)
+{
+    for (int i = 0; i < 3; i++)
+        buffer.PutFloat(vec[i]);
+}
+static void GetVector(CUtlBuffer& buffer, Vector& vec)
+{
+    for (int i = 0; i < 3; i++)
+        vec[i] = buffer.GetFloat();
+}
+
+static void PutAngle(CUtlBuffer& buffer, const QAngle& ang)
+{
+    for (int i = 0; i < 3; i++)
+        buffer.PutFloat(ang[i]);
+}
+static void GetAngle(CUtlBuffer& buffer, QAngle& ang)
+{
+    for (int i = 0; i < 3; i++)
+        ang[i] = buffer.GetFloat();
+}
+
+static uint16_t GetChangedFields(const WorldSnapshot::State& prev, const WorldSnapshot::State& cur, int i)
+{
+    uint16_t fields = 0;
+    if (prev.m_Valid[i] != cur.m_Valid[i])
+        fields |= FIELD_VALID;
+    if (prev.m_Alive[i] != cur.m_Alive[i])
+        fields |= FIELD_ALIVE;
+    if (prev.m_Team[i] != cur.m_Team[i])
+        fields |= FIELD_TEAM;
+    if (prev.m_Class[i] != cur.m_Class[i])
+        fields |= FIELD_CLASS;
+    if (prev.m_Health[i] != cur.m_Health[i])
+        fields |= FIELD_HEALTH;
+    if (prev.m_MaxHealth[i] != cur.m_MaxHealth[i])
+        fields |= FIELD_MAX_HEALTH;
+    if (prev.m_Conditions[i] != cur.m_Conditions[i])
+        fields |= FIELD_CONDITIONS;
+    if (prev.m_UberCharge[i] != cur.m_UberCharge[i])
+        fields |= FIELD_UBER_CHARGE;
+    if (prev.m_Origin[i] != cur.m_Origin[i])
+        fields |= FIELD_ORIGIN;
+    if (prev.m_EyePosition[i] != cur.m_EyePosition[i])
+        fields |= FIELD_EYE_POSITION;
+    if (prev.m_WorldMins[i] != cur.m_WorldMins[i] || prev.m_WorldMaxs[i] != cur.m_WorldMaxs[i])
+        fields |= FIELD_BOUNDS;
+    if (prev.m_EyeAngles[i] != cur.m_EyeAngles[i])
+        fields |= FIELD_EYE_ANGLES;
+    if (prev.m_ObserverMode[i] != cur.m_ObserverMode[i])
+        fields |= FIELD_OBSERVER_MODE;
+    if (prev.m_ObserverTarget[i] != cur.m_ObserverTarget[i])
+        fields |= FIELD_OBSERVER_TARGET;
+    if (prev.m_ActiveWeapon[i] != cur.m_ActiveWeapon[i])
+        fields |= FIELD_ACTIVE_WEAPON;
+
+    return fields;
+}
+
+// File layout, little endian:
+//     uint32 magic, uint32 version, null terminated map name
+//     then chunks until the end of the file, each starting with a uint8 Chunk:
+//         EventName: uint16 id, null terminated name
+//         Tick: int32 tick, float time, uint8 in game, float view origin[3], float view angles[3],
+//               float fov, uint8 observer mode, uint16 observer target
+//               uint8 changed player count
+//                   per player: uint8 slot, uint16 PlayerFields, then each changed field
+//               uint16 event count
+//                   per event: uint16 id, uint8 key mask, int32 per key in the mask
+Writer::Writer(const char* mapName)
+{
+    m_Previous.Reset();
+
+    m_Buffer.PutUnsignedInt(TICKRECORDING_FILE_MAGIC);
+    m_Buffer.PutUnsignedInt(TICKRECORDING_FILE_VERSION);
+    m_Buffer.PutString(mapName);
+}
+
+void Writer::AddEventName(uint16_t id, const char* name)
+{
+    if (id < m_WrittenEventNames.size() && m_WrittenEventNames[id])
+        return;
+
+    if (id >= m_WrittenEventNames.size())
+        m_WrittenEventNames.resize(id + 1);
+
+    m_WrittenEventNames[id] = true;
+
+    m_Buffer.PutUnsignedChar(uint8_t(Chunk::EventName));
+    m_Buffer.PutUnsignedShort(id);
+    m_Buffer.PutString(name);
+}
+
+void Writer::AddTick(const Tick& tick)
+{
+    m_Buffer.PutUnsignedChar(uint8_t(Chunk::Tick));
+    m_Buffer.PutInt(tick.m_Tick);
+    m_Buffer.PutFloat(tick.m_Time);
+    m_Buffer.PutUnsignedChar(tick.m_InGame);
+
+    PutVector(m_Buffer, tick.m_ViewOrigin);
+    PutAngle(m_Buffer, tick.m_ViewAngles);
+    m_Buffer.PutFloat(tick.m_ViewFOV);
+    m_Buffer.PutUnsignedChar(uint8_t(tick.m_ObserverMode));
+    m_Buffer.PutUnsignedShort(uint16_t(tick.m_ObserverTarget));
+
+    const auto& prev = m_Previous;
+    const auto& cur = tick.m_Players;
+
+    uint16_t changedFields[MAX_PLAYERS];
+    uint8_t changedCount = 0;
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        changedFields[i] = GetChangedFields(prev, cur, i);
+        if (changedFields[i])
+            changedCount++;
+    }
+
+    m_Buffer.PutUnsignedChar(changedCount);
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        const auto fields = changedFields[i];
+        if (!fields)
+            continue;
+
+        m_Buffer.PutUnsignedChar(uint8_t(i));
+        m_Buffer.PutUnsignedShort(fields);
+
+        if (fields & FIELD_VALID)
+            m_Buffer.PutUnsignedChar(cur.m_Valid[i]);
+        if (fields & FIELD_ALIVE)
+            m_Buffer.PutUnsignedChar(cur.m_Alive[i]);
+        if (fields & FIELD_TEAM)
+            m_Buffer.PutUnsignedChar(uint8_t(cur.m_Team[i]));
+        if (fields & FIELD_CLASS)
+            m_Buffer.PutUnsignedChar(uint8_t(cur.m_Class[i]));
+        if (fields & FIELD_HEALTH)
+            m_Buffer.PutInt(cur.m_Health[i]);
+        if (fields & FIELD_MAX_HEALTH)
+            m_Buffer.PutInt(cur.m_MaxHealth[i]);
+        if (fields & FIELD_CONDITIONS)
+        {
+            for (auto bits : cur.m_Conditions[i])
+                m_Buffer.PutUnsignedInt(bits);
+        }
+        if (fields & FIELD_UBER_CHARGE)
+            m_Buffer.PutFloat(cur.m_UberCharge[i]);
+        if (fields & FIELD_ORIGIN)
+            PutVector(m_Buffer, cur.m_Origin[i]);
+        if (fields & FIELD_EYE_POSITION)
+            PutVector(m_Buffer, cur.m_EyePosition[i]);
+        if (fields & FIELD_BOUNDS)
+        {
+            PutVector(m_Buffer, cur.m_WorldMins[i]);
+            PutVector(m_Buffer, cur.m_WorldMaxs[i]);
+        }
+        if (fields & FIELD_EYE_ANGLES)
+            PutAngle(m_Buffer, cur.m_EyeAngles[i]);
+        if (fields & FIELD_OBSERVER_MODE)
+            m_Buffer.PutUnsignedChar(uint8_t(cur.m_ObserverMode[i]));
+        if (fields & FIELD_OBSERVER_TARGET)
+            m_Buffer.PutUnsignedShort(uint16_t(cur.m_ObserverTarget[i]));
+        if (fields & FIELD_ACTIVE_WEAPON)
+            m_Buffer.PutUnsignedInt(cur.m_ActiveWeapon[i].ToInt());
+    }
+
+    m_Buffer.PutUnsignedShort(uint16_t(tick.m_Events.size()));
+    for (const auto& event : tick.m_Events)
+    {
+        m_Buffer.PutUnsignedShort(event.m_ID);
+        m_Buffer.PutUnsignedChar(event.m_KeyMask);
+        for (size_t key = 0; key < EVENT_KEY_COUNT; key++)
+        {
+            if (event.m_KeyMask & (1 << key))
+                m_Buffer.PutInt(event.m_Values[key]);
+        }
+    }
+
+    m_Previous = cur;
+    m_TickCount++;
+}
+
+bool Reader::Open(CUtlBuffer& buffer)
+{
+    m_Buffer = &buffer;
+    m_Corrupt = false;
+    m_EventNames.clear();
+
+    if (buffer.GetUnsignedInt() != TICKRECORDING_FILE_MAGIC ||
+        buffer.GetUnsignedInt() != TICKRECORDING_FILE_VERSION)
+    {
+        return false;
+    }
+
+    char mapName[MAX_NAME_LENGTH];
+    buffer.GetString(mapName, sizeof(mapName));
+    m_MapName = mapName;
+
+    m_FirstChunk = buffer.TellGet();
+    return buffer.IsValid();
+}
+
+void Reader::Rewind(Tick& tick)
+{
+    m_Buffer->SeekGet(CUtlBuffer::SEEK_HEAD, m_FirstChunk);
+    m_Corrupt = false;
+    tick.m_Players.Reset();
+}
+
+bool Reader::ReadTick(Tick& tick)
+{
+    auto& buffer = *m_Buffer;
+    while (!m_Corrupt && buffer.GetBytesRemaining() > 0)
+    {
+        const auto chunk = Chunk(buffer.GetUnsignedChar());
+        if (chunk == Chunk::EventName)
+        {
+            const uint16_t id = buffer.GetUnsignedShort();
+            char name[MAX_NAME_LENGTH];
+            buffer.GetString(name, sizeof(name));
+
+            if (id >= m_EventNames.size())
+                m_EventNames.resize(id + 1);
+
+            m_EventNames[id] = name;
+            continue;
+        }
+        else if (chunk != Chunk::Tick)
+        {
+            m_Corrupt = true;
+            break;
+        }
+
+        tick.m_Tick = buffer.GetInt();
+        tick.m_Time = buffer.GetFloat();
+        tick.m_InGame = buffer.GetUnsignedChar();
+
+        GetVector(buffer, tick.m_ViewOrigin);
+        GetAngle(buffer, tick.m_ViewAngles);
+        tick.m_ViewFOV = buffer.GetFloat();
+        tick.m_ObserverMode = ObserverMode(buffer.GetUnsignedChar());
+        tick.m_ObserverTarget = buffer.GetUnsignedShort();
+
+        auto& cur = tick.m_Players;
+        const uint8_t changedCount = buffer.GetUnsignedChar();
+        for (uint8_t p = 0; p < changedCount; p++)
+        {
+            const int i = buffer.GetUnsignedChar();
+            const uint16_t fields = buffer.GetUnsignedShort();
+            if (i >= MAX_PLAYERS)
+            {
+                m_Corrupt = true;
+                return false;
+            }
+
+            if (fields & FIELD_VALID)
+                cur.m_Valid[i] = buffer.GetUnsignedChar() != 0;
+            if (fields & FIELD_ALIVE)
+                cur.m_Alive[i] = buffer.GetUnsignedChar() != 0;
+            if (fields & FIELD_TEAM)
+                cur.m_Team[i] = TFTeam(buffer.GetUnsignedChar());
+            if (fields & FIELD_CLASS)
+                cur.m_Class[i] = TFClassType(buffer.GetUnsignedChar());
+            if (fields & FIELD_HEALTH)
+                cur.m_Health[i] = buffer.GetInt();
+            if (fields & FIELD_MAX_HEALTH)
+                cur.m_MaxHealth[i] = buffer.GetInt();
+            if (fields & FIELD_CONDITIONS)
+            {
+                for (auto& bits : cur.m_Conditions[i])
+                    bits = buffer.GetUnsignedInt();
+            }
+            if (fields & FIELD_UBER_CHARGE)
+                cur.m_UberCharge[i] = buffer.GetFloat();
+            if (fields & FIELD_ORIGIN)
+                GetVector(buffer, cur.m_Origin[i]);
+            if (fields & FIELD_EYE_POSITION)
+                GetVector(buffer, cur.m_EyePosition[i]);
+            if (fields & FIELD_BOUNDS)
+            {
+                GetVector(buffer, cur.m_WorldMins[i]);
+                GetVector(buffer, cur.m_WorldMaxs[i]);
+            }
+            if (fields & FIELD_EYE_ANGLES)
+                GetAngle(buffer, cur.m_EyeAngles[i]);
+            if (fields & FIELD_OBSERVER_MODE)
+                cur.m_ObserverMode[i] = ObserverMode(buffer.GetUnsignedChar());
+            if (fields & FIELD_OBSERVER_TARGET)
+                cur.m_ObserverTarget[i] = buffer.GetUnsignedShort();
+            if (fields & FIELD_ACTIVE_WEAPON)
+                cur.m_ActiveWeapon[i] = CBaseHandle(buffer.GetUnsignedInt());
+        }
+
+        const uint16_t eventCount = buffer.GetUnsignedShort();
+        tick.m_Events.resize(eventCount);
+        for (auto& event : tick.m_Events)
+        {
+            event.m_ID = buffer.GetUnsignedShort();
+            event.m_KeyMask = buffer.GetUnsignedChar();
+            for (size_t key = 0; key < EVENT_KEY_COUNT; key++)
+                event.m_Values[key] = (event.m_KeyMask & (1 << key)) ? buffer.GetInt() : 0;
+
+            if (event.m_ID >= m_EventNames.size())
+                m_Corrupt = true;
+        }
+
+        if (!buffer.IsValid())
+            m_Corrupt = true;
+
+        return !m_Corrupt;
+    }
+
+    return false;
+}
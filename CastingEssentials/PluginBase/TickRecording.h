@@ -0,0 +1,95 @@
+#pragma once
+#include "PluginBase/WorldSnapshot.h"
+
+#include <mathlib/vector.h>
+#include <shareddefs.h>
+#include <tier1/utlbuffer.h>
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Compact binary recording of the per-tick inputs that modules read from the game: the player
+// state that goes into WorldSnapshot, game events, the view and the local observer state.
+//
+// Each tick is stored against the one before it, and only the fields of each player that
+// changed are written, so a quiet tick on a full server costs a few dozen bytes. Event names are
+// written once, before the first tick that fires them. Nothing in here talks to the engine, so
+// recordings can be read back and replayed without a game running.
+namespace TickRecording
+{
+// The event keys modules actually read. Anything else an event carries isn't recorded.
+static constexpr const char* EVENT_KEYS[] = {
+    "userid", "attacker", "assister", "target", "amount", "death_flags", "winning_team",
+};
+static constexpr size_t EVENT_KEY_COUNT = std::size(EVENT_KEYS);
+
+struct Event
+{
+    uint16_t m_ID;     // Index into Reader::GetEventNames()
+    uint8_t m_KeyMask; // Bit n is set if the event had EVENT_KEYS[n]
+    std::array<int, EVENT_KEY_COUNT> m_Values;
+};
+
+struct Tick
+{
+    int m_Tick;
+    float m_Time;
+    bool m_InGame;
+
+    Vector m_ViewOrigin;
+    QAngle m_ViewAngles;
+    float m_ViewFOV;
+    ObserverMode m_ObserverMode;
+    int m_ObserverTarget; // entindex, 0 if none
+
+    WorldSnapshot::State m_Players;
+    std::vector<Event> m_Events;
+};
+
+class Writer final
+{
+public:
+    explicit Writer(const char* mapName);
+
+    // Does nothing if the name has already been written
+    void AddEventName(uint16_t id, const char* name);
+    void AddTick(const Tick& tick);
+
+    CUtlBuffer& GetBuffer() { return m_Buffer; }
+    uint32_t GetTickCount() const { return m_TickCount; }
+
+private:
+    CUtlBuffer m_Buffer;
+    WorldSnapshot::State m_Previous;
+    std::vector<bool> m_WrittenEventNames;
+    uint32_t m_TickCount = 0;
+};
+
+class Reader final
+{
+public:
+    // The buffer has to outlive the reader. Returns false if it isn't a recording, or is from
+    // an incompatible version.
+    bool Open(CUtlBuffer& buffer);
+
+    // Ticks are stored as changes, so every tick of a pass has to be read into the same Tick.
+    // Returns false at the end of the recording, or if the rest of it is unreadable.
+    bool ReadTick(Tick& tick);
+    void Rewind(Tick& tick);
+
+    bool IsCorrupt() const { return m_Corrupt; }
+    const std::string& GetMapName() const { return m_MapName; }
+    const std::vector<std::string>& GetEventNames() const { return m_EventNames; }
+
+private:
+    CUtlBuffer* m_Buffer = nullptr;
+    int m_FirstChunk = 0;
+    bool m_Corrupt = false;
+
+    std::string m_MapName;
+    std::vector<std::string> m_EventNames;
+};
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Color.h>
+#include <convar.h>
+#include <mathlib/vector.h>
+
+#include <type_traits>
+
+// Converts a ConVar's string value into T. Specialize this to support new types.
+template<typename T>
+struct ConVarParser;
+
+template<>
+struct ConVarParser<Color>
+{
+    static bool Parse(const char* str, Color& out) { return ColorFromString(str, out); }
+};
+
+template<>
+struct ConVarParser<Vector>
+{
+    static bool Parse(const char* str, Vector& out) { return ParseVector(out, str); }
+};
+
+template<typename T>
+    requires std::is_enum_v<T>
+struct ConVarParser<T>
+{
+    static bool Parse(const char* str, T& out)
+    {
+        int value;
+        if (!TryParseInteger(str, value))
+            return false;
+
+        out = T(value);
+        return true;
+    }
+};
+
+// A ConVar that parses its value once, whenever it changes, rather than every time it's read.
+//
+// Per-frame code reads the cached value directly. An empty string leaves the ConVar without a
+// value, which is how optional settings like override colors are switched off. Anything else that
+// fails to parse is reported once and the previous value is kept.
+template<typename T>
+class TypedConVar final : public ConVar
+{
+public:
+    TypedConVar(const char* name, const char* defaultValue, int flags = FCVAR_NONE, const char* helpString = "",
+                FnChangeCallback_t callback = nullptr)
+        : ConVar(name, defaultValue, flags, helpString, &ValueChanged), m_Callback(callback)
+    {
+        Parse();
+    }
+    TypedConVar(const char* name, const char* defaultValue, int flags, const char* helpString, bool hasMin,
+                float min, bool hasMax, float max, FnChangeCallback_t callback = nullptr)
+        : ConVar(name, defaultValue, flags, helpString, hasMin, min, hasMax, max, &ValueChanged), m_Callback(callback)
+    {
+        Parse();
+    }
+
+    bool HasValue() const { return m_HasValue; }
+    const T& GetValue() const { return m_Value; }
+    const T& GetValue(const T& fallback) const { return m_HasValue ? m_Value : fallback; }
+
+private:
+    static void ValueChanged(IConVar* var, const char* oldValue, float oldFloatValue)
+    {
+        auto self = static_cast<TypedConVar*>(static_cast<ConVar*>(var));
+        self->Parse();
+
+        if (self->m_Callback)
+            self->m_Callback(var, oldValue, oldFloatValue);
+    }
+
+    void Parse()
+    {
+        const char* str = GetString();
+        if (IsStringEmpty(str))
+        {
+            m_HasValue = false;
+            return;
+        }
+
+        T parsed;
+        if (ConVarParser<T>::Parse(str, parsed))
+        {
+            m_Value = parsed;
+            m_HasValue = true;
+        }
+        else
+        {
+            PluginWarning("Unable to parse \"%s\" for %s, keeping the previous value\n", str, GetName());
+        }
+    }
+
+    FnChangeCallback_t m_Callback;
+    T m_Value{};
+    bool m_HasValue = false;
+};
@@ -0,0 +1,344 @@
+#include "WorldSnapshot.h"
+
+#include "Entities.h"
+#include "Interfaces.h"
+#include "Player.h"
+#include "TFDefinitions.h"
+#include "TFPlayerResource.h"
+
+#include <client/c_basecombatweapon.h>
+#include <client/c_baseentity.h>
+#include <client_class.h>
+#include <toolframework/ienginetool.h>
+#include <vprof.h>
+
+#include <algorithm>
+
+#undef max
+
+// Raw offsets into CTFPlayer, valid once the entity has passed m_TypeChecker. Resolved on the
+// first build rather than at load, since the client classes aren't available that early.
+static struct
+{
+    bool m_Init = false;
+    bool m_Unavailable = false; // A prop couldn't be found, so nothing gets built
+    EntityTypeChecker m_TypeChecker;
+    ptrdiff_t m_Team;
+    ptrdiff_t m_Class;
+    ptrdiff_t m_Health;
+    ptrdiff_t m_ObserverMode;
+    ptrdiff_t m_ObserverTarget;
+    ptrdiff_t m_ActiveWeapon;
+    std::array<ptrdiff_t, 5> m_CondBits;
+
+    EntityOffset<float> m_ChargeLevel;
+} s_PlayerOffsets;
+
+static ptrdiff_t GetPropOffset(const ClientClass* cc, const char* propName)
+{
+    const auto found = Entities::RetrieveClassPropOffset(cc, propName);
+    if (found.first < 0)
+        throw invalid_class_prop(propName);
+
+    return found.first;
+}
+
+static void InitPlayerOffsets()
+{
+    const auto cc = Entities::GetClientClass("CTFPlayer");
+    if (!cc)
+        throw invalid_class_prop("CTFPlayer");
+
+    s_PlayerOffsets.m_TypeChecker = Entities::GetTypeChecker(cc);
+    s_PlayerOffsets.m_Team = GetPropOffset(cc, "m_iTeamNum");
+    s_PlayerOffsets.m_Class = GetPropOffset(cc, "m_iClass");
+    s_PlayerOffsets.m_Health = GetPropOffset(cc, "m_iHealth");
+    s_PlayerOffsets.m_ObserverMode = GetPropOffset(cc, "m_iObserverMode");
+    s_PlayerOffsets.m_ObserverTarget = GetPropOffset(cc, "m_hObserverTarget");
+    s_PlayerOffsets.m_ActiveWeapon = GetPropOffset(cc, "m_hActiveWeapon");
+    s_PlayerOffsets.m_CondBits[0] = GetPropOffset(cc, "_condition_bits");
+    s_PlayerOffsets.m_CondBits[1] = GetPropOffset(cc, "m_nPlayerCond");
+    s_PlayerOffsets.m_CondBits[2] = GetPropOffset(cc, "m_nPlayerCondEx");
+    s_PlayerOffsets.m_CondBits[3] = GetPropOffset(cc, "m_nPlayerCondEx2");
+    s_PlayerOffsets.m_CondBits[4] = GetPropOffset(cc, "m_nPlayerCondEx3");
+
+    s_PlayerOffsets.m_ChargeLevel = Entities::GetEntityProp<float>("CWeaponMedigun", "m_flChargeLevel");
+
+    s_PlayerOffsets.m_Init = true;
+}
+
+// Resolves the offsets on first use. If that fails the snapshot stays empty, rather than throwing
+// out of every Get() for the rest of the session.
+static bool TryInitPlayerOffsets()
+{
+    if (s_PlayerOffsets.m_Init)
+        return true;
+    if (s_PlayerOffsets.m_Unavailable)
+        return false;
+
+    try
+    {
+        InitPlayerOffsets();
+        return true;
+    }
+    catch (const invalid_class_prop& e)
+    {
+        PluginWarning("World snapshot unavailable, unable to find player prop \"%s\"\n", e.what());
+        s_PlayerOffsets.m_Unavailable = true;
+        return false;
+    }
+}
+
+template<typename T>
+static __forceinline const T& ReadProp(const std::byte* base, ptrdiff_t offset)
+{
+    return *reinterpret_cast<const T*>(base + offset);
+}
+
+WorldSnapshot::WorldSnapshot()
+{
+    m_Current.Reset();
+    m_Previous.Reset();
+    m_ChangeMasks.fill(0);
+}
+
+bool WorldSnapshot::s_Replaying = false;
+
+WorldSnapshot& WorldSnapshot::GetInstance()
+{
+    static WorldSnapshot s_Snapshot;
+    return s_Snapshot;
+}
+
+const WorldSnapshot& WorldSnapshot::Get()
+{
+    auto& snapshot = GetInstance();
+    if (s_Replaying)
+        return snapshot;
+
+    const auto frame = Interfaces::GetEngineTool()->HostFrameCount();
+    if (snapshot.m_Frame != frame)
+        snapshot.Build(frame);
+
+    return snapshot;
+}
+
+WorldSnapshot::ReplayScope::ReplayScope()
+{
+    Assert(!s_Replaying);
+
+    // Replays start from an empty world, so every recorded player shows up as added
+    auto& snapshot = GetInstance();
+    m_Live.reset(new WorldSnapshot(snapshot));
+    snapshot = WorldSnapshot();
+    s_Replaying = true;
+}
+
+WorldSnapshot::ReplayScope::~ReplayScope()
+{
+    GetInstance() = std::move(*m_Live);
+    s_Replaying = false;
+}
+
+void WorldSnapshot::Replay(int frame, const State& state)
+{
+    Assert(s_Replaying);
+    auto& snapshot = GetInstance();
+
+    snapshot.m_Previous = std::move(snapshot.m_Current);
+    snapshot.m_Current = state;
+    snapshot.m_PlayerCount = int(state.m_Valid.count());
+    snapshot.m_Frame = frame;
+
+    snapshot.BuildDeltas();
+}
+
+bool WorldSnapshot::IsAvailable() { return !s_PlayerOffsets.m_Unavailable; }
+
+bool WorldSnapshot::CheckCondition(int entindex, TFCond condition) const
+{
+    if (!IsValid(entindex) || condition < 0 || condition >= 128)
+        return false;
+
+    return m_Current.m_Conditions[entindex - 1][condition / 32] & (1 << (condition % 32));
+}
+
+C_BaseCombatWeapon* WorldSnapshot::GetActiveWeapon(int entindex) const
+{
+    return m_Current.m_ActiveWeapon[entindex - 1].Get();
+}
+
+void WorldSnapshot::State::Reset()
+{
+    m_Valid.reset();
+    m_Alive.reset();
+    m_Team.fill(TFTeam::Unassigned);
+    m_Class.fill(TFClassType::Unknown);
+    m_Health.fill(0);
+    m_MaxHealth.fill(1);
+    m_Conditions.fill({});
+    m_UberCharge.fill(0);
+    m_Origin.fill(vec3_origin);
+    m_EyePosition.fill(vec3_origin);
+    m_WorldMins.fill(vec3_origin);
+    m_WorldMaxs.fill(vec3_origin);
+    m_EyeAngles.fill(vec3_angle);
+    m_ObserverMode.fill(OBS_MODE_NONE);
+    m_ObserverTarget.fill(0);
+    m_ActiveWeapon.fill(CHandle<C_BaseCombatWeapon>());
+}
+
+void WorldSnapshot::Build(int frame)
+{
+    VPROF_BUDGET(__FUNCTION__, VPROF_BUDGETGROUP_CE);
+
+    std::swap(m_Previous, m_Current);
+    m_Current.Reset();
+    m_PlayerCount = 0;
+    m_Frame = frame;
+
+    if (Interfaces::GetEngineClient()->IsInGame() && TryInitPlayerOffsets())
+        BuildPlayers();
+
+    BuildDeltas();
+}
+
+void WorldSnapshot::BuildPlayers()
+{
+    auto& cur = m_Current;
+
+    const auto playerResource = TFPlayerResource::GetPlayerResource();
+
+    for (Player* player : Player::Iterable())
+    {
+        IClientEntity* const entity = player->GetEntity();
+        if (!entity || !s_PlayerOffsets.m_TypeChecker.Match(entity))
+            continue;
+
+        C_BaseEntity* const baseEntity = entity->GetBaseEntity();
+        if (!baseEntity)
+            continue;
+
+        const auto i = player->entindex() - 1;
+        const auto base = static_cast<const std::byte*>(entity->GetDataTableBasePtr());
+
+        cur.m_Valid[i] = true;
+        m_PlayerCount++;
+
+        cur.m_Team[i] = ReadProp<TFTeam>(base, s_PlayerOffsets.m_Team);
+        cur.m_Class[i] = ReadProp<TFClassType>(base, s_PlayerOffsets.m_Class);
+        cur.m_Health[i] = ReadProp<int>(base, s_PlayerOffsets.m_Health);
+
+        if (const auto stats = playerResource ? playerResource->GetStats(i + 1) : nullptr)
+        {
+            cur.m_Alive[i] = stats->m_Alive;
+            cur.m_MaxHealth[i] = std::max(stats->m_MaxHealth, 1);
+        }
+
+        auto& conds = cur.m_Conditions[i];
+        conds[0] = ReadProp<uint32_t>(base, s_PlayerOffsets.m_CondBits[0]) |
+                   ReadProp<uint32_t>(base, s_PlayerOffsets.m_CondBits[1]);
+        for (size_t c = 1; c < conds.size(); c++)
+            conds[c] = ReadProp<uint32_t>(base, s_PlayerOffsets.m_CondBits[c + 1]);
+
+        cur.m_Origin[i] = baseEntity->GetAbsOrigin();
+        cur.m_EyePosition[i] = cur.m_Origin[i] + Player::GetEyeOffset(cur.m_Class[i]);
+        cur.m_EyeAngles[i] = baseEntity->EyeAngles();
+        baseEntity->CollisionProp()->WorldSpaceAABB(&cur.m_WorldMins[i], &cur.m_WorldMaxs[i]);
+
+        cur.m_ObserverMode[i] = ReadProp<ObserverMode>(base, s_PlayerOffsets.m_ObserverMode);
+        if (auto target = ReadProp<CHandle<C_BaseEntity>>(base, s_PlayerOffsets.m_ObserverTarget).Get())
+            cur.m_ObserverTarget[i] = target->entindex();
+
+        cur.m_ActiveWeapon[i] = ReadProp<CHandle<C_BaseCombatWeapon>>(base, s_PlayerOffsets.m_ActiveWeapon);
+
+        if (cur.m_Class[i] == TFClassType::Medic && cur.m_Alive[i])
+        {
+            if (auto charge = s_PlayerOffsets.m_ChargeLevel.TryGetValue(player->GetMedigun()))
+                cur.m_UberCharge[i] = *charge;
+        }
+    }
+}
+
+void WorldSnapshot::AddDelta(DeltaType type, int slot, int oldValue, int newValue)
+{
+    m_Deltas.push_back({type, uint8_t(slot + 1), oldValue, newValue});
+    m_ChangeMasks[slot] |= 1 << (int)type;
+}
+
+// Uber is reported in quarters so the vaccinator's individual charges show up as well
+static int GetUberQuarters(float charge) { return std::clamp(int(charge * 4), 0, 4); }
+
+static int GetEntIndex(const CBaseHandle& handle) { return handle.IsValid() ? handle.GetEntryIndex() : 0; }
+
+void WorldSnapshot::BuildDeltas()
+{
+    m_Deltas.clear();
+    m_ChangeMasks.fill(0);
+
+    const auto& prev = m_Previous;
+    const auto& cur = m_Current;
+
+    const auto changedSlots = prev.m_Valid | cur.m_Valid;
+    if (changedSlots.none())
+        return;
+
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        if (!changedSlots[i])
+            continue;
+
+        if (!cur.m_Valid[i])
+        {
+            AddDelta(DeltaType::PlayerRemoved, i, 0, 0);
+            continue;
+        }
+
+        // Diff against defaults for players we haven't seen before, so they show up as an
+        // initial set of changes
+        if (!prev.m_Valid[i])
+            AddDelta(DeltaType::PlayerAdded, i, 0, 0);
+
+        if (prev.m_Team[i] != cur.m_Team[i])
+            AddDelta(DeltaType::TeamChanged, i, (int)prev.m_Team[i], (int)cur.m_Team[i]);
+        if (prev.m_Class[i] != cur.m_Class[i])
+            AddDelta(DeltaType::ClassChanged, i, (int)prev.m_Class[i], (int)cur.m_Class[i]);
+        if (prev.m_Health[i] != cur.m_Health[i])
+            AddDelta(DeltaType::HealthChanged, i, prev.m_Health[i], cur.m_Health[i]);
+        if (prev.m_Alive[i] != cur.m_Alive[i])
+            AddDelta(cur.m_Alive[i] ? DeltaType::Spawned : DeltaType::Died, i, prev.m_Alive[i], cur.m_Alive[i]);
+        if (prev.m_ObserverTarget[i] != cur.m_ObserverTarget[i])
+            AddDelta(DeltaType::ObserverTargetChanged, i, prev.m_ObserverTarget[i], cur.m_ObserverTarget[i]);
+
+        if (prev.m_ActiveWeapon[i] != cur.m_ActiveWeapon[i])
+        {
+            AddDelta(DeltaType::ActiveWeaponChanged, i, GetEntIndex(prev.m_ActiveWeapon[i]),
+                     GetEntIndex(cur.m_ActiveWeapon[i]));
+        }
+
+        if (const auto oldQuarters = GetUberQuarters(prev.m_UberCharge[i]),
+            newQuarters = GetUberQuarters(cur.m_UberCharge[i]);
+            oldQuarters != newQuarters)
+        {
+            AddDelta(DeltaType::UberThresholdCrossed, i, oldQuarters, newQuarters);
+        }
+
+        for (size_t word = 0; word < cur.m_Conditions[i].size(); word++)
+        {
+            const auto oldBits = prev.m_Conditions[i][word];
+            const auto newBits = cur.m_Conditions[i][word];
+            if (oldBits == newBits)
+                continue;
+
+            for (uint32_t bit = 0; bit < 32; bit++)
+            {
+                const uint32_t mask = 1u << bit;
+                if ((oldBits ^ newBits) & mask)
+                {
+                    AddDelta((newBits & mask) ? DeltaType::ConditionAdded : DeltaType::ConditionRemoved, i, 0,
+                             int(word * 32 + bit));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <mathlib/vector.h>
+#include <shared/ehandle.h>
+#include <shareddefs.h>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum TFCond;
+enum class TFClassType;
+enum class TFTeam;
+
+class C_BaseCombatWeapon;
+class C_BaseEntity;
+
+// Read-only copy of the networked player state that most modules look at every tick.
+//
+// Built at most once per host frame, on first access, and laid out as one array per field so
+// modules that only care about (for example) team and alive state walk a few hundred contiguous
+// bytes instead of chasing Player -> entity -> type check for every getter. Arrays are indexed
+// by entindex - 1; slots that are not valid players hold default values.
+//
+// Each build is also diffed against the previous one, producing a list of typed deltas that is
+// valid until the next build. The module manager builds the snapshot before every OnTick(),
+// which runs once per host frame rather than once per client tick, so deltas cover one host
+// frame and modules that consume them from OnTick() see every change exactly once.
+//
+// While a ReplayScope is open, Get() stops building from the game and instead returns whatever
+// states are fed to Replay(), so snapshot-driven code can be run against a recording.
+class WorldSnapshot final
+{
+public:
+    static const WorldSnapshot& Get();
+
+    // False once the player props failed to resolve. Get() still works, but every snapshot is
+    // empty and there are never any deltas.
+    static bool IsAvailable();
+
+    using Slots = std::bitset<MAX_PLAYERS>;
+
+    enum class DeltaType : uint8_t
+    {
+        PlayerAdded,
+        PlayerRemoved,
+        TeamChanged,
+        ClassChanged,
+        HealthChanged,
+        Spawned,
+        Died,
+        ConditionAdded,   // m_NewValue is the TFCond
+        ConditionRemoved, // m_NewValue is the TFCond
+        ObserverTargetChanged,
+        ActiveWeaponChanged, // Values are entindices
+        UberThresholdCrossed, // Values are the charge in quarters, 0-4
+
+        COUNT,
+    };
+    static_assert((size_t)DeltaType::COUNT <= 32);
+
+    struct Delta
+    {
+        DeltaType m_Type;
+        uint8_t m_PlayerIndex; // entindex
+        int m_OldValue;
+        int m_NewValue;
+    };
+
+    int GetFrame() const { return m_Frame; }
+
+    const Slots& GetValidSlots() const { return m_Current.m_Valid; }
+    int GetPlayerCount() const { return m_PlayerCount; }
+
+    bool IsValid(int entindex) const { return IsValidIndex(entindex) && m_Current.m_Valid[entindex - 1]; }
+    bool IsAlive(int entindex) const { return IsValid(entindex) && m_Current.m_Alive[entindex - 1]; }
+
+    TFTeam GetTeam(int entindex) const { return m_Current.m_Team[entindex - 1]; }
+    TFClassType GetClass(int entindex) const { return m_Current.m_Class[entindex - 1]; }
+    int GetHealth(int entindex) const { return m_Current.m_Health[entindex - 1]; }
+    int GetMaxHealth(int entindex) const { return m_Current.m_MaxHealth[entindex - 1]; }
+    bool CheckCondition(int entindex, TFCond condition) const;
+    float GetUberCharge(int entindex) const { return m_Current.m_UberCharge[entindex - 1]; }
+
+    const Vector& GetAbsOrigin(int entindex) const { return m_Current.m_Origin[entindex - 1]; }
+    const Vector& GetWorldSpaceMins(int entindex) const { return m_Current.m_WorldMins[entindex - 1]; }
+    const Vector& GetWorldSpaceMaxs(int entindex) const { return m_Current.m_WorldMaxs[entindex - 1]; }
+    const Vector& GetEyePosition(int entindex) const { return m_Current.m_EyePosition[entindex - 1]; }
+    const QAngle& GetEyeAngles(int entindex) const { return m_Current.m_EyeAngles[entindex - 1]; }
+
+    ObserverMode GetObserverMode(int entindex) const { return m_Current.m_ObserverMode[entindex - 1]; }
+    int GetObserverTarget(int entindex) const { return m_Current.m_ObserverTarget[entindex - 1]; }
+    C_BaseCombatWeapon* GetActiveWeapon(int entindex) const;
+
+    // Everything read from the game for one build, one array per field
+    struct State
+    {
+        Slots m_Valid;
+        Slots m_Alive;
+        std::array<TFTeam, MAX_PLAYERS> m_Team;
+        std::array<TFClassType, MAX_PLAYERS> m_Class;
+        std::array<int, MAX_PLAYERS> m_Health;
+        std::array<int, MAX_PLAYERS> m_MaxHealth;
+        std::array<std::array<uint32_t, 4>, MAX_PLAYERS> m_Conditions;
+        std::array<float, MAX_PLAYERS> m_UberCharge; // 0 for non-medics
+
+        std::array<Vector, MAX_PLAYERS> m_Origin;
+        std::array<Vector, MAX_PLAYERS> m_EyePosition;
+        std::array<Vector, MAX_PLAYERS> m_WorldMins; // Collision bounds
+        std::array<Vector, MAX_PLAYERS> m_WorldMaxs;
+        std::array<QAngle, MAX_PLAYERS> m_EyeAngles;
+
+        std::array<ObserverMode, MAX_PLAYERS> m_ObserverMode;
+        std::array<int, MAX_PLAYERS> m_ObserverTarget; // entindex, 0 if none
+        std::array<CHandle<C_BaseCombatWeapon>, MAX_PLAYERS> m_ActiveWeapon;
+
+        void Reset();
+    };
+    const State& GetState() const { return m_Current; }
+
+    const std::vector<Delta>& GetDeltas() const { return m_Deltas; }
+    bool HasChanged(int entindex, DeltaType type) const
+    {
+        return IsValidIndex(entindex) && (m_ChangeMasks[entindex - 1] & (1 << (int)type));
+    }
+
+    // Swaps the live snapshot out for as long as it exists, and back in afterwards
+    class ReplayScope final
+    {
+    public:
+        ReplayScope();
+        ~ReplayScope();
+
+        ReplayScope(const ReplayScope& other) = delete;
+        ReplayScope& operator=(const ReplayScope& other) = delete;
+
+    private:
+        std::unique_ptr<WorldSnapshot> m_Live;
+    };
+
+    // Builds the next snapshot from a recorded state rather than the game. Deltas are against
+    // the previously replayed state.
+    static void Replay(int frame, const State& state);
+
+private:
+    WorldSnapshot();
+
+    static WorldSnapshot& GetInstance();
+    static bool s_Replaying;
+
+    static bool IsValidIndex(int entindex) { return entindex >= 1 && entindex <= MAX_PLAYERS; }
+
+    void Build(int frame);
+    void BuildPlayers();
+    void BuildDeltas();
+    void AddDelta(DeltaType type, int slot, int oldValue, int newValue);
+
+    int m_Frame = -1;
+    int m_PlayerCount = 0;
+
+    State m_Current;
+    State m_Previous;
+
+    std::vector<Delta> m_Deltas;
+    std::array<uint32_t, MAX_PLAYERS> m_ChangeMasks;
+};